@@ -30,12 +30,69 @@ void emergency_error_exit() {
     exit(1);
 }
 
+// prints what the gc has recorded about its cycles to stderr
+static void printGCStats(Runtime *rt) {
+    auto gc = rt->getGC();
+    gc->finishSweep(rt);
+
+    int64_t full_cycles = 0, minor_cycles = 0, mark_time = 0, sweep_time = 0, freed_count = 0, freed_bytes = 0;
+    for (auto &stats : gc->cycle_stats) {
+        if (stats.trigger == GCCycleStats::NURSERY) {
+            minor_cycles++;
+        }
+        else {
+            full_cycles++;
+        }
+        mark_time   += stats.mark_time;
+        sweep_time  += stats.sweep_time;
+        freed_count += stats.freed_count;
+        freed_bytes += stats.freed_bytes;
+    }
+    fprintf(stderr,
+            "GC: %ld full cycles, %ld minor cycles, %.3fms marking, %.3fms sweeping, %ld freed (%ld bytes)\n",
+            full_cycles,
+            minor_cycles,
+            mark_time / 1000.0,
+            sweep_time / 1000.0,
+            freed_count,
+            freed_bytes);
+    fprintf(stderr, "GC: max pause %.3fms\n", gc->max_pause / 1000.0);
+    for (size_t i = 0; i < gc->cycle_stats.size(); i++) {
+        auto &stats = gc->cycle_stats[i];
+        fprintf(stderr,
+                "GC cycle %zu: %s, %.3fms marking, %.3fms sweeping, %ld freed (%ld bytes)\n",
+                i + 1,
+                GCCycleStats::getTriggerName(stats.trigger),
+                stats.mark_time / 1000.0,
+                stats.sweep_time / 1000.0,
+                stats.freed_count,
+                stats.freed_bytes);
+    }
+    if (!gc->live_types.empty()) {
+        fprintf(stderr, "GC: live objects by type after the last full cycle:\n");
+        for (auto &[name, count] : gc->live_types) {
+            fprintf(stderr, "    %-20s %ld\n", name.c_str(), count);
+        }
+    }
+}
+
 // TODO: add --profiler flag
 
 int main(int argc, char *argv[]) {
     bool  print_execution_time = false;
     bool  disable_gc           = false;
     bool  print_result         = false;
+    bool  use_vm               = false;
+    bool  optimize             = true;
+    bool  generational_gc      = false;
+    bool  incremental_gc       = false;
+    bool  sync_sweep           = false;
+    bool  print_gc_stats       = false;
+    char *gc_slice_budget      = nullptr;
+    char *gc_threads           = nullptr;
+    char *gc_target            = getenv("COTTON_GC_TARGET");
+    char *max_heap             = nullptr;
+    char *heap_snapshot        = nullptr;
     char *file                 = nullptr;
 
     for (int i = 1; i < argc; i++) {
@@ -56,6 +113,81 @@ int main(int argc, char *argv[]) {
             continue;
         }
 
+        if (strcmp(arg, "--vm") == 0) {
+            use_vm = true;
+            continue;
+        }
+
+        if (strcmp(arg, "--no-opt") == 0) {
+            optimize = false;
+            continue;
+        }
+
+        if (strcmp(arg, "--gc-generational") == 0) {
+            generational_gc = true;
+            continue;
+        }
+
+        if (strcmp(arg, "--gc-incremental") == 0) {
+            incremental_gc = true;
+            continue;
+        }
+
+        if (strcmp(arg, "--gc-slice-budget") == 0) {
+            if (i + 1 == argc || atoll(argv[i + 1]) <= 0) {
+                fprintf(stderr, "Error: --gc-slice-budget expects a positive number\n");
+                exit(1);
+            }
+            gc_slice_budget = argv[++i];
+            continue;
+        }
+
+        if (strcmp(arg, "--gc-threads") == 0) {
+            if (i + 1 == argc || atoll(argv[i + 1]) <= 0) {
+                fprintf(stderr, "Error: --gc-threads expects a positive number\n");
+                exit(1);
+            }
+            gc_threads = argv[++i];
+            continue;
+        }
+
+        if (strcmp(arg, "--gc-target") == 0) {
+            if (i + 1 == argc || atoll(argv[i + 1]) <= 0) {
+                fprintf(stderr, "Error: --gc-target expects a positive number\n");
+                exit(1);
+            }
+            gc_target = argv[++i];
+            continue;
+        }
+
+        if (strcmp(arg, "--max-heap") == 0) {
+            if (i + 1 == argc || atoll(argv[i + 1]) <= 0) {
+                fprintf(stderr, "Error: --max-heap expects a positive number\n");
+                exit(1);
+            }
+            max_heap = argv[++i];
+            continue;
+        }
+
+        if (strcmp(arg, "--gc-sync-sweep") == 0) {
+            sync_sweep = true;
+            continue;
+        }
+
+        if (strcmp(arg, "--heap-snapshot-on-exit") == 0) {
+            if (i + 1 == argc) {
+                fprintf(stderr, "Error: --heap-snapshot-on-exit expects a file name\n");
+                exit(1);
+            }
+            heap_snapshot = argv[++i];
+            continue;
+        }
+
+        if (strcmp(arg, "--gc-stats") == 0) {
+            print_gc_stats = true;
+            continue;
+        }
+
         if (file != nullptr) {
             fprintf(stderr, "Error: unexpected argument: %s\n", arg);
             exit(1);
@@ -63,6 +195,11 @@ int main(int argc, char *argv[]) {
 
         file = arg;
     }
+
+    if (gc_target != nullptr && atoll(gc_target) <= 0) {
+        fprintf(stderr, "Error: COTTON_GC_TARGET expects a positive number\n");
+        exit(1);
+    }
 #ifndef DEFAULT_SOURCE_FILENAME
     if (file == nullptr) {
         fprintf(stderr, "Expected a source file\n");
@@ -86,14 +223,59 @@ int main(int argc, char *argv[]) {
         token.nameid = nmgr.getId(token.data);
     }
     auto program = pr.parse(tokens);
+    if (optimize) {
+        program = Optimizer(&nmgr).optimize(program);
+    }
+    Resolver().resolve(program);
 
-    GCDefaultStrategy gcst;
-    Runtime           rt(&gcst, &em, &nmgr);
+    GCDefaultStrategy      default_gcst;
+    GCGenerationalStrategy generational_gcst;
+    GCIncrementalStrategy  incremental_gcst;
+    GCPacingStrategy       pacing_gcst(gc_target != nullptr ? atoll(gc_target) : 100);
+    GCStrategy            *gcst = &default_gcst;
+    if (gc_target != nullptr) {
+        gcst = &pacing_gcst;
+    }
+    if (generational_gc) {
+        gcst = &generational_gcst;
+    }
+    if (incremental_gc) {
+        gcst = &incremental_gcst;
+    }
+    Runtime rt(gcst, &em, &nmgr);
+
+    if (gc_slice_budget != nullptr) {
+        rt.getGC()->slice_budget = atoll(gc_slice_budget);
+    }
+
+    if (gc_threads != nullptr) {
+        rt.getGC()->mark_threads = atoll(gc_threads);
+    }
+
+    if (sync_sweep) {
+        rt.getGC()->background_sweep = false;
+    }
+
+    if (max_heap != nullptr) {
+        rt.getGC()->max_heap_bytes = atoll(max_heap);
+    }
+
+    if (print_gc_stats) {
+        rt.getGC()->take_census = true;
+    }
 
     if (disable_gc) {
         rt.getGC()->disable();
     }
 
+    if (use_vm) {
+        rt.enableVM();
+    }
+
+    if (!optimize) {
+        rt.disableOptimizer();
+    }
+
     auto begin_time = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
     auto res        = rt.execute(program, print_result);
     auto end_time   = duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
@@ -111,8 +293,25 @@ int main(int argc, char *argv[]) {
         printf("TIME: %.3fsec\n", (end_time - begin_time) / 1000.0);
     }
 
+    if (print_gc_stats) {
+        printGCStats(&rt);
+    }
+
+    if (heap_snapshot != nullptr) {
+        // the scopes of the program are gone by now, its result is the only thing it leaves behind
+        GCRootGuard guard(rt.getGC(), rt.isValidObject(res) ? res : nullptr);
+        if (!HeapSnapshot(&rt).write(heap_snapshot, &rt)) {
+            fprintf(stderr, "Error: failed to write the heap snapshot to %s\n", heap_snapshot);
+            exit(1);
+        }
+    }
+
 #ifdef COTTON_ENABLE_PROFILER
     Profiler::printResult();
+    printf("Inline caches: %ld hits, %ld misses, %ld megamorphic misses\n",
+           rt.ic_stats.hits,
+           rt.ic_stats.misses,
+           rt.ic_stats.megamorphic);
 #endif
 
     delete program;
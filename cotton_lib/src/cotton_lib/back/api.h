@@ -21,10 +21,16 @@
 
 #pragma once
 #include "../util.h"
+#include "argstack.h"
+#include "bytecode.h"
 #include "gc.h"
+#include "heapsnapshot.h"
+#include "inline_cache.h"
 #include "instance.h"
 #include "nameid.h"
 #include "object.h"
 #include "runtime.h"
 #include "scope.h"
 #include "type.h"
+#include "value.h"
+#include "vm.h"
@@ -0,0 +1,59 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "argstack.h"
+#include "../profiler.h"
+#include <algorithm>
+
+namespace Cotton {
+ArgStack::ArgStack() {
+    ProfilerCAPTURE();
+    this->chunks.push_back({std::vector<Object *>(CHUNK_SIZE, nullptr), 0});
+    this->current = 0;
+}
+
+Object **ArgStack::push(size_t count) {
+    ProfilerCAPTURE();
+    auto *chunk = &this->chunks[this->current];
+    if (chunk->used + count > chunk->slots.size()) {
+        this->current++;
+        if (this->current == this->chunks.size()) {
+            this->chunks.push_back({std::vector<Object *>(std::max(CHUNK_SIZE, count), nullptr), 0});
+        }
+        else if (this->chunks[this->current].slots.size() < count) {
+            this->chunks[this->current].slots.assign(count, nullptr);
+        }
+        chunk = &this->chunks[this->current];
+    }
+    auto res     = chunk->slots.data() + chunk->used;
+    chunk->used += count;
+    std::fill(res, res + count, nullptr);
+    return res;
+}
+
+void ArgStack::pop(size_t count) {
+    ProfilerCAPTURE();
+    this->chunks[this->current].used -= count;
+    while (this->current > 0 && this->chunks[this->current].used == 0) {
+        this->current--;
+    }
+}
+}    // namespace Cotton
@@ -0,0 +1,128 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Cotton {
+class Object;
+class GC;
+
+/**
+ * @brief Read-only view of the arguments of a call. Does not own the arguments, they have to stay valid for as long
+ * as the span is used.
+ */
+class ArgSpan {
+private:
+    Object *const *ptr;
+    size_t         count;
+
+public:
+    ArgSpan()
+        : ptr(nullptr)
+        , count(0) {}
+
+    ArgSpan(Object *const *ptr, size_t count)
+        : ptr(ptr)
+        , count(count) {}
+
+    ArgSpan(const std::vector<Object *> &list)
+        : ptr(list.data())
+        , count(list.size()) {}
+
+    /// @brief Lets local arrays be passed as arguments, e.g. `Object *args[] = {a, b};`.
+    template<size_t N>
+    ArgSpan(Object *const (&list)[N])
+        : ptr(list)
+        , count(N) {}
+
+    size_t size() const {
+        return this->count;
+    }
+
+    bool empty() const {
+        return this->count == 0;
+    }
+
+    Object *const &operator[](size_t index) const {
+        return this->ptr[index];
+    }
+
+    Object *const *begin() const {
+        return this->ptr;
+    }
+
+    Object *const *end() const {
+        return this->ptr + this->count;
+    }
+
+    Object *const &front() const {
+        return this->ptr[0];
+    }
+
+    Object *const &back() const {
+        return this->ptr[this->count - 1];
+    }
+};
+
+/**
+ * @brief Stack of call arguments owned by the runtime. Callers evaluate the arguments right into the pushed slots and
+ * pass them on as an ArgSpan. Every object on the stack is reachable for the gc.
+ *
+ * The stack is made of chunks that never move, so slots stay valid while nested calls push more of them.
+ */
+class ArgStack {
+    friend class GC;
+
+private:
+    static constexpr size_t CHUNK_SIZE = 4096;
+
+    class Chunk {
+    public:
+        std::vector<Object *> slots;    // never resized while the chunk is in use
+        size_t                used;
+    };
+
+    std::vector<Chunk> chunks;
+    size_t             current;
+
+public:
+    /// @brief Construct a new empty ArgStack object
+    ArgStack();
+
+    /**
+     * @brief Pushes `count` contiguous slots, all set to nullptr.
+     *
+     * @param count Amount of slots.
+     * @return Pointer to the first slot. Stays valid until the slots are popped.
+     */
+    Object **push(size_t count);
+
+    /**
+     * @brief Pops the topmost `count` slots. Must match the last push that hasn't been popped yet.
+     *
+     * @param count Amount of slots.
+     */
+    void pop(size_t count);
+};
+}    // namespace Cotton
@@ -0,0 +1,584 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bytecode.h"
+#include "../profiler.h"
+#include "../front/resolver.h"
+#include "runtime.h"
+
+namespace Cotton {
+Instruction::Instruction(Opcode opcode, TextArea *area) {
+    ProfilerCAPTURE();
+    this->opcode                   = opcode;
+    this->execution_result_matters = true;
+    this->op                       = OperatorNode::TOTAL_OPERATORS;
+    this->arg                      = 0;
+    this->nameid                   = -1;
+    this->area                     = area;
+    this->node                     = nullptr;
+    this->expr                     = nullptr;
+    this->atom                     = nullptr;
+    this->layout                   = nullptr;
+    this->quick                    = nullptr;
+    this->deopts                   = 0;
+}
+
+bool isDirectPassExpr(ExprNode *expr) {
+    ProfilerCAPTURE();
+    while (expr != nullptr && expr->id == ExprNode::PARENTHESES_EXPRESSION) {
+        expr = expr->par_expr->expr;
+    }
+    return expr != nullptr && expr->id == ExprNode::OPERATOR && expr->op->id == OperatorNode::AT;
+}
+
+static bool isIdentifier(ExprNode *expr) {
+    ProfilerCAPTURE();
+    return expr != nullptr && expr->id == ExprNode::ATOM && expr->atom->id == AtomNode::IDENTIFIER;
+}
+
+static bool isAtom(ExprNode *expr) {
+    ProfilerCAPTURE();
+    while (expr != nullptr && expr->id == ExprNode::PARENTHESES_EXPRESSION) {
+        expr = expr->par_expr->expr;
+    }
+    return expr == nullptr || expr->id == ExprNode::ATOM;
+}
+
+// whether every operand of the operator, including every argument of a call, is an atom
+static bool hasAtomOperands(OperatorNode *node) {
+    ProfilerCAPTURE();
+    auto first = node->first;
+    if (node->id == OperatorNode::CALL && first != nullptr && first->id == ExprNode::OPERATOR
+        && first->op->id == OperatorNode::DOT)
+    {
+        if (!isAtom(first->op->second)) {
+            return false;
+        }
+        first = first->op->first;
+    }
+    if (!isAtom(first)) {
+        return false;
+    }
+    if (node->id != OperatorNode::CALL && node->id != OperatorNode::INDEX) {
+        return isAtom(node->second);
+    }
+    auto rest = node->second;
+    while (rest != nullptr && rest->id == ExprNode::OPERATOR && rest->op->id == OperatorNode::COMMA) {
+        if (!isAtom(rest->op->first)) {
+            return false;
+        }
+        rest = rest->op->second;
+    }
+    return isAtom(rest);
+}
+
+Compiler::Compiler(Runtime *rt) {
+    ProfilerCAPTURE();
+    this->rt              = rt;
+    this->chunk           = nullptr;
+    this->scope_depth     = 0;
+    this->context_depth   = 0;
+    this->operand_context = nullptr;
+}
+
+Chunk *Compiler::compile(StmtNode *node) {
+    ProfilerCAPTURE();
+    this->chunk           = new Chunk();
+    this->scope_depth     = 0;
+    this->context_depth   = 0;
+    this->operand_context = nullptr;
+    this->loops.clear();
+
+    this->compileStmt(node, true);
+    this->emit(Instruction::HALT, &node->text_area);
+
+    auto res    = this->chunk;
+    this->chunk = nullptr;
+    return res;
+}
+
+int64_t Compiler::emit(Instruction::Opcode opcode, TextArea *area, int32_t arg) {
+    ProfilerCAPTURE();
+    this->chunk->code.push_back(Instruction(opcode, area));
+    this->chunk->code.back().arg = arg;
+    return this->chunk->code.size() - 1;
+}
+
+int64_t Compiler::addConstant(Value value) {
+    ProfilerCAPTURE();
+    for (int64_t i = 0; i < this->chunk->constants.size(); i++) {
+        auto &constant = this->chunk->constants[i];
+        if (constant.kind == value.kind && (value.kind == Value::NOTHING || constant.object == value.object)) {
+            return i;
+        }
+    }
+    this->chunk->constants.push_back(value);
+    return this->chunk->constants.size() - 1;
+}
+
+void Compiler::patch(int64_t pos, int64_t target) {
+    ProfilerCAPTURE();
+    this->chunk->code[pos].arg = target;
+}
+
+int64_t Compiler::here() {
+    ProfilerCAPTURE();
+    return this->chunk->code.size();
+}
+
+int64_t Compiler::compileArgs(ExprNode *expr) {
+    ProfilerCAPTURE();
+    int64_t argc = 0;
+    while (expr != nullptr) {
+        ExprNode *arg = expr;
+        if (expr->id == ExprNode::OPERATOR && expr->op->id == OperatorNode::COMMA) {
+            arg  = expr->op->first;
+            expr = expr->op->second;
+        }
+        else {
+            expr = nullptr;
+        }
+
+        this->compileExpr(arg, true);
+        if (!isDirectPassExpr(arg)) {
+            auto i                    = this->emit(Instruction::COPY, &arg->text_area);
+            this->chunk->code[i].node = this->operand_context;
+        }
+        argc++;
+    }
+    return argc;
+}
+
+void Compiler::compileStmt(StmtNode *node, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    switch (node->id) {
+    case StmtNode::WHILE : this->compileWhile(node->while_stmt); break;
+    case StmtNode::FOR : this->compileFor(node->for_stmt); break;
+    case StmtNode::IF : this->compileIf(node->if_stmt, execution_result_matters); break;
+    case StmtNode::CONTINUE :
+    case StmtNode::BREAK : this->compileLoopExit(node); break;
+    case StmtNode::RETURN : this->compileReturn(node->return_stmt); break;
+    case StmtNode::BLOCK : this->compileBlock(node->block_stmt, execution_result_matters); break;
+    case StmtNode::EXPR : this->compileExpr(node->expr, execution_result_matters); break;
+    default : this->rt->signalError("Unknown node", node->text_area);
+    }
+}
+
+void Compiler::compileExpr(ExprNode *node, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    switch (node->id) {
+    case ExprNode::FUNCTION_DEFINITION :
+    case ExprNode::TYPE_DEFINITION : {
+        auto i                                         = this->emit(Instruction::EVAL, &node->text_area);
+        this->chunk->code[i].expr                      = node;
+        this->chunk->code[i].execution_result_matters = execution_result_matters;
+        break;
+    }
+    case ExprNode::OPERATOR : this->compileOperator(node->op, node, execution_result_matters); break;
+    case ExprNode::ATOM : this->compileAtom(node->atom, node); break;
+    case ExprNode::PARENTHESES_EXPRESSION : this->compileExpr(node->par_expr->expr, execution_result_matters); break;
+    default : this->rt->signalError("Unknown node", node->text_area);
+    }
+}
+
+void Compiler::compileAtom(AtomNode *node, ExprNode *expr) {
+    ProfilerCAPTURE();
+    if (node->id == AtomNode::IDENTIFIER) {
+        auto i                    = this->emit(Instruction::LOAD_VAR, &node->text_area);
+        this->chunk->code[i].atom = node;
+        this->chunk->code[i].node = this->operand_context;
+        return;
+    }
+    // literals are readonly and cached on the node, so they can be created right away
+    this->emit(Instruction::LOAD_CONST, &node->text_area, this->addConstant(this->rt->execute(node, true)));
+}
+
+void Compiler::compileOperator(OperatorNode *node, ExprNode *expr, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    // every operator gets an error context, just like in the tree-walking executor. If the operands are atoms, the
+    // instructions that may fail push it themselves instead, which keeps ENTER_CONTEXT out of the simplest operators
+    bool frame = !hasAtomOperands(node);
+    if (frame) {
+        this->enterContext(&node->text_area);
+    }
+    this->operand_context = frame ? nullptr : node;
+    this->compileOperatorCode(node, expr, execution_result_matters);
+    this->operand_context = nullptr;
+    if (frame) {
+        this->leaveContext(&node->text_area);
+    }
+}
+
+void Compiler::compileOperatorCode(OperatorNode *node, ExprNode *expr, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    int64_t i;
+
+    switch (node->id) {
+    case OperatorNode::ASSIGN : {
+        if (isIdentifier(node->first)) {
+            i                         = this->emit(Instruction::DECLARE_VAR, &node->text_area);
+            this->chunk->code[i].atom = node->first->atom;
+        }
+        this->compileExpr(node->first, true);
+        this->compileExpr(node->second, true);
+        this->emit(Instruction::ASSIGN, &node->text_area, isDirectPassExpr(node->second));
+        return;
+    }
+    case OperatorNode::COMMA : {
+        this->compileExpr(node->first, execution_result_matters);
+        auto rest = node->second;
+        while (rest != nullptr) {
+            if (rest->id == ExprNode::OPERATOR && rest->op->id == OperatorNode::COMMA) {
+                this->compileExpr(rest->op->first, false);
+                rest = rest->op->second;
+            }
+            else {
+                this->compileExpr(rest, false);
+                rest = nullptr;
+            }
+            this->emit(Instruction::POP, &node->text_area);
+        }
+        return;
+    }
+    case OperatorNode::CALL :
+    case OperatorNode::INDEX : {
+        if (node->id == OperatorNode::CALL && node->first->id == ExprNode::OPERATOR
+            && node->first->op->id == OperatorNode::DOT)
+        {
+            auto dot = node->first->op;
+            if (!isIdentifier(dot->second)) {
+                break;    // the tree-walking executor reports the error
+            }
+            this->compileExpr(dot->first, true);
+            i                           = this->emit(Instruction::SELECT_METHOD, &node->text_area);
+            this->chunk->code[i].nameid = dot->second->atom->ident->nameid;
+            this->chunk->code[i].node   = dot;
+
+            auto argc = this->compileArgs(node->second);
+            i         = this->emit(Instruction::CALL_METHOD, &node->text_area, argc);
+        }
+        else {
+            this->compileExpr(node->first, true);
+            auto argc = this->compileArgs(node->second);
+            i = this->emit(node->id == OperatorNode::CALL ? Instruction::CALL : Instruction::INDEX, &node->text_area, argc);
+        }
+        this->chunk->code[i].node                     = node;
+        this->chunk->code[i].execution_result_matters = execution_result_matters;
+        return;
+    }
+    case OperatorNode::DOT : {
+        if (!isIdentifier(node->second)) {
+            break;
+        }
+        this->compileExpr(node->first, true);
+        i                           = this->emit(Instruction::SELECT, &node->text_area);
+        this->chunk->code[i].nameid = node->second->atom->ident->nameid;
+        this->chunk->code[i].node   = node;
+        return;
+    }
+    case OperatorNode::AT : {
+        // the direct pass itself is resolved at compile time by isDirectPassExpr
+        this->compileExpr(node->first, true);
+        return;
+    }
+    case OperatorNode::PLUS_ASSIGN :
+    case OperatorNode::MINUS_ASSIGN :
+    case OperatorNode::MULT_ASSIGN :
+    case OperatorNode::DIV_ASSIGN :
+    case OperatorNode::REM_ASSIGN : {
+        this->compileExpr(node->first, true);
+        this->compileExpr(node->second, true);
+        i = this->emit(Instruction::COMPOUND_ASSIGN, &node->text_area);
+        switch (node->id) {
+        case OperatorNode::PLUS_ASSIGN : this->chunk->code[i].op = OperatorNode::PLUS; break;
+        case OperatorNode::MINUS_ASSIGN : this->chunk->code[i].op = OperatorNode::MINUS; break;
+        case OperatorNode::MULT_ASSIGN : this->chunk->code[i].op = OperatorNode::MULT; break;
+        case OperatorNode::DIV_ASSIGN : this->chunk->code[i].op = OperatorNode::DIV; break;
+        default : this->chunk->code[i].op = OperatorNode::REM; break;
+        }
+        this->chunk->code[i].node = node;
+        return;
+    }
+    case OperatorNode::POST_PLUS_PLUS :
+    case OperatorNode::POST_MINUS_MINUS :
+    case OperatorNode::PRE_PLUS_PLUS :
+    case OperatorNode::PRE_MINUS_MINUS :
+    case OperatorNode::PRE_PLUS :
+    case OperatorNode::PRE_MINUS :
+    case OperatorNode::NOT :
+    case OperatorNode::INVERSE : {
+        this->compileExpr(node->first, true);
+        i                                             = this->emit(Instruction::UNARY_OP, &node->text_area);
+        this->chunk->code[i].op                       = node->id;
+        this->chunk->code[i].node                     = node;
+        this->chunk->code[i].execution_result_matters = execution_result_matters;
+        return;
+    }
+    default : {
+        this->compileExpr(node->first, true);
+        this->compileExpr(node->second, true);
+        i                                             = this->emit(Instruction::BINARY_OP, &node->text_area);
+        this->chunk->code[i].op                       = node->id;
+        this->chunk->code[i].node                     = node;
+        this->chunk->code[i].execution_result_matters = execution_result_matters;
+        return;
+    }
+    }
+
+    // malformed selectors are left to the tree-walking executor, so that errors stay the same
+    i                                             = this->emit(Instruction::EVAL, &node->text_area);
+    this->chunk->code[i].expr                     = expr;
+    this->chunk->code[i].execution_result_matters = execution_result_matters;
+}
+
+void Compiler::compileWhile(WhileStmtNode *node) {
+    ProfilerCAPTURE();
+    auto start = this->here();
+    auto depth = this->scope_depth;
+    auto frame = this->enterScope(node->layout, &node->text_area);
+    this->loops.push_back({depth, this->scope_depth, this->context_depth, {}, {}});
+
+    int64_t exit_jump = -1;
+    if (node->cond != nullptr) {
+        this->compileExpr(node->cond, true);
+        exit_jump = this->emit(Instruction::JUMP_IF_FALSE, &node->cond->text_area);
+    }
+    if (node->body != nullptr) {
+        this->compileStmt(node->body, false);
+        this->emit(Instruction::POP, &node->text_area);
+    }
+
+    auto continue_target = this->here();
+    this->unwindScopes(depth, &node->text_area);
+    this->emit(Instruction::LOOP, &node->text_area, start);
+    if (exit_jump != -1) {
+        this->patch(exit_jump, this->here());
+        this->unwindScopes(depth, &node->text_area);
+    }
+    auto break_target = this->here();
+    this->leaveScope(frame, nullptr);
+
+    for (auto pos : this->loops.back().breaks) {
+        this->patch(pos, break_target);
+    }
+    for (auto pos : this->loops.back().continues) {
+        this->patch(pos, continue_target);
+    }
+    this->loops.pop_back();
+
+    this->emit(Instruction::LOAD_CONST, &node->text_area, this->addConstant(Value::makeNothing()));
+}
+
+void Compiler::compileFor(ForStmtNode *node) {
+    ProfilerCAPTURE();
+    auto outer_frame = this->enterScope(node->outer_layout, &node->text_area);
+    if (node->init != nullptr) {
+        this->compileExpr(node->init, false);
+        this->emit(Instruction::POP, &node->text_area);
+    }
+    auto first_jump = this->emit(Instruction::JUMP, &node->text_area);
+
+    auto step = this->here();
+    if (node->step != nullptr) {
+        this->compileExpr(node->step, false);
+        this->emit(Instruction::POP, &node->text_area);
+    }
+    this->patch(first_jump, this->here());
+
+    auto depth = this->scope_depth;
+    auto frame = this->enterScope(node->layout, &node->text_area);
+    this->loops.push_back({depth, this->scope_depth, this->context_depth, {}, {}});
+
+    int64_t exit_jump = -1;
+    if (node->cond != nullptr) {
+        this->compileExpr(node->cond, true);
+        exit_jump = this->emit(Instruction::JUMP_IF_FALSE, &node->cond->text_area);
+    }
+    if (node->body != nullptr) {
+        this->compileStmt(node->body, false);
+        this->emit(Instruction::POP, &node->text_area);
+    }
+
+    auto continue_target = this->here();
+    this->unwindScopes(depth, &node->text_area);
+    this->emit(Instruction::LOOP, &node->text_area, step);
+    if (exit_jump != -1) {
+        this->patch(exit_jump, this->here());
+        this->unwindScopes(depth, &node->text_area);
+    }
+    auto break_target = this->here();
+    this->leaveScope(frame, nullptr);
+
+    for (auto pos : this->loops.back().breaks) {
+        this->patch(pos, break_target);
+    }
+    for (auto pos : this->loops.back().continues) {
+        this->patch(pos, continue_target);
+    }
+    this->loops.pop_back();
+
+    this->leaveScope(outer_frame, &node->text_area);
+    this->emit(Instruction::LOAD_CONST, &node->text_area, this->addConstant(Value::makeNothing()));
+}
+
+void Compiler::compileIf(IfStmtNode *node, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    this->compileExpr(node->cond, true);
+    auto else_jump = this->emit(Instruction::JUMP_IF_FALSE, &node->cond->text_area);
+    this->compileStmt(node->body, execution_result_matters);
+    auto end_jump = this->emit(Instruction::JUMP, &node->text_area);
+    this->patch(else_jump, this->here());
+    if (node->else_body != nullptr) {
+        this->compileStmt(node->else_body, execution_result_matters);
+    }
+    else {
+        this->emit(Instruction::LOAD_CONST, &node->text_area, this->addConstant(Value::makeNothing()));
+    }
+    this->patch(end_jump, this->here());
+}
+
+void Compiler::compileBlock(BlockStmtNode *node, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    this->enterContext(&node->text_area);
+    bool frame = !node->is_unscoped && this->enterScope(node->layout, &node->text_area);
+
+    std::vector<StmtNode *> list;
+    for (auto stmt : node->list) {
+        if (stmt != nullptr) {
+            list.push_back(stmt);
+        }
+    }
+
+    if (list.empty()) {
+        this->emit(Instruction::LOAD_CONST, &node->text_area, this->addConstant(Value::makeNothing()));
+    }
+    for (int64_t i = 0; i < list.size(); i++) {
+        bool last = i + 1 == list.size();
+        this->compileStmt(list[i], last && execution_result_matters);
+        if (!last) {
+            this->emit(Instruction::POP, &node->text_area);
+        }
+    }
+
+    this->leaveScope(frame, &node->text_area);
+    this->leaveContext(&node->text_area);
+}
+
+bool Compiler::enterScope(ScopeLayout *layout, TextArea *area) {
+    ProfilerCAPTURE();
+    if (!ScopeLayout::needsFrame(layout)) {
+        return false;
+    }
+    auto i                      = this->emit(Instruction::ENTER_SCOPE, area);
+    this->chunk->code[i].layout = layout;
+    this->scope_depth++;
+    return true;
+}
+
+void Compiler::leaveScope(bool frame, TextArea *area) {
+    ProfilerCAPTURE();
+    if (!frame) {
+        return;
+    }
+    // area is nullptr when the frame has already been left by every path reaching this point
+    if (area != nullptr) {
+        this->emit(Instruction::LEAVE_SCOPE, area);
+    }
+    this->scope_depth--;
+}
+
+void Compiler::unwindScopes(int64_t depth, TextArea *area) {
+    ProfilerCAPTURE();
+    for (int64_t i = depth; i < this->scope_depth; i++) {
+        this->emit(Instruction::LEAVE_SCOPE, area);
+    }
+}
+
+void Compiler::enterContext(TextArea *area) {
+    ProfilerCAPTURE();
+    this->emit(Instruction::ENTER_CONTEXT, area);
+    this->context_depth++;
+}
+
+void Compiler::leaveContext(TextArea *area) {
+    ProfilerCAPTURE();
+    // area is nullptr when the context has already been left by every path reaching this point
+    if (area != nullptr) {
+        this->emit(Instruction::LEAVE_CONTEXT, area);
+    }
+    this->context_depth--;
+}
+
+void Compiler::unwindContexts(int64_t depth, TextArea *area) {
+    ProfilerCAPTURE();
+    for (int64_t i = depth; i < this->context_depth; i++) {
+        this->emit(Instruction::LEAVE_CONTEXT, area);
+    }
+}
+
+void Compiler::compileReturn(ReturnStmtNode *node) {
+    ProfilerCAPTURE();
+    if (node->value == nullptr) {
+        this->emit(Instruction::LOAD_CONST, &node->text_area, this->addConstant(Value::makeNothing()));
+        this->emit(Instruction::RETURN, &node->text_area, true);
+        return;
+    }
+    this->enterContext(&node->text_area);
+    this->compileExpr(node->value, true);
+    if (node->is_tail_call) {
+        // the context of the call, if it has one, is left after the call
+        auto pos = this->chunk->code.size() - 1;
+        while (this->chunk->code[pos].opcode == Instruction::LEAVE_CONTEXT) {
+            pos--;
+        }
+        auto &call = this->chunk->code[pos];
+        if (call.opcode == Instruction::CALL && call.node == node->value->op) {
+            call.opcode = Instruction::TAIL_CALL;
+        }
+        else if (call.opcode == Instruction::CALL_METHOD && call.node == node->value->op) {
+            call.opcode = Instruction::TAIL_CALL_METHOD;
+        }
+    }
+    this->emit(Instruction::RETURN, &node->text_area, isDirectPassExpr(node->value));
+    this->leaveContext(nullptr);    // RETURN leaves every context of the chunk
+}
+
+void Compiler::compileLoopExit(StmtNode *node) {
+    ProfilerCAPTURE();
+    if (this->loops.empty()) {
+        // outside of a loop, break and continue end the execution just like return does
+        this->emit(Instruction::LOAD_CONST, &node->text_area, this->addConstant(Value::makeNothing()));
+        this->emit(Instruction::RETURN, &node->text_area, true);
+        return;
+    }
+
+    auto &loop = this->loops.back();
+    this->unwindContexts(loop.context_depth, &node->text_area);
+    this->unwindScopes(node->id == StmtNode::BREAK ? loop.break_depth : loop.continue_depth, &node->text_area);
+    auto pos = this->emit(Instruction::JUMP, &node->text_area);
+    if (node->id == StmtNode::BREAK) {
+        loop.breaks.push_back(pos);
+    }
+    else {
+        loop.continues.push_back(pos);
+    }
+}
+}    // namespace Cotton
@@ -0,0 +1,161 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "../front/parser.h"
+#include "../util.h"
+#include "nameid.h"
+#include "value.h"
+#include <cstdint>
+#include <vector>
+
+namespace Cotton {
+class Object;
+class Runtime;
+class ScopeLayout;
+
+/// @brief A single instruction of the Cotton bytecode. The VM works on a stack of objects.
+class Instruction {
+public:
+    enum Opcode : uint8_t {
+        LOAD_CONST,         // pushes constants[arg]
+        LOAD_VAR,           // pushes the variable `atom`
+        DECLARE_VAR,        // adds a Nothing variable `atom` to the current scope if it is not visible
+        POP,                // pops the top
+        COPY,               // replaces the top with a copy of it
+        UNARY_OP,           // runs the unary operator `op` on the top
+        BINARY_OP,          // runs the binary operator `op` on the two topmost
+        BINARY_OP_QUICK,    // runs `quick` on the two topmost, falls back to BINARY_OP if its guard fails
+        ASSIGN,             // assigns the top to the object below it, `arg` = 1 means direct pass
+        COMPOUND_ASSIGN,    // runs `op` on the two topmost and assigns the result to the lower one
+        SELECT,             // replaces the top with its field or method `nameid`
+        SELECT_METHOD,      // pushes the field or method `nameid` of the top, keeping the caller
+        CALL,               // calls the object below `arg` arguments
+        CALL_METHOD,        // calls the selected object, passing the caller and `arg` arguments
+        TAIL_CALL,          // CALL that ends the chunk, leaving the call to the function call running the chunk
+        TAIL_CALL_METHOD,   // CALL_METHOD that ends the chunk the same way as TAIL_CALL
+        INDEX,              // indexes the object below `arg` arguments
+        EVAL,               // pushes the result of running `expr` on the tree-walking executor
+        ENTER_SCOPE,        // creates a new scope frame with slots described by `layout`
+        LEAVE_SCOPE,        // pops the topmost scope frame
+        ENTER_CONTEXT,      // pushes an error context with the area of the instruction
+        LEAVE_CONTEXT,      // pops the error context pushed by ENTER_CONTEXT
+        JUMP,               // jumps to `arg`
+        LOOP,               // jumps back to `arg`, pinging the gc
+        JUMP_IF_FALSE,      // pops the top and jumps to `arg` if it is false
+        RETURN,             // returns the top, `arg` = 1 means direct pass
+        HALT,               // returns the top
+        TOTAL_OPCODES
+    };
+
+    Opcode                   opcode;
+    bool                     execution_result_matters;
+    OperatorNode::OperatorId op;
+    int32_t                  arg;
+    NameId                   nameid;
+    TextArea                *area;    // area of the node the instruction came from, used as the error context
+    OperatorNode            *node;    // operator whose operands make up the sub areas of the error context. For LOAD_VAR
+                                      // and COPY, the operator whose error context they have to push, if any
+    ExprNode                *expr;
+    AtomNode                *atom;
+    ScopeLayout             *layout;
+    QuickBinaryOperator      quick;     // specialization picked from the operand kinds seen by BINARY_OP
+    uint8_t                  deopts;    // how many times the specialization had to be dropped
+
+    Instruction(Opcode opcode, TextArea *area);
+};
+
+/// @brief A compiled piece of code. Each function body and each program gets its own chunk.
+class Chunk {
+public:
+    std::vector<Instruction> code;
+    std::vector<Value>       constants;
+};
+
+/// @brief Compiles StmtNode trees into chunks of bytecode.
+class Compiler {
+private:
+    class LoopInfo {
+    public:
+        int64_t              break_depth;       // scope depth that break returns to
+        int64_t              continue_depth;    // scope depth that continue returns to
+        int64_t              context_depth;     // error context depth that break and continue return to
+        std::vector<int64_t> breaks;
+        std::vector<int64_t> continues;
+    };
+
+    Runtime              *rt;
+    Chunk                *chunk;
+    int64_t               scope_depth;
+    int64_t               context_depth;
+    OperatorNode         *operand_context;    // operator whose error context is left to its operands, see compileOperator
+    std::vector<LoopInfo> loops;
+
+    int64_t emit(Instruction::Opcode opcode, TextArea *area, int32_t arg = 0);
+    int64_t addConstant(Value value);
+    void    patch(int64_t pos, int64_t target);
+    int64_t here();
+
+    int64_t compileArgs(ExprNode *expr);
+    void    compileStmt(StmtNode *node, bool execution_result_matters);
+    void    compileExpr(ExprNode *node, bool execution_result_matters);
+    void    compileOperator(OperatorNode *node, ExprNode *expr, bool execution_result_matters);
+    void    compileOperatorCode(OperatorNode *node, ExprNode *expr, bool execution_result_matters);
+    void    compileAtom(AtomNode *node, ExprNode *expr);
+    void    compileWhile(WhileStmtNode *node);
+    void    compileFor(ForStmtNode *node);
+    void    compileIf(IfStmtNode *node, bool execution_result_matters);
+    void    compileBlock(BlockStmtNode *node, bool execution_result_matters);
+    bool    enterScope(ScopeLayout *layout, TextArea *area);
+    void    leaveScope(bool frame, TextArea *area);
+    void    unwindScopes(int64_t depth, TextArea *area);
+    void    enterContext(TextArea *area);
+    void    leaveContext(TextArea *area);
+    void    unwindContexts(int64_t depth, TextArea *area);
+    void    compileReturn(ReturnStmtNode *node);
+    void    compileLoopExit(StmtNode *node);
+
+public:
+    /**
+     * @brief Construct a new Compiler object
+     *
+     * @param rt The runtime. Must be valid.
+     */
+    Compiler(Runtime *rt);
+
+    /**
+     * @brief Compiles the given statement into a new chunk.
+     *
+     * @param node The statement. Must be valid.
+     * @return Chunk*
+     */
+    Chunk *compile(StmtNode *node);
+};
+
+/**
+ * @brief Returns whether the expression ends with a direct pass (`@`) once parentheses are stripped.
+ *
+ * @param expr The expression. May be nullptr.
+ * @return `true` if the value of the expression must not be copied.
+ */
+bool isDirectPassExpr(ExprNode *expr);
+}    // namespace Cotton
@@ -26,8 +26,29 @@
 #include "runtime.h"
 #include "scope.h"
 #include "type.h"
+#include "vm.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace Cotton {
+const char *GCCycleStats::getTriggerName(Trigger trigger) {
+    ProfilerCAPTURE();
+    switch (trigger) {
+    case EXPLICIT       : return "explicit";
+    case OBJECT_COUNT   : return "object count";
+    case HEAP_SIZE      : return "heap size";
+    case OPERATIONS     : return "operations";
+    case HEAP_TARGET    : return "heap target";
+    case OLD_GENERATION : return "old generation";
+    case NURSERY        : return "nursery";
+    case HEAP_LIMIT     : return "heap limit";
+    }
+    return "unknown";
+}
+
 GCDefaultStrategy::GCDefaultStrategy() {
     ProfilerCAPTURE();
     this->num_tracked         = 0;
@@ -76,19 +97,28 @@ void GCDefaultStrategy::acknowledgeUntrack(Type *type) {
     this->sizeof_tracked -= sizeof(Type);
 }
 
+void GCDefaultStrategy::acknowledgeResize(Instance *instance, int64_t delta) {
+    ProfilerCAPTURE();
+    this->sizeof_tracked += delta;
+}
+
 void GCDefaultStrategy::acknowledgeEndOfCycle(Runtime *rt) {
     ProfilerCAPTURE();
     this->prev_num_tracked = rt->getGC()->tracked_instances.size() + rt->getGC()->tracked_objects.size()
                              + rt->getGC()->tracked_types.size();
     this->prev_sizeof_tracked = 0;
     for (auto &[obj, _] : rt->getGC()->tracked_objects) {
-        this->prev_sizeof_tracked += sizeof(obj);
+        this->prev_sizeof_tracked += sizeof(Object);
     }
     for (auto &[ins, _] : rt->getGC()->tracked_instances) {
         this->prev_sizeof_tracked += ins->getSize();
     }
     for (auto &[type, _] : rt->getGC()->tracked_types) {
-        this->prev_sizeof_tracked += sizeof(type);
+        this->prev_sizeof_tracked += sizeof(Type);
+    }
+    if (rt->getGC()->slab_tracking) {
+        this->prev_num_tracked    += rt->getGC()->slabs.getLive();
+        this->prev_sizeof_tracked += rt->getGC()->slabs.getBytes();
     }
     this->num_tracked    = this->prev_num_tracked;
     this->sizeof_tracked = this->prev_sizeof_tracked;
@@ -101,25 +131,267 @@ void GCDefaultStrategy::acknowledgePing(Runtime *rt) {
 
 void GCDefaultStrategy::checkConditions(Runtime *rt) {
     ProfilerCAPTURE();
-    if (this->sizeof_tracked >= MIN_CYCLE_SIZE
-        && ((this->prev_num_tracked < this->num_tracked / NUM_TRACKED_MULT)
-            || (this->prev_sizeof_tracked < this->sizeof_tracked / SIZEOF_TRACKED_MULT)
-            || (this->ops_cnt >= OPS_MOD)))
-    {
+    if (this->conditionsMet()) {
+        auto trigger   = this->getTrigger();
         this->ops_cnt %= OPS_MOD;
-        rt->getGC()->runCycle(rt);
+        rt->getGC()->runCycle(rt, trigger);
+    }
+}
+
+bool GCDefaultStrategy::waitsForSweep(Runtime *rt) {
+    ProfilerCAPTURE();
+    return this->conditionsMet();
+}
+
+bool GCDefaultStrategy::conditionsMet() {
+    ProfilerCAPTURE();
+    return this->sizeof_tracked >= MIN_CYCLE_SIZE
+           && ((this->prev_num_tracked < this->num_tracked / NUM_TRACKED_MULT)
+               || (this->prev_sizeof_tracked < this->sizeof_tracked / SIZEOF_TRACKED_MULT)
+               || (this->ops_cnt >= OPS_MOD));
+}
+
+GCCycleStats::Trigger GCDefaultStrategy::getTrigger() {
+    ProfilerCAPTURE();
+    if (this->prev_num_tracked < this->num_tracked / NUM_TRACKED_MULT) {
+        return GCCycleStats::OBJECT_COUNT;
     }
+    if (this->prev_sizeof_tracked < this->sizeof_tracked / SIZEOF_TRACKED_MULT) {
+        return GCCycleStats::HEAP_SIZE;
+    }
+    return GCCycleStats::OPERATIONS;
+}
+
+void GCIncrementalStrategy::acknowledgeEndOfCycle(Runtime *rt) {
+    ProfilerCAPTURE();
+    this->prev_num_tracked    = this->num_tracked;
+    this->prev_sizeof_tracked = this->sizeof_tracked;
+}
+
+void GCIncrementalStrategy::acknowledgePing(Runtime *rt) {
+    ProfilerCAPTURE();
+    if (rt->getGC()->isCollecting()) {
+        rt->getGC()->runIncrementalStep(rt, rt->getGC()->slice_budget);
+        return;
+    }
+    if (this->conditionsMet()) {
+        auto trigger   = this->getTrigger();
+        this->ops_cnt %= OPS_MOD;
+        rt->getGC()->runIncrementalStep(rt, rt->getGC()->slice_budget, trigger);
+    }
+}
+
+bool GCIncrementalStrategy::usesIncrementalMarking() {
+    ProfilerCAPTURE();
+    return true;
+}
+
+bool GCStrategy::usesGenerations() {
+    ProfilerCAPTURE();
+    return false;
+}
+
+bool GCStrategy::usesIncrementalMarking() {
+    ProfilerCAPTURE();
+    return false;
+}
+
+bool GCStrategy::waitsForSweep(Runtime *rt) {
+    ProfilerCAPTURE();
+    return false;
+}
+
+void GCStrategy::acknowledgeResize(Instance *instance, int64_t delta) {
+    ProfilerCAPTURE();
+}
+
+int64_t GCStrategy::getCheckpointBytes() {
+    ProfilerCAPTURE();
+    return 0;
+}
+
+void GCStrategy::acknowledgeEndOfMinorCycle(Runtime *rt) {
+    ProfilerCAPTURE();
+}
+
+GCGenerationalStrategy::GCGenerationalStrategy() {
+    ProfilerCAPTURE();
+    this->allocated_bytes  = 0;
+    this->next_major_bytes = MIN_MAJOR_BYTES;
+}
+
+void GCGenerationalStrategy::acknowledgeTrack(Object *object) {
+    ProfilerCAPTURE();
+    this->allocated_bytes += sizeof(Object);
+}
+
+void GCGenerationalStrategy::acknowledgeTrack(Instance *instance, size_t bytes) {
+    ProfilerCAPTURE();
+    this->allocated_bytes += bytes;
+}
+
+void GCGenerationalStrategy::acknowledgeTrack(Type *type) {
+    ProfilerCAPTURE();
+    this->allocated_bytes += sizeof(Type);
+}
+
+void GCGenerationalStrategy::acknowledgeUntrack(Object *object) {
+    ProfilerCAPTURE();
+}
+
+void GCGenerationalStrategy::acknowledgeUntrack(Instance *instance) {
+    ProfilerCAPTURE();
+}
+
+void GCGenerationalStrategy::acknowledgeUntrack(Type *type) {
+    ProfilerCAPTURE();
+}
+
+// growing counts as allocating, shrinking doesn't free anything until the instance dies
+void GCGenerationalStrategy::acknowledgeResize(Instance *instance, int64_t delta) {
+    ProfilerCAPTURE();
+    if (delta > 0) {
+        this->allocated_bytes += delta;
+    }
+}
+
+void GCGenerationalStrategy::acknowledgeEndOfCycle(Runtime *rt) {
+    ProfilerCAPTURE();
+    this->allocated_bytes  = 0;
+    this->next_major_bytes = std::max(MIN_MAJOR_BYTES, rt->getGC()->old_bytes * OLD_GROWTH_MULT);
+}
+
+void GCGenerationalStrategy::acknowledgeEndOfMinorCycle(Runtime *rt) {
+    ProfilerCAPTURE();
+    this->allocated_bytes = 0;
+}
+
+void GCGenerationalStrategy::acknowledgePing(Runtime *rt) {
+    ProfilerCAPTURE();
+    if (this->allocated_bytes < NURSERY_BYTES) {
+        return;
+    }
+    rt->getGC()->runMinorCycle(rt);
+    if (rt->getGC()->old_bytes >= this->next_major_bytes) {
+        rt->getGC()->runCycle(rt, GCCycleStats::OLD_GENERATION);
+    }
+}
+
+bool GCGenerationalStrategy::usesGenerations() {
+    ProfilerCAPTURE();
+    return true;
+}
+
+GCPacingStrategy::GCPacingStrategy(int64_t target) {
+    ProfilerCAPTURE();
+    this->target           = target;
+    this->heap_bytes       = 0;
+    this->next_cycle_bytes = MIN_HEAP_BYTES;
+}
+
+void GCPacingStrategy::acknowledgeTrack(Object *object) {
+    ProfilerCAPTURE();
+    this->heap_bytes += sizeof(Object);
+}
+
+void GCPacingStrategy::acknowledgeTrack(Instance *instance, size_t bytes) {
+    ProfilerCAPTURE();
+    this->heap_bytes += bytes;
+}
+
+void GCPacingStrategy::acknowledgeTrack(Type *type) {
+    ProfilerCAPTURE();
+    this->heap_bytes += sizeof(Type);
+}
+
+// what cycles free is taken from GC::freed_bytes at the end of the cycle
+void GCPacingStrategy::acknowledgeUntrack(Object *object) {
+    ProfilerCAPTURE();
+}
+
+void GCPacingStrategy::acknowledgeUntrack(Instance *instance) {
+    ProfilerCAPTURE();
+}
+
+void GCPacingStrategy::acknowledgeUntrack(Type *type) {
+    ProfilerCAPTURE();
+}
+
+void GCPacingStrategy::acknowledgeResize(Instance *instance, int64_t delta) {
+    ProfilerCAPTURE();
+    this->heap_bytes += delta;
+}
+
+void GCPacingStrategy::acknowledgeEndOfCycle(Runtime *rt) {
+    ProfilerCAPTURE();
+    this->heap_bytes       = std::max((int64_t)0, this->heap_bytes - rt->getGC()->freed_bytes);
+    this->next_cycle_bytes = std::max(MIN_HEAP_BYTES, this->heap_bytes + this->heap_bytes * this->target / 100);
+}
+
+void GCPacingStrategy::acknowledgePing(Runtime *rt) {
+    ProfilerCAPTURE();
+    if (this->heap_bytes < this->next_cycle_bytes) {
+        return;
+    }
+    // until the cycle reports what it freed, the next one is paced as if nothing died
+    this->next_cycle_bytes = this->heap_bytes + this->heap_bytes * this->target / 100;
+    rt->getGC()->runCycle(rt, GCCycleStats::HEAP_TARGET);
+}
+
+bool GCPacingStrategy::waitsForSweep(Runtime *rt) {
+    ProfilerCAPTURE();
+    return this->heap_bytes >= this->next_cycle_bytes;
+}
+
+int64_t GCPacingStrategy::getCheckpointBytes() {
+    ProfilerCAPTURE();
+    return CHECKPOINT_BYTES;
 }
 
 GC::GC(GCStrategy *gc_strategy) {
     ProfilerCAPTURE();
-    this->gc_strategy = gc_strategy;
-    this->gc_mark     = 1;
-    this->enabled     = true;
+    this->gc_strategy       = gc_strategy;
+    this->gc_mark           = 1;
+    this->enabled           = true;
+    this->generational      = gc_strategy->usesGenerations();
+    this->old_bytes         = 0;
+    this->incremental       = gc_strategy->usesIncrementalMarking();
+    this->phase             = IDLE;
+    this->slice_budget      = 10'000;
+    this->sweep_mark        = 0;
+    this->max_pause         = 0;
+    this->mark_threads      = 1;
+    this->freed_count       = 0;
+    this->freed_bytes       = 0;
+    this->heap_bytes        = 0;
+    this->max_heap_bytes    = 0;
+    this->checkpoint_bytes  = gc_strategy->getCheckpointBytes();
+    this->checkpoint_budget = this->checkpoint_bytes;
+    this->pause_histogram.resize(PAUSE_BUCKETS);
+    this->take_census           = false;
+    this->background_sweep_time = 0;
+#if defined COTTON_ENABLE_PROFILER
+    this->background_sweep = false;    // destructors capture the profiler, which is not thread safe
+#else
+    this->background_sweep = true;
+#endif
+    this->slab_tracking    = !this->generational && !this->incremental;
+    this->sweep_running    = false;
+    this->sweep_done       = false;
 }
 
 GC::~GC() {
     ProfilerCAPTURE();
+    if (this->sweep_running) {
+        this->sweep_thread.join();
+    }
+    for (auto &[obj, _] : this->swept_objects) {
+        delete obj;
+    }
+    for (auto &[ins, _] : this->swept_instances) {
+        delete ins;
+    }
+    this->swept_slabs.clear();
     for (auto &[obj, _] : this->tracked_objects) {
         delete (obj);
     }
@@ -129,10 +401,46 @@ GC::~GC() {
     for (auto &[type, _] : this->tracked_types) {
         delete type;
     }
+    for (auto obj : this->young_objects) {
+        delete obj;
+    }
+    for (auto ins : this->young_instances) {
+        delete ins;
+    }
+    for (auto obj : this->incremental_objects) {
+        delete obj;
+    }
+    for (auto ins : this->incremental_instances) {
+        delete ins;
+    }
+    for (auto obj : this->sweeping_objects) {
+        delete obj;
+    }
+    for (auto ins : this->sweeping_instances) {
+        delete ins;
+    }
+    this->slabs.clear();
 }
 
 void GC::track(Object *object) {
     ProfilerCAPTURE();
+    this->checkpoint_budget -= sizeof(Object);
+    this->heap_bytes        += sizeof(Object);
+    if (this->generational) {
+        this->young_objects.push_back(object);
+        this->gc_strategy->acknowledgeTrack(object);
+        return;
+    }
+    if (this->incremental) {
+        this->incremental_objects.push_back(object);
+        this->gc_strategy->acknowledgeTrack(object);
+        return;
+    }
+    // objects are always in the slabs
+    if (this->slab_tracking) {
+        this->gc_strategy->acknowledgeTrack(object);
+        return;
+    }
     if (this->tracked_objects.find(object) != this->tracked_objects.end()) {
         return;
     }
@@ -142,6 +450,22 @@ void GC::track(Object *object) {
 
 void GC::track(Instance *instance, size_t bytes) {
     ProfilerCAPTURE();
+    this->checkpoint_budget -= bytes;
+    this->heap_bytes        += bytes;
+    if (this->generational) {
+        this->young_instances.push_back(instance);
+        this->gc_strategy->acknowledgeTrack(instance, bytes);
+        return;
+    }
+    if (this->incremental) {
+        this->incremental_instances.push_back(instance);
+        this->gc_strategy->acknowledgeTrack(instance, bytes);
+        return;
+    }
+    if (this->slab_tracking && instance->gc_slab) {
+        this->gc_strategy->acknowledgeTrack(instance, bytes);
+        return;
+    }
     if (this->tracked_instances.find(instance) != this->tracked_instances.end()) {
         return;
     }
@@ -151,6 +475,8 @@ void GC::track(Instance *instance, size_t bytes) {
 
 void GC::track(Type *type) {
     ProfilerCAPTURE();
+    this->checkpoint_budget -= sizeof(Type);
+    this->heap_bytes        += sizeof(Type);
     if (this->tracked_types.find(type) != this->tracked_types.end()) {
         return;
     }
@@ -160,6 +486,17 @@ void GC::track(Type *type) {
 
 void GC::untrack(Object *object) {
     ProfilerCAPTURE();
+    this->heap_bytes -= sizeof(Object);
+    if (this->generational && !object->gc_old) {
+        std::erase(this->young_objects, object);
+        return;
+    }
+    if (this->incremental) {
+        std::erase(this->incremental_objects, object);
+        std::erase(this->sweeping_objects, object);
+        return;
+    }
+    this->finishSweep(this->rt);
     auto it = this->tracked_objects.find(object);
     if (it == this->tracked_objects.end()) {
         return;
@@ -169,6 +506,17 @@ void GC::untrack(Object *object) {
 
 void GC::untrack(Instance *instance) {
     ProfilerCAPTURE();
+    this->heap_bytes -= instance->getSize();
+    if (this->generational && !instance->gc_old) {
+        std::erase(this->young_instances, instance);
+        return;
+    }
+    if (this->incremental) {
+        std::erase(this->incremental_instances, instance);
+        std::erase(this->sweeping_instances, instance);
+        return;
+    }
+    this->finishSweep(this->rt);
     auto it = this->tracked_instances.find(instance);
     if (it == this->tracked_instances.end()) {
         return;
@@ -178,6 +526,7 @@ void GC::untrack(Instance *instance) {
 
 void GC::untrack(Type *type) {
     ProfilerCAPTURE();
+    this->heap_bytes -= sizeof(Type);
     auto it = this->tracked_types.find(type);
     if (it == this->tracked_types.end()) {
         return;
@@ -185,132 +534,998 @@ void GC::untrack(Type *type) {
     this->tracked_types.erase(type);
 }
 
+void GC::trackResize(Instance *instance, int64_t delta) {
+    ProfilerCAPTURE();
+    this->heap_bytes += delta;
+    if (delta > 0) {
+        this->checkpoint_budget -= delta;
+    }
+    if (this->generational && instance->gc_old) {
+        this->old_bytes += delta;
+    }
+    this->gc_strategy->acknowledgeResize(instance, delta);
+}
+
+size_t GC::pushRoot(Object *object) {
+    ProfilerCAPTURE();
+    this->roots.push_back(object);
+    return this->roots.size() - 1;
+}
+
+void GC::setRoot(size_t index, Object *object) {
+    ProfilerCAPTURE();
+    this->roots[index] = object;
+}
+
+void GC::popRoots(size_t index) {
+    ProfilerCAPTURE();
+    this->roots.resize(index);
+}
+
 void GC::hold(Object *object) {
     ProfilerCAPTURE();
-    ++this->held_objects[object];
+    this->held_objects.push_back(object);
 }
 
 void GC::release(Object *object) {
     ProfilerCAPTURE();
-    if (--this->held_objects[object] <= 0) {
-        this->held_objects.erase(object);
+    // the latest holds are the most likely to be released
+    for (auto i = this->held_objects.size(); i > 0; i--) {
+        if (this->held_objects[i - 1] == object) {
+            this->held_objects[i - 1] = this->held_objects.back();
+            this->held_objects.pop_back();
+            return;
+        }
+    }
+}
+
+GCRootGuard::GCRootGuard(GC *gc, Object *object) {
+    ProfilerCAPTURE();
+    this->gc    = gc;
+    this->index = gc->pushRoot(object);
+}
+
+GCRootGuard::~GCRootGuard() {
+    ProfilerCAPTURE();
+    this->gc->popRoots(this->index);
+}
+
+void GCRootGuard::set(Object *object) {
+    ProfilerCAPTURE();
+    this->gc->setRoot(this->index, object);
+}
+
+GCResizeGuard::GCResizeGuard(GC *gc, Instance *instance) {
+    ProfilerCAPTURE();
+    this->gc       = gc;
+    this->instance = instance;
+    this->bytes    = instance->getSize();
+}
+
+GCResizeGuard::~GCResizeGuard() {
+    ProfilerCAPTURE();
+    int64_t bytes = this->instance->getSize();
+    if (bytes != this->bytes) {
+        this->gc->trackResize(this->instance, bytes - this->bytes);
+    }
+}
+
+void GC::writeBarrier(Object *object) {
+    ProfilerCAPTURE();
+    if (object->gc_old && !object->gc_remembered) {
+        object->gc_remembered = true;
+        this->remembered_objects.push_back(object);
+    }
+    // a black object may now reference a white one, so it has to be traced again
+    if (this->phase == MARKING && object->gc_mark == this->gc_mark && !object->gc_gray) {
+        object->gc_gray = true;
+        this->gray_objects.push_back(object);
+    }
+}
+
+void GC::writeBarrier(Instance *instance) {
+    ProfilerCAPTURE();
+    if (instance->gc_old && !instance->gc_remembered) {
+        instance->gc_remembered = true;
+        this->remembered_instances.push_back(instance);
+    }
+    if (this->phase == MARKING && instance->gc_mark == this->gc_mark && !instance->gc_gray) {
+        instance->gc_gray = true;
+        this->gray_instances.push_back(instance);
     }
 }
 
 void GC::ping(Runtime *rt) {
     ProfilerCAPTURE();
+    if (this->max_heap_bytes != 0 && this->heap_bytes > this->max_heap_bytes) {
+        this->enforceHeapLimit(rt);
+    }
+    if (this->checkpoint_bytes != 0) {
+        if (this->checkpoint_budget > 0) {
+            return;
+        }
+        this->checkpoint_budget = this->checkpoint_bytes;
+    }
+    if (this->sweep_running) {
+        if (!this->sweep_done && !this->gc_strategy->waitsForSweep(rt)) {
+            return;
+        }
+        this->finishSweep(rt);
+    }
     this->gc_strategy->acknowledgePing(rt);
 }
 
-static void mark(Instance *ins, Runtime *rt);
-static void mark(Type *type, Runtime *rt);
+static int64_t getMicrosecondsSince(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+}
 
-static void mark(Object *obj, Runtime *rt) {
+// size in bytes of what gets freed, as counted when it was tracked
+static int64_t getFreedSize(Object *object) {
+    return sizeof(Object);
+}
+
+static int64_t getFreedSize(Instance *instance) {
+    return instance->getSize();
+}
+
+static int64_t getFreedSize(Type *type) {
+    return sizeof(Type);
+}
+
+// deletes everything in the table that isn't marked with `mark`, counting it in `freed_count` and `freed_bytes`
+template<typename T>
+static void sweepTable(GCTable<T> &table, bool mark, int64_t &freed_count, int64_t &freed_bytes) {
     ProfilerCAPTURE();
-    if (obj == nullptr) {
-        return;
+    std::vector<T *> deleted;
+    for (auto &[ptr, _] : table) {
+        if (ptr->gc_mark != mark) {
+            deleted.push_back(ptr);
+        }
     }
-    if (obj->gc_mark == rt->getGC()->gc_mark) {
-        return;
+    for (auto ptr : deleted) {
+        table.erase(ptr);
+        freed_count++;
+        freed_bytes += getFreedSize(ptr);
+        delete ptr;
     }
+}
 
-    obj->gc_mark = rt->getGC()->gc_mark;
-    for (auto &o : obj->getGCReachable()) {
-        mark(o, rt);
+namespace {
+// an object, instance or type that has been marked, but whose references haven't been traced yet
+struct MarkTask {
+    enum Kind : uint8_t {
+        OBJECT,
+        INSTANCE,
+        TYPE,
+    };
+
+    Kind  kind;
+    void *ptr;
+};
+
+// passes the references of the task to the visitor
+void traceTask(MarkTask task, GCVisitor &visitor) {
+    switch (task.kind) {
+    case MarkTask::OBJECT   : ((Object *)task.ptr)->trace(visitor); break;
+    case MarkTask::INSTANCE : ((Instance *)task.ptr)->trace(visitor); break;
+    case MarkTask::TYPE     : ((Type *)task.ptr)->trace(visitor); break;
     }
-    mark(obj->instance, rt);
-    mark(obj->type, rt);
 }
 
-static void mark(Instance *ins, Runtime *rt) {
-    ProfilerCAPTURE();
-    if (ins == nullptr) {
-        return;
+// marks everything reachable from what it visits. Marked objects, instances and types wait on an explicit stack
+// to be traced, so that long chains of references can't overflow the call stack
+class Marker: public GCVisitor {
+protected:
+    bool                  gc_mark;
+    std::vector<MarkTask> stack;
+
+    template<typename T>
+    void push(T *ptr, MarkTask::Kind kind) {
+        if (ptr == nullptr || ptr->gc_mark == this->gc_mark) {
+            return;
+        }
+        ptr->gc_mark = this->gc_mark;
+        this->stack.push_back({kind, ptr});
     }
-    if (ins->gc_mark == rt->getGC()->gc_mark) {
-        return;
+
+public:
+    Marker(bool gc_mark) {
+        this->gc_mark = gc_mark;
     }
 
-    ins->gc_mark = rt->getGC()->gc_mark;
-    for (auto &o : ins->getGCReachable()) {
-        mark(o, rt);
+    void visit(Object *object) {
+        this->push(object, MarkTask::OBJECT);
+    }
+
+    void visit(Instance *instance) {
+        this->push(instance, MarkTask::INSTANCE);
+    }
+
+    void visit(Type *type) {
+        this->push(type, MarkTask::TYPE);
+    }
+
+    // traces until the stack runs out. Returns `false` if there was nothing to trace
+    bool drain() {
+        ProfilerCAPTURE();
+        bool traced = !this->stack.empty();
+        while (!this->stack.empty()) {
+            auto task = this->stack.back();
+            this->stack.pop_back();
+            traceTask(task, *this);
+        }
+        return traced;
     }
+};
+
+// marks only the young generation, old objects and instances are reached through the remembered set
+class YoungMarker: public Marker {
+public:
+    YoungMarker(bool gc_mark)
+        : Marker(gc_mark) {}
+
+    void visit(Object *object) {
+        if (object != nullptr && !object->gc_old) {
+            this->push(object, MarkTask::OBJECT);
+        }
+    }
+
+    void visit(Instance *instance) {
+        if (instance != nullptr && !instance->gc_old) {
+            this->push(instance, MarkTask::INSTANCE);
+        }
+    }
+
+    // types are never young
+    void visit(Type *type) {}
+};
+
+// checks whether what it visits has anything from the young generation
+class YoungReferenceFinder: public GCVisitor {
+public:
+    bool found = false;
+
+    void visit(Object *object) {
+        this->found |= object != nullptr && !object->gc_old;
+    }
+
+    void visit(Instance *instance) {
+        this->found |= instance != nullptr && !instance->gc_old;
+    }
+
+    void visit(Type *type) {}
+};
+}    // namespace
+
+template<typename T>
+static bool hasYoungReferences(T *ptr) {
+    ProfilerCAPTURE();
+    YoungReferenceFinder finder;
+    ptr->trace(finder);
+    return finder.found;
 }
 
-static void mark(Type *type, Runtime *rt) {
+void GC::markRoots(Runtime *rt, const std::function<void(Object *)> &mark) {
     ProfilerCAPTURE();
-    if (type == nullptr) {
+    auto scope = rt->getScope();
+    while (scope != nullptr) {
+        for (auto obj : scope->slots) {
+            mark(obj);
+        }
+        for (auto &[_, obj] : scope->variables) {
+            mark(obj);
+        }
+        for (auto obj : scope->arguments) {
+            mark(obj);
+        }
+        scope = scope->prev;
+    }
+    for (auto obj : this->roots) {
+        mark(obj);
+    }
+    mark(rt->tail_call_function);
+    for (auto obj : rt->tail_call_args) {
+        mark(obj);
+    }
+    for (auto obj : this->held_objects) {
+        mark(obj);
+    }
+    for (auto &[_, obj] : rt->globals) {
+        mark(obj);
+    }
+    for (size_t i = 0; i <= rt->arg_stack->current; i++) {
+        auto &chunk = rt->arg_stack->chunks[i];
+        for (size_t j = 0; j < chunk.used; j++) {
+            if (chunk.slots[j] != nullptr) {
+                mark(chunk.slots[j]);
+            }
+        }
+    }
+    if (rt->vm != nullptr) {
+        for (auto &value : rt->vm->stack) {
+            if (!value.isImmediate()) {
+                mark(value.object);
+            }
+        }
+    }
+}
+
+// marks the object gray, so that it gets traced by a later incremental step
+static void shade(Object *obj, Runtime *rt) {
+    ProfilerCAPTURE();
+    if (obj == nullptr || obj->gc_mark == rt->getGC()->gc_mark) {
         return;
     }
-    if (type->gc_mark == rt->getGC()->gc_mark) {
+    obj->gc_mark = rt->getGC()->gc_mark;
+    obj->gc_gray = true;
+    rt->getGC()->gray_objects.push_back(obj);
+}
+
+static void shade(Instance *ins, Runtime *rt) {
+    ProfilerCAPTURE();
+    if (ins == nullptr || ins->gc_mark == rt->getGC()->gc_mark) {
         return;
     }
+    ins->gc_mark = rt->getGC()->gc_mark;
+    ins->gc_gray = true;
+    rt->getGC()->gray_instances.push_back(ins);
+}
 
+static void shade(Type *type, Runtime *rt) {
+    ProfilerCAPTURE();
+    if (type == nullptr || type->gc_mark == rt->getGC()->gc_mark) {
+        return;
+    }
     type->gc_mark = rt->getGC()->gc_mark;
-    for (auto &o : type->getGCReachable()) {
-        mark(o, rt);
+    rt->getGC()->gray_types.push_back(type);
+}
+
+namespace {
+// shades what it visits, counting the references
+class Shader: public GCVisitor {
+private:
+    Runtime *rt;
+
+public:
+    int64_t visited = 0;
+
+    Shader(Runtime *rt) {
+        this->rt = rt;
+    }
+
+    void visit(Object *object) {
+        this->visited++;
+        shade(object, this->rt);
+    }
+
+    void visit(Instance *instance) {
+        this->visited++;
+        shade(instance, this->rt);
+    }
+
+    void visit(Type *type) {
+        this->visited++;
+        shade(type, this->rt);
     }
+};
+}    // namespace
+
+int64_t GC::traceGray(Runtime *rt, int64_t budget) {
+    ProfilerCAPTURE();
+    // every traced reference is a unit of work
+    Shader shader(rt);
+    while (budget > 0) {
+        shader.visited = 0;
+        if (!this->gray_objects.empty()) {
+            auto obj = this->gray_objects.back();
+            this->gray_objects.pop_back();
+            obj->gc_gray = false;
+            obj->trace(shader);
+        }
+        else if (!this->gray_instances.empty()) {
+            auto ins = this->gray_instances.back();
+            this->gray_instances.pop_back();
+            ins->gc_gray = false;
+            ins->trace(shader);
+        }
+        else if (!this->gray_types.empty()) {
+            auto type = this->gray_types.back();
+            this->gray_types.pop_back();
+            type->trace(shader);
+        }
+        else {
+            break;
+        }
+        budget -= 1 + shader.visited;
+    }
+    return budget;
 }
 
-void GC::runCycle(Runtime *rt) {
+bool GC::sweepSlice(int64_t budget) {
     ProfilerCAPTURE();
-    if (!this->enabled) {
+    for (; !this->sweeping_objects.empty() && budget > 0; budget--) {
+        auto obj = this->sweeping_objects.back();
+        this->sweeping_objects.pop_back();
+        if (obj->gc_mark == this->sweep_mark) {
+            this->incremental_objects.push_back(obj);
+        }
+        else {
+            this->freed_count++;
+            this->freed_bytes += sizeof(Object);
+            this->gc_strategy->acknowledgeUntrack(obj);
+            delete obj;
+        }
+    }
+    for (; !this->sweeping_instances.empty() && budget > 0; budget--) {
+        auto ins = this->sweeping_instances.back();
+        this->sweeping_instances.pop_back();
+        if (ins->gc_mark == this->sweep_mark) {
+            this->incremental_instances.push_back(ins);
+        }
+        else {
+            this->freed_count++;
+            this->freed_bytes += ins->getSize();
+            this->gc_strategy->acknowledgeUntrack(ins);
+            delete ins;
+        }
+    }
+    return this->sweeping_objects.empty() && this->sweeping_instances.empty();
+}
+
+void GC::runIncrementalStep(Runtime *rt, int64_t budget, GCCycleStats::Trigger trigger) {
+    ProfilerCAPTURE();
+    if (!this->enabled || !this->incremental) {
         return;
     }
-    // mark
-    auto scope = rt->getScope();
-    while (scope != nullptr) {
-        for (auto &[_, obj] : scope->variables) {
-            mark(obj, rt);
+    auto begin = std::chrono::steady_clock::now();
+    if (this->phase == IDLE) {
+        this->current_stats = {trigger, 0, 0, 0, 0};
+        this->freed_count   = 0;
+        this->freed_bytes   = 0;
+        this->markRoots(rt, [rt](Object *obj) { shade(obj, rt); });
+        this->phase = MARKING;
+    }
+    if (this->phase == MARKING) {
+        this->traceGray(rt, budget);
+        if (this->gray_objects.empty() && this->gray_instances.empty() && this->gray_types.empty()) {
+            // the roots and the methods of types change without write barriers, so they are shaded again. The
+            // rest of the marking has to be done in one go, otherwise the roots would change again
+            this->markRoots(rt, [rt](Object *obj) { shade(obj, rt); });
+            for (auto &[type, _] : this->tracked_types) {
+                if (type->gc_mark == this->gc_mark) {
+                    this->gray_types.push_back(type);
+                }
+            }
+            this->traceGray(rt, INT64_MAX);
+            Shader shader(rt);
+            this->processWeakInstances(
+                shader,
+                [this, rt] {
+                    bool traced = !this->gray_objects.empty() || !this->gray_instances.empty()
+                                  || !this->gray_types.empty();
+                    this->traceGray(rt, INT64_MAX);
+                    return traced;
+                },
+                [this](Instance *ins) { return ins->gc_mark == this->gc_mark; });
+            if (this->take_census) {
+                this->takeCensus(rt);
+            }
+
+            // there are few types, so they are swept right away
+            std::vector<Type *> deleted_types;
+            for (auto &[type, _] : this->tracked_types) {
+                if (type->gc_mark != this->gc_mark) {
+                    deleted_types.push_back(type);
+                }
+            }
+            for (auto &type : deleted_types) {
+                this->tracked_types.erase(type);
+                this->freed_count++;
+                this->freed_bytes += sizeof(Type);
+                this->gc_strategy->acknowledgeUntrack(type);
+                delete type;
+            }
+
+            // new allocations get the flipped mark, which makes them white for the next cycle
+            this->sweep_mark = this->gc_mark;
+            this->gc_mark    = !this->gc_mark;
+            this->sweeping_objects.swap(this->incremental_objects);
+            this->sweeping_instances.swap(this->incremental_instances);
+            this->phase = SWEEPING;
         }
-        for (auto &obj : scope->arguments) {
-            mark(obj, rt);
+        this->current_stats.mark_time += getMicrosecondsSince(begin);
+    }
+    else {
+        bool done                      = this->sweepSlice(budget);
+        this->current_stats.sweep_time += getMicrosecondsSince(begin);
+        if (done) {
+            this->phase = IDLE;
+            this->finishCycle();
+            this->gc_strategy->acknowledgeEndOfCycle(rt);
         }
-        scope = scope->prev;
     }
-    for (auto &[obj, _] : this->held_objects) {
-        mark(obj, rt);
+    this->recordPause(begin);
+}
+
+void GC::processWeakInstances(GCVisitor &visitor, const std::function<bool()> &drain,
+                              const std::function<bool(Instance *)> &is_live) {
+    ProfilerCAPTURE();
+    if (this->weak_instances.empty()) {
+        return;
     }
-    for (auto &[_, obj] : rt->globals) {
-        mark(obj, rt);
+    // dead weak instances may come to life too, if they are kept alive by the weak references of another one
+    do {
+        for (auto ins : this->weak_instances) {
+            if (is_live(ins)) {
+                ins->traceEphemerons(visitor, is_live);
+            }
+        }
+    } while (drain());
+    std::erase_if(this->weak_instances, [&is_live](WeakInstance *ins) { return !is_live(ins); });
+    for (auto ins : this->weak_instances) {
+        GCResizeGuard guard(this, ins);
+        ins->clearDead(is_live);
     }
-    // sweep
-    std::vector<Object *> deleted_objects;
+}
+
+void GC::finishCycle() {
+    ProfilerCAPTURE();
+    this->current_stats.freed_count  = this->freed_count;
+    this->current_stats.freed_bytes  = this->freed_bytes;
+    this->heap_bytes                -= this->freed_bytes;
+    this->cycle_stats.push_back(this->current_stats);
+}
+
+void GC::enforceHeapLimit(Runtime *rt) {
+    ProfilerCAPTURE();
+    // a cycle that is already running may have marked what has died since, so another one is needed to free it
+    bool was_collecting = this->isCollecting();
+    this->runCycle(rt, GCCycleStats::HEAP_LIMIT);
+    if (was_collecting) {
+        this->runCycle(rt, GCCycleStats::HEAP_LIMIT);
+    }
+    this->finishSweep(rt);
+    if (this->heap_bytes > this->max_heap_bytes) {
+        rt->signalError("Heap limit of " + std::to_string(this->max_heap_bytes) + " bytes exceeded: "
+                            + std::to_string(this->heap_bytes) + " bytes are still in use",
+                        rt->getContext().area);
+    }
+}
+
+void GC::takeCensus(Runtime *rt) {
+    ProfilerCAPTURE();
+    std::unordered_map<Type *, int64_t> by_type;
+
+    auto count = [&](Object *obj) {
+        if (obj->gc_mark == this->gc_mark) {
+            by_type[obj->type]++;
+        }
+    };
     for (auto &[obj, _] : this->tracked_objects) {
-        if (obj->gc_mark != this->gc_mark) {
-            deleted_objects.push_back(obj);
+        count(obj);
+    }
+    for (auto obj : this->young_objects) {
+        count(obj);
+    }
+    for (auto obj : this->incremental_objects) {
+        count(obj);
+    }
+    if (this->slab_tracking) {
+        this->slabs.forEachObject(count);
+    }
+    // types with the same name are counted together
+    std::unordered_map<std::string, int64_t> by_name;
+    for (auto &[type, n] : by_type) {
+        by_name[type != nullptr ? type->userRepr(rt) : "nullptr"] += n;
+    }
+    this->live_types.assign(by_name.begin(), by_name.end());
+    std::sort(this->live_types.begin(), this->live_types.end(), [](auto &a, auto &b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+}
+
+bool GC::isCollecting() {
+    ProfilerCAPTURE();
+    return this->phase != IDLE;
+}
+
+void GC::recordPause(std::chrono::steady_clock::time_point begin) {
+    ProfilerCAPTURE();
+    auto pause = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+    int  bucket = 0;
+    while (bucket < PAUSE_BUCKETS - 1 && pause >= PAUSE_BUCKET_LIMITS[bucket]) {
+        bucket++;
+    }
+    this->pause_histogram[bucket]++;
+    this->max_pause = std::max(this->max_pause, (int64_t)pause);
+}
+
+namespace {
+// tasks of a marking thread that other threads may steal. Only the owner adds to them
+struct MarkQueue {
+    std::mutex            lock;
+    std::vector<MarkTask> tasks;
+    std::atomic<size_t>   size = 0;
+};
+
+// the marking threads don't capture the profiler, since it is not thread safe
+class ParallelMarker {
+private:
+    static const size_t PUBLISH_SIZE = 64;    // a thread shares half of its tasks once it has that many
+
+    bool                                    gc_mark;
+    std::vector<std::unique_ptr<MarkQueue>> queues;
+    std::atomic<size_t>                     idle = 0;
+
+    template<typename T>
+    bool tryMark(T *ptr) {
+        if (ptr == nullptr || ptr->gc_mark.load(std::memory_order_relaxed) == this->gc_mark) {
+            return false;
         }
+        return ptr->gc_mark.exchange(this->gc_mark, std::memory_order_relaxed) != this->gc_mark;
     }
-    for (auto &obj : deleted_objects) {
-        this->tracked_objects.erase(obj);
-        delete (obj);
+
+    // marks what it visits on behalf of one of the threads
+    class ThreadVisitor: public GCVisitor {
+    private:
+        ParallelMarker        *marker;
+        std::vector<MarkTask> &local;
+
+        template<typename T>
+        void push(T *ptr, MarkTask::Kind kind) {
+            if (this->marker->tryMark(ptr)) {
+                this->local.push_back({kind, ptr});
+            }
+        }
+
+    public:
+        ThreadVisitor(ParallelMarker *marker, std::vector<MarkTask> &local)
+            : marker(marker)
+            , local(local) {}
+
+        void visit(Object *object) {
+            this->push(object, MarkTask::OBJECT);
+        }
+
+        void visit(Instance *instance) {
+            this->push(instance, MarkTask::INSTANCE);
+        }
+
+        void visit(Type *type) {
+            this->push(type, MarkTask::TYPE);
+        }
+    };
+
+    // moves half of the tasks of the queue into `local`
+    bool take(MarkQueue &queue, std::vector<MarkTask> &local) {
+        if (queue.size.load() == 0) {
+            return false;
+        }
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        auto half = (queue.tasks.size() + 1) / 2;
+        local.insert(local.end(), queue.tasks.end() - half, queue.tasks.end());
+        queue.tasks.resize(queue.tasks.size() - half);
+        queue.size.store(queue.tasks.size());
+        return true;
     }
-    std::vector<Instance *> deleted_instances;
-    for (auto &[ins, _] : this->tracked_instances) {
-        if (ins->gc_mark != this->gc_mark) {
-            deleted_instances.push_back(ins);
+
+    // own queue first, then the queues of the other threads
+    bool takeAny(size_t id, std::vector<MarkTask> &local) {
+        for (size_t i = 0; i < this->queues.size(); i++) {
+            if (this->take(*this->queues[(id + i) % this->queues.size()], local)) {
+                return true;
+            }
         }
+        return false;
     }
-    for (auto &ins : deleted_instances) {
-        this->tracked_instances.erase(ins);
-        delete (ins);
+
+    bool anyQueued() {
+        for (auto &queue : this->queues) {
+            if (queue->size.load() != 0) {
+                return true;
+            }
+        }
+        return false;
     }
-    std::vector<Type *> deleted_types;
-    for (auto &[type, _] : this->tracked_types) {
-        if (type->gc_mark != this->gc_mark) {
-            deleted_types.push_back(type);
+
+    void publish(size_t id, std::vector<MarkTask> &local) {
+        auto                       &queue = *this->queues[id];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        auto                        half = local.size() / 2;
+        queue.tasks.insert(queue.tasks.end(), local.end() - half, local.end());
+        local.resize(local.size() - half);
+        queue.size.store(queue.tasks.size());
+    }
+
+    // marking is over once every thread is idle. An idle thread has no tasks of its own, and its queue stays
+    // empty since only the owner adds to it, so then there are no tasks left anywhere
+    void work(size_t id) {
+        std::vector<MarkTask> local;
+        ThreadVisitor         visitor(this, local);
+        while (true) {
+            while (!local.empty()) {
+                auto task = local.back();
+                local.pop_back();
+                traceTask(task, visitor);
+                if (local.size() >= PUBLISH_SIZE && this->queues[id]->size.load(std::memory_order_relaxed) == 0) {
+                    this->publish(id, local);
+                }
+            }
+            if (this->takeAny(id, local)) {
+                continue;
+            }
+            this->idle++;
+            while (true) {
+                if (this->idle.load() == this->queues.size()) {
+                    return;
+                }
+                if (this->anyQueued()) {
+                    this->idle--;
+                    if (this->takeAny(id, local)) {
+                        break;
+                    }
+                    this->idle++;
+                }
+                std::this_thread::yield();
+            }
         }
     }
-    for (auto &type : deleted_types) {
-        this->tracked_types.erase(type);
-        delete type;
+
+public:
+    ParallelMarker(bool gc_mark, size_t threads) {
+        this->gc_mark = gc_mark;
+        for (size_t i = 0; i < threads; i++) {
+            this->queues.push_back(std::make_unique<MarkQueue>());
+        }
+    }
+
+    // roots get spread over the queues of all threads
+    void addRoot(Object *obj) {
+        if (this->tryMark(obj)) {
+            auto &queue = *this->queues[obj->id % this->queues.size()];
+            queue.tasks.push_back({MarkTask::OBJECT, obj});
+            queue.size.store(queue.tasks.size());
+        }
     }
 
-    this->gc_mark = !this->gc_mark;
+    void run() {
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < this->queues.size(); i++) {
+            threads.emplace_back([this, i]() { this->work(i); });
+        }
+        this->work(0);
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+};
+}    // namespace
+
+void GC::markParallel(Runtime *rt) {
+    ProfilerCAPTURE();
+    ParallelMarker marker(this->gc_mark, this->mark_threads);
+    this->markRoots(rt, [&marker](Object *obj) { marker.addRoot(obj); });
+    marker.run();
+}
+
+void GC::finishSweep(Runtime *rt) {
+    ProfilerCAPTURE();
+    if (!this->sweep_running) {
+        return;
+    }
+    auto begin = std::chrono::steady_clock::now();
+    this->sweep_thread.join();
+    this->sweep_running             = false;
+    this->current_stats.sweep_time += this->background_sweep_time;
+    // what was allocated during the sweep is usually far less than what survived it
+    for (auto &[obj, _] : this->tracked_objects) {
+        this->swept_objects[obj] = true;
+    }
+    for (auto &[ins, _] : this->tracked_instances) {
+        this->swept_instances[ins] = true;
+    }
+    this->tracked_objects.swap(this->swept_objects);
+    this->tracked_instances.swap(this->swept_instances);
+    this->slabs.takePages(this->swept_slabs);
+    this->swept_objects.clear();
+    this->swept_instances.clear();
+    this->finishCycle();
+    this->gc_strategy->acknowledgeEndOfCycle(rt);
+    this->recordPause(begin);
+}
+
+void GC::runCycle(Runtime *rt, GCCycleStats::Trigger trigger) {
+    ProfilerCAPTURE();
+    if (!this->enabled) {
+        return;
+    }
+    // finishes the current incremental cycle, or runs a whole new one without a budget
+    if (this->incremental) {
+        do {
+            this->runIncrementalStep(rt, INT64_MAX, trigger);
+        } while (this->phase != IDLE);
+        return;
+    }
+    this->finishSweep(rt);
+    auto begin          = std::chrono::steady_clock::now();
+    this->current_stats = {trigger, 0, 0, 0, 0};
+    this->freed_count   = 0;
+    this->freed_bytes   = 0;
+    // mark
+    if (this->mark_threads > 1) {
+        this->markParallel(rt);
+    }
+    else {
+        Marker marker(this->gc_mark);
+        this->markRoots(rt, [&marker](Object *obj) { marker.visit(obj); });
+        marker.drain();
+    }
+    Marker weak_marker(this->gc_mark);
+    this->processWeakInstances(
+        weak_marker, [&weak_marker] { return weak_marker.drain(); },
+        [this](Instance *ins) { return ins->gc_mark == this->gc_mark; });
+    if (this->take_census) {
+        this->takeCensus(rt);
+    }
+    this->current_stats.mark_time = getMicrosecondsSince(begin);
+    auto sweep_begin              = std::chrono::steady_clock::now();
+    // sweep
+    if (this->generational) {
+        // dead old objects may still be remembered, drop them before they get deleted
+        std::erase_if(this->remembered_objects, [this](Object *obj) { return obj->gc_mark != this->gc_mark; });
+        std::erase_if(this->remembered_instances, [this](Instance *ins) { return ins->gc_mark != this->gc_mark; });
+        std::erase_if(this->young_objects, [this](Object *obj) {
+            if (obj->gc_mark != this->gc_mark) {
+                this->freed_count++;
+                this->freed_bytes += sizeof(Object);
+                delete obj;
+                return true;
+            }
+            return false;
+        });
+        std::erase_if(this->young_instances, [this](Instance *ins) {
+            if (ins->gc_mark != this->gc_mark) {
+                this->freed_count++;
+                this->freed_bytes += ins->getSize();
+                delete ins;
+                return true;
+            }
+            return false;
+        });
+    }
+    sweepTable(this->tracked_types, this->gc_mark, this->freed_count, this->freed_bytes);
+    if (this->background_sweep && !this->generational) {
+        // the sweep gets the tables as they are now, the program gets empty ones to track new allocations in.
+        // Survivors and new allocations both carry the mark of this cycle once the mark of the gc is flipped,
+        // so the sweep compares against the mark it was started with
+        this->swept_objects.swap(this->tracked_objects);
+        this->swept_instances.swap(this->tracked_instances);
+        this->swept_slabs.takePages(this->slabs);
+        this->sweep_running = true;
+        this->sweep_done    = false;
+        this->sweep_thread = std::thread([this, mark = (bool)this->gc_mark] {
+            // the counters are only read by the program once the sweep has been joined
+            auto begin = std::chrono::steady_clock::now();
+            sweepTable(this->swept_objects, mark, this->freed_count, this->freed_bytes);
+            sweepTable(this->swept_instances, mark, this->freed_count, this->freed_bytes);
+            this->swept_slabs.sweep(mark, this->freed_count, this->freed_bytes);
+            this->background_sweep_time = getMicrosecondsSince(begin);
+            this->sweep_done            = true;
+        });
+        this->gc_mark                  = !this->gc_mark;
+        this->current_stats.sweep_time = getMicrosecondsSince(sweep_begin);
+        this->recordPause(begin);
+        return;
+    }
+    sweepTable(this->tracked_objects, this->gc_mark, this->freed_count, this->freed_bytes);
+    sweepTable(this->tracked_instances, this->gc_mark, this->freed_count, this->freed_bytes);
+    if (this->slab_tracking) {
+        this->slabs.sweep(this->gc_mark, this->freed_count, this->freed_bytes);
+    }
+
+    if (this->generational) {
+        this->old_bytes = this->tracked_objects.size() * sizeof(Object);
+        for (auto &[ins, _] : this->tracked_instances) {
+            this->old_bytes += ins->getSize();
+        }
+    }
+
+    this->gc_mark                  = !this->gc_mark;
+    this->current_stats.sweep_time = getMicrosecondsSince(sweep_begin);
+    this->finishCycle();
     this->gc_strategy->acknowledgeEndOfCycle(rt);
+    this->recordPause(begin);
     // fprintf(stderr, "GC CYCLE END\n");
 }
 
+void GC::runMinorCycle(Runtime *rt) {
+    ProfilerCAPTURE();
+    if (!this->enabled || !this->generational) {
+        return;
+    }
+    auto begin = std::chrono::steady_clock::now();
+    // mark. Types are never young, so they are treated as roots
+    YoungMarker marker(this->gc_mark);
+    this->markRoots(rt, [&marker](Object *obj) { marker.visit(obj); });
+    for (auto &[type, _] : this->tracked_types) {
+        type->trace(marker);
+    }
+    for (auto obj : this->remembered_objects) {
+        obj->trace(marker);
+    }
+    for (auto ins : this->remembered_instances) {
+        ins->trace(marker);
+    }
+    marker.drain();
+    // old instances always survive minor cycles
+    this->processWeakInstances(
+        marker, [&marker] { return marker.drain(); },
+        [this](Instance *ins) { return ins->gc_old || ins->gc_mark == this->gc_mark; });
+    GCCycleStats stats = {GCCycleStats::NURSERY, getMicrosecondsSince(begin), 0, 0, 0};
+    auto         sweep_begin = std::chrono::steady_clock::now();
+    // sweep. Survivors get unmarked right away, since the mark of the gc is not flipped by minor cycles
+    std::vector<Object *>   promoted_objects;
+    std::vector<Instance *> promoted_instances;
+    std::erase_if(this->young_objects, [&](Object *obj) {
+        if (obj->gc_mark != this->gc_mark) {
+            stats.freed_count++;
+            stats.freed_bytes += sizeof(Object);
+            delete obj;
+            return true;
+        }
+        obj->gc_mark = !this->gc_mark;
+        if (++obj->gc_age < PROMOTION_AGE) {
+            return false;
+        }
+        obj->gc_old                  = true;
+        this->tracked_objects[obj]   = true;
+        this->old_bytes             += sizeof(Object);
+        promoted_objects.push_back(obj);
+        return true;
+    });
+    std::erase_if(this->young_instances, [&](Instance *ins) {
+        if (ins->gc_mark != this->gc_mark) {
+            stats.freed_count++;
+            stats.freed_bytes += ins->getSize();
+            delete ins;
+            return true;
+        }
+        ins->gc_mark = !this->gc_mark;
+        if (++ins->gc_age < PROMOTION_AGE) {
+            return false;
+        }
+        ins->gc_old                  = true;
+        this->tracked_instances[ins] = true;
+        this->old_bytes             += ins->getSize();
+        promoted_instances.push_back(ins);
+        return true;
+    });
+    // only old objects that still reference young ones stay remembered
+    for (auto obj : promoted_objects) {
+        this->writeBarrier(obj);
+    }
+    for (auto ins : promoted_instances) {
+        this->writeBarrier(ins);
+    }
+    std::erase_if(this->remembered_objects, [](Object *obj) {
+        obj->gc_remembered = hasYoungReferences(obj);
+        return !obj->gc_remembered;
+    });
+    std::erase_if(this->remembered_instances, [](Instance *ins) {
+        ins->gc_remembered = hasYoungReferences(ins);
+        return !ins->gc_remembered;
+    });
+
+    stats.sweep_time  = getMicrosecondsSince(sweep_begin);
+    this->heap_bytes -= stats.freed_bytes;
+    this->cycle_stats.push_back(stats);
+    this->gc_strategy->acknowledgeEndOfMinorCycle(rt);
+    this->recordPause(begin);
+}
+
 void GC::enable() {
     ProfilerCAPTURE();
     this->enabled = true;
@@ -21,14 +21,99 @@
 
 #pragma once
 #include "../util.h"
+#include "slab.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace Cotton {
 class Object;
 class Instance;
+class WeakInstance;
 class Type;
 class Runtime;
 class GC;
 
+/**
+ * @brief Hash of the pointers in the tables of the gc. Objects allocated next to each other have regularly spaced
+ * addresses, which collide a lot once the table masks their low bits, so the bits get mixed first.
+ */
+class GCPointerHash {
+public:
+    size_t operator()(const void *ptr) const {
+        auto x  = (uint64_t)ptr;
+        x      ^= x >> 33;
+        x      *= 0xff51afd7ed558ccdull;
+        x      ^= x >> 33;
+        return x;
+    }
+};
+
+/// @brief Set of pointers tracked by the gc.
+template<typename T>
+using GCTable = __gnu_pbds::gp_hash_table<T *, bool, GCPointerHash>;
+
+/**
+ * @brief Receives the references of an object, instance or type while the gc traces it. See Object::trace,
+ * Instance::trace and Type::trace.
+ */
+class GCVisitor {
+public:
+    /**
+     * @brief Visits a reference to an object.
+     *
+     * @param object The object. May be nullptr.
+     */
+    virtual void visit(Object *object) = 0;
+
+    /**
+     * @brief Visits a reference to an instance.
+     *
+     * @param instance The instance. May be nullptr.
+     */
+    virtual void visit(Instance *instance) = 0;
+
+    /**
+     * @brief Visits a reference to a type.
+     *
+     * @param type The type. May be nullptr.
+     */
+    virtual void visit(Type *type) = 0;
+};
+
+/// @brief Statistics of a single gc cycle, see GC::cycle_stats.
+class GCCycleStats {
+public:
+    /// @brief What started the cycle.
+    enum Trigger : uint8_t {
+        EXPLICIT,          // runCycle was called directly, e.g. by the gc module
+        OBJECT_COUNT,      // the number of tracked objects, instances and types grew too much
+        HEAP_SIZE,         // the size of the heap grew too much
+        OPERATIONS,        // too many tracks since the counter was reset
+        HEAP_TARGET,       // the heap reached the growth target of GCPacingStrategy
+        OLD_GENERATION,    // the old generation grew too much
+        NURSERY,           // enough was allocated in the nursery, the cycle was a minor one
+        HEAP_LIMIT,        // the heap outgrew GC::max_heap_bytes
+    };
+
+    Trigger trigger;
+    int64_t mark_time;      // in microseconds
+    int64_t sweep_time;     // in microseconds, including the time spent by the background sweep
+    int64_t freed_count;    // number of objects, instances and types freed
+    int64_t freed_bytes;
+
+    /**
+     * @brief Returns a readable name of the trigger.
+     *
+     * @param trigger The trigger.
+     * @return const char*
+     */
+    static const char *getTriggerName(Trigger trigger);
+};
+
 /**
  *  @brief An abstract class representing a garbage collector strategy
  */
@@ -71,6 +156,14 @@ public:
       */
     virtual void acknowledgeUntrack(Type *type) = 0;
 
+    /**
+        @brief Acknowledges that a tracked instance changed its size, e.g. a string or an array grew its buffer.
+        This function is called by the gc.
+        \param instance The instance that got resized. Must be valid.
+        \param delta How many bytes the size of the instance changed by. Negative if it shrank.
+      */
+    virtual void acknowledgeResize(Instance *instance, int64_t delta);
+
     /**
         @brief Acknowledges the end of a gc cycle. This function is called by the gc.
         \param rt The runtime. Must be valid.
@@ -82,13 +175,46 @@ public:
         \param rt The runtime. Must be valid.
       */
     virtual void acknowledgePing(Runtime *rt) = 0;
+
+    /**
+        @brief Returns whether the gc should split the heap into generations. If so, new objects and instances are
+        put into the nursery, and the strategy may run minor cycles. Asked once, when the gc is constructed.
+      */
+    virtual bool usesGenerations();
+
+    /**
+        @brief Returns whether the gc runs its cycles incrementally, see GC::runIncrementalStep. If so, objects and
+        instances are tracked in lists that the sweep can take over at once. Asked once, when the gc is constructed.
+      */
+    virtual bool usesIncrementalMarking();
+
+    /**
+        @brief Acknowledges the end of a minor gc cycle. This function is called by the gc.
+        \param rt The runtime. Must be valid.
+      */
+    virtual void acknowledgeEndOfMinorCycle(Runtime *rt);
+
+    /**
+        @brief Asked on every ping while a background sweep is running, see GC::runCycle. If it returns `true`, the
+        gc waits for the sweep to finish before the ping goes on. Otherwise the ping does nothing, unless the sweep has
+        already finished. This function is called by the gc.
+        \param rt The runtime. Must be valid.
+      */
+    virtual bool waitsForSweep(Runtime *rt);
+
+    /**
+        @brief Returns how many bytes may be allocated between two pings that reach the strategy. Pings made before
+        that much gets allocated return right away, so the strategy isn't asked on every statement. 0 means that every
+        ping reaches the strategy. Asked once, when the gc is constructed.
+      */
+    virtual int64_t getCheckpointBytes();
 };
 
 /**
     @brief The default gc strategy.
  */
 class GCDefaultStrategy: public GCStrategy {
-private:
+protected:
     const int NUM_TRACKED_INIT = 1'000'000;    // prev_num_tracked is set to this at initialization
     const int NUM_TRACKED_MULT = 5;            // cycle runs when prev_num_tracked < num_tracked / 2;
     int64_t   num_tracked, prev_num_tracked;
@@ -151,6 +277,13 @@ public:
       */
     void acknowledgeUntrack(Type *type);
 
+    /**
+        @brief Acknowledges that a tracked instance changed its size. The change is added to the total size counter.
+        \param instance The instance that got resized. Must be valid.
+        \param delta How many bytes the size of the instance changed by.
+      */
+    void acknowledgeResize(Instance *instance, int64_t delta);
+
     /**
         @brief Acknowledges the end of a gc cycle. This function is called by the gc.
         \param rt The runtime. Must be valid.
@@ -169,6 +302,118 @@ public:
      * @return * void
      */
     void checkConditions(Runtime *rt);
+
+    /**
+        @brief Waits for the background sweep only once a new cycle is due, since it can't start before the sweep
+        finishes.
+        \param rt The runtime. Must be valid.
+      */
+    bool waitsForSweep(Runtime *rt);
+
+protected:
+    /// @brief Returns whether enough has been tracked since the previous cycle for a new one to start.
+    bool conditionsMet();
+
+    /// @brief Returns which of the conditions has been met. Must only be called if conditionsMet returns `true`.
+    GCCycleStats::Trigger getTrigger();
+};
+
+/**
+    @brief Strategy that starts cycles under the same conditions as the default one, but runs them incrementally:
+    every ping does at most GC::slice_budget units of work, see GC::runIncrementalStep.
+ */
+class GCIncrementalStrategy: public GCDefaultStrategy {
+public:
+    /// @brief Construct a new GCIncrementalStrategy object
+    GCIncrementalStrategy() = default;
+
+    ~GCIncrementalStrategy() = default;
+
+    /**
+        @brief Acknowledges the end of a gc cycle. Unlike the default strategy it doesn't walk the heap, since the
+        incremental sweep untracks everything it frees.
+        \param rt The runtime. Must be valid.
+      */
+    void acknowledgeEndOfCycle(Runtime *rt);
+
+    /**
+        @brief Acknowledges a gc ping event. Runs a slice of the current cycle, or starts a new one.
+        \param rt The runtime. Must be valid.
+      */
+    void acknowledgePing(Runtime *rt);
+
+    bool usesIncrementalMarking();
+};
+
+/**
+    @brief Strategy that splits the heap into a nursery and an old generation. Minor cycles run once enough has been
+    allocated since the previous one, major cycles run once the old generation outgrows its size after the previous
+    major cycle.
+ */
+class GCGenerationalStrategy: public GCStrategy {
+private:
+    const int64_t NURSERY_BYTES   = 4'000'000;     // a minor cycle runs after allocating that much
+    const int64_t MIN_MAJOR_BYTES = 16'000'000;    // old generation size that can trigger a major cycle
+    const int64_t OLD_GROWTH_MULT = 2;             // major cycle runs when the old generation grows that many times
+
+    int64_t allocated_bytes;     // since the previous minor cycle
+    int64_t next_major_bytes;    // old generation size that triggers the next major cycle
+
+public:
+    /// @brief Construct a new GCGenerationalStrategy object
+    GCGenerationalStrategy();
+
+    ~GCGenerationalStrategy() = default;
+
+    void acknowledgeTrack(Object *object);
+    void acknowledgeTrack(Instance *instance, size_t bytes);
+    void acknowledgeTrack(Type *type);
+    void acknowledgeUntrack(Object *object);
+    void acknowledgeUntrack(Instance *instance);
+    void acknowledgeUntrack(Type *type);
+    void acknowledgeResize(Instance *instance, int64_t delta);
+    void acknowledgeEndOfCycle(Runtime *rt);
+    void acknowledgeEndOfMinorCycle(Runtime *rt);
+    void acknowledgePing(Runtime *rt);
+    bool usesGenerations();
+};
+
+/**
+    @brief Strategy that paces cycles by a heap growth target: a cycle runs once the heap has grown by `target`
+    percent since the end of the previous one. The size of the heap is kept in running counters, which the cycles
+    correct by what they free, so the heap is never walked to measure it. The strategy is only asked once every
+    CHECKPOINT_BYTES of allocations.
+ */
+class GCPacingStrategy: public GCStrategy {
+private:
+    const int64_t MIN_HEAP_BYTES   = 4'000'000;    // no cycle runs before the heap grows that big
+    const int64_t CHECKPOINT_BYTES = 256 * 1024;
+
+    int64_t target;
+    int64_t heap_bytes;          // size of the heap, including what is dead but not freed yet
+    int64_t next_cycle_bytes;    // size of the heap that triggers the next cycle
+
+public:
+    /**
+     * @brief Construct a new GCPacingStrategy object
+     *
+     * @param target How many percent the heap may grow by between two cycles. Must be positive.
+     */
+    GCPacingStrategy(int64_t target);
+
+    ~GCPacingStrategy() = default;
+
+    void    acknowledgeTrack(Object *object);
+    void    acknowledgeTrack(Instance *instance, size_t bytes);
+    void    acknowledgeTrack(Type *type);
+    void    acknowledgeUntrack(Object *object);
+    void    acknowledgeUntrack(Instance *instance);
+    void    acknowledgeUntrack(Type *type);
+    void    acknowledgeResize(Instance *instance, int64_t delta);
+    void    acknowledgeEndOfCycle(Runtime *rt);
+    void    acknowledgePing(Runtime *rt);
+    bool    waitsForSweep(Runtime *rt);
+    int64_t getCheckpointBytes();
 };
 
 /**
@@ -177,12 +422,132 @@ public:
  */
 class GC {
 public:
-    Runtime                                     *rt;
-    __gnu_pbds::gp_hash_table<Object *, bool>    tracked_objects;
-    __gnu_pbds::gp_hash_table<Object *, int64_t> held_objects;
+    Runtime        *rt;
+    GCTable<Object> tracked_objects;
+
+    /// @brief Shadow stack of root slots, pushed and popped in LIFO order. nullptr slots are skipped.
+    std::vector<Object *> roots;
+
+    /// @brief Objects kept alive by hold. An object appears once per hold that hasn't been released yet.
+    std::vector<Object *> held_objects;
+
+    /// @brief Every weak instance that is alive, see WeakInstance. Once marking is done, they get to mark what
+    /// their weak references keep alive, and then clear the weak references to what is dead.
+    std::vector<WeakInstance *> weak_instances;
+
+    /// @brief Whether the heap is split into generations, see GCStrategy::usesGenerations. If so, tracked_objects and
+    /// tracked_instances only hold the old generation.
+    bool generational;
+
+    /// @brief Objects and instances of the young generation, in the order of allocation.
+    std::vector<Object *>   young_objects;
+    std::vector<Instance *> young_instances;
+
+    /// @brief Old objects and instances that may reference young ones. Traced by minor cycles along with the roots.
+    std::vector<Object *>   remembered_objects;
+    std::vector<Instance *> remembered_instances;
+
+    /// @brief Young objects and instances get promoted after surviving that many minor cycles.
+    static const uint8_t PROMOTION_AGE = 2;
+
+    /// @brief Size of the old generation in bytes.
+    int64_t old_bytes;
+
+    /// @brief Whether cycles run incrementally, see GCStrategy::usesIncrementalMarking. If so, tracked_objects and
+    /// tracked_instances stay empty, and objects and instances are tracked in the lists below instead.
+    bool                    incremental;
+    std::vector<Object *>   incremental_objects;
+    std::vector<Instance *> incremental_instances;
+
+    /// @brief Phase of the incremental cycle, see runIncrementalStep.
+    enum IncrementalPhase {
+        IDLE,
+        MARKING,
+        SWEEPING,
+    };
+
+    IncrementalPhase phase;
+
+    /// @brief Units of work done by one incremental step. Tracing a reference and sweeping an object or an instance
+    /// are a unit each.
+    int64_t slice_budget;
 
-    __gnu_pbds::gp_hash_table<Instance *, bool> tracked_instances;
-    __gnu_pbds::gp_hash_table<Type *, bool>     tracked_types;
+    /// @brief Marked objects, instances and types whose references haven't been traced yet.
+    std::vector<Object *>   gray_objects;
+    std::vector<Instance *> gray_instances;
+    std::vector<Type *>     gray_types;
+
+    /// @brief What was tracked when marking finished and hasn't been swept yet. Allocations made while sweeping
+    /// don't get here, so they are never swept by the current cycle.
+    std::vector<Object *>   sweeping_objects;
+    std::vector<Instance *> sweeping_instances;
+
+    /// @brief Mark of everything that survived the marking being swept.
+    bool sweep_mark;
+
+    /// @brief Number and size in bytes of the objects, instances and types freed by the last full cycle. Only
+    /// final once the cycle has finished sweeping, see GCStrategy::acknowledgeEndOfCycle.
+    int64_t freed_count;
+    int64_t freed_bytes;
+
+    /// @brief Size in bytes of everything tracked, including what is dead but not freed yet. Sizes of instances
+    /// follow their buffers as they grow, see GCResizeGuard.
+    int64_t heap_bytes;
+
+    /// @brief Once heap_bytes outgrows this, the next ping runs a full cycle, and signals an error if the heap is
+    /// still too big after it. 0 means that there is no limit.
+    int64_t max_heap_bytes;
+
+    /// @brief See GCStrategy::getCheckpointBytes.
+    int64_t checkpoint_bytes;
+    int64_t checkpoint_budget;    // bytes left to allocate until the next ping reaches the strategy
+
+    /// @brief Number of threads that mark during full cycles.
+    int64_t mark_threads;
+
+    /// @brief Whether full cycles leave freeing the dead objects and instances to a background thread. Has no effect
+    /// if the heap is split into generations or collected incrementally, as those sweep on their own.
+    bool background_sweep;
+
+    /// @brief Where objects and the fixed size instances are allocated, see SlabInstance.
+    SlabHeap slabs;
+
+    /// @brief Whether what is allocated in the slabs is tracked by the slab pages alone, and swept by scanning them.
+    /// Only if the heap is neither split into generations nor collected incrementally, since those track
+    /// everything in their lists.
+    bool slab_tracking;
+
+    /// @brief Objects and instances taken over by the running background sweep. Until it finishes, tracked_objects,
+    /// tracked_instances and slabs only hold what has been allocated since the sweep started.
+    GCTable<Object>   swept_objects;
+    GCTable<Instance> swept_instances;
+    SlabHeap          swept_slabs;
+
+    std::thread       sweep_thread;
+    bool              sweep_running;    // whether sweep_thread has been started and not joined yet
+    std::atomic<bool> sweep_done;       // set by sweep_thread once it is done
+
+    /// @brief Statistics of every cycle that has finished, in order. A cycle whose sweep still runs in the background
+    /// isn't here yet.
+    std::vector<GCCycleStats> cycle_stats;
+
+    /// @brief Whether full cycles take a census of what survived them, see live_types. The census walks the whole
+    /// heap, so it is off by default.
+    bool take_census;
+
+    /// @brief Number of live objects by the name of their type, as counted by the last census. Sorted by the number,
+    /// largest first.
+    std::vector<std::pair<std::string, int64_t>> live_types;
+
+    /// @brief Number of gc pauses by duration. Bucket i counts pauses shorter than PAUSE_BUCKET_LIMITS[i]
+    /// microseconds, the last bucket counts all the longer ones.
+    static constexpr int     PAUSE_BUCKETS                          = 6;
+    static constexpr int64_t PAUSE_BUCKET_LIMITS[PAUSE_BUCKETS - 1] = {10, 100, 1'000, 10'000, 100'000};
+    std::vector<int64_t>     pause_histogram;
+    int64_t                  max_pause;    // in microseconds
+
+    GCTable<Instance> tracked_instances;
+    GCTable<Type>     tracked_types;
 
     bool        gc_mark : 1;
     GCStrategy *gc_strategy;
@@ -245,7 +610,40 @@ public:
     void untrack(Type *type);
 
     /**
-     * @brief Holds the given object. The gc will consider it as reachable even if it is not.
+     * @brief Reports that a tracked instance changed its size, see Instance::getSize. Prefer GCResizeGuard.
+     *
+     * @param instance Must be valid.
+     * @param delta How many bytes the size of the instance changed by. Negative if it shrank.
+     */
+    void trackResize(Instance *instance, int64_t delta);
+
+    /**
+     * @brief Pushes a root slot holding the given object. The gc will consider it as reachable until the slot is
+     * popped.
+     *
+     * @param object The object. May be nullptr.
+     * @return Index of the slot, to be passed to setRoot and popRoots.
+     */
+    size_t pushRoot(Object *object);
+
+    /**
+     * @brief Replaces the object in the given root slot.
+     *
+     * @param index Index of the slot.
+     * @param object The object. May be nullptr.
+     */
+    void setRoot(size_t index, Object *object);
+
+    /**
+     * @brief Pops the root slot with the given index and every slot that was pushed after it.
+     *
+     * @param index Index of the slot.
+     */
+    void popRoots(size_t index);
+
+    /**
+     * @brief Holds the given object. The gc will consider it as reachable even if it is not. Unlike root slots,
+     * holds can be released in any order, but they are slower. Prefer pushRoot or GCRootGuard.
      *
      * @param object Must be valid.
      */
@@ -259,18 +657,78 @@ public:
     void release(Object *object);
 
     /**
-     * @brief Pings the gc. If the strategy's conditions are met, a gc cycle will be ran.
+     * @brief Must be called after the object starts referencing another instance or type, so that minor cycles
+     * notice references from the old generation to the young one.
+     *
+     * @param object Must be valid.
+     */
+    void writeBarrier(Object *object);
+
+    /**
+     * @brief Must be called after the instance starts referencing another object, so that minor cycles notice
+     * references from the old generation to the young one.
+     *
+     * @param instance Must be valid.
+     */
+    void writeBarrier(Instance *instance);
+
+    /**
+     * @brief Pings the gc. If the strategy's conditions are met, a gc cycle will be ran. Does nothing until enough
+     * has been allocated if the strategy uses checkpoints, see GCStrategy::getCheckpointBytes. The heap limit is
+     * checked on every ping, see max_heap_bytes.
      *
      * @param rt The runtime. Must be valid.
      */
     void ping(Runtime *rt);
 
     /**
-     * @brief Runs a gc cycle.
+     * @brief Runs a gc cycle. With background_sweep, the dead objects and instances are left to a background thread,
+     * which frees them while the program goes on. Types are always swept right away.
      *
      * @param rt The runtime. Must be valid.
+     * @param trigger What started the cycle, see cycle_stats.
      */
-    void runCycle(Runtime *rt);
+    void runCycle(Runtime *rt, GCCycleStats::Trigger trigger = GCCycleStats::EXPLICIT);
+
+    /**
+     * @brief Runs a single slice of an incremental gc cycle, starting a new cycle if none is running.
+     *
+     * Marking is tri-color: white objects haven't been reached yet, gray ones are marked but wait in the gray lists
+     * to be traced, black ones are marked and traced. The roots are shaded when the cycle starts. Write barriers put
+     * black containers that gain references back into the gray lists, and once the gray lists run out the roots are
+     * shaded again and the rest of the marking is done in one go. Sweeping is lazy and also done in slices.
+     *
+     * @param rt The runtime. Must be valid.
+     * @param budget Units of work the slice may do.
+     * @param trigger What started the cycle, see cycle_stats. Only used if the slice starts a new cycle.
+     */
+    void runIncrementalStep(Runtime *rt, int64_t budget, GCCycleStats::Trigger trigger = GCCycleStats::EXPLICIT);
+
+    /// @brief Returns whether an incremental cycle is running.
+    bool isCollecting();
+
+    /**
+     * @brief Waits for the background sweep to finish, and takes back what it has swept. Does nothing if no
+     * background sweep is running.
+     *
+     * @param rt The runtime. Must be valid.
+     */
+    void finishSweep(Runtime *rt);
+
+    /**
+     * @brief Adds a pause that started at `begin` and ends now to the pause histogram.
+     *
+     * @param begin When the pause started.
+     */
+    void recordPause(std::chrono::steady_clock::time_point begin);
+
+    /**
+     * @brief Runs a minor gc cycle, which only collects the young generation. Does nothing if the heap is not split
+     * into generations.
+     *
+     * @param rt The runtime. Must be valid.
+     */
+    void runMinorCycle(Runtime *rt);
 
     /**
      * @brief Enables the gc.
@@ -283,5 +741,120 @@ public:
      *
      */
     void disable();
+
+    /**
+     * @brief Calls `mark` on every root: the variables of the scopes, the root slots, held objects, globals, and
+     * whatever is on the argument stack or the stack of the VM.
+     *
+     * @param rt The runtime. Must be valid.
+     * @param mark The function.
+     */
+    void markRoots(Runtime *rt, const std::function<void(Object *)> &mark);
+
+private:
+
+    /// @brief Marks everything reachable from the roots using mark_threads threads, see runCycle.
+    void markParallel(Runtime *rt);
+
+    /// @brief Traces gray objects, instances and types until the lists run out or `budget` units are done.
+    /// Returns the units left.
+    int64_t traceGray(Runtime *rt, int64_t budget);
+
+    /// @brief Sweeps until everything is swept or `budget` units are done. Returns `true` if everything is swept.
+    bool sweepSlice(int64_t budget);
+
+    /**
+     * @brief Lets the weak instances pass what their live weak references keep alive to the visitor, and calls
+     * `drain` to trace it, until `drain` returns `false`. Then forgets the dead weak instances, and has the rest
+     * clear their weak references to what is dead. Must be called after marking and before sweeping.
+     *
+     * @param visitor Marks what it visits.
+     * @param drain Traces what the visitor has marked. Returns `false` if there was nothing to trace.
+     * @param is_live Returns whether an instance survives the cycle.
+     */
+    void processWeakInstances(GCVisitor &visitor, const std::function<bool()> &drain,
+                              const std::function<bool(Instance *)> &is_live);
+
+    /// @brief Adds current_stats to cycle_stats, along with what the cycle has freed, and takes that off heap_bytes.
+    void finishCycle();
+
+    /// @brief Runs a full cycle because the heap outgrew max_heap_bytes, and signals an error if it still does.
+    void enforceHeapLimit(Runtime *rt);
+
+    /// @brief Fills live_types with the objects marked with gc_mark. Must be called after marking and before sweeping.
+    void takeCensus(Runtime *rt);
+
+    /// @brief Stats of the cycle that is running, or whose sweep runs in the background.
+    GCCycleStats current_stats;
+
+    /// @brief Time spent by the background sweep, in microseconds. Only read once the sweep has been joined.
+    int64_t background_sweep_time;
+};
+
+/**
+ * @brief Keeps an object reachable for the gc for as long as the guard lives, using a root slot. Guards must be
+ * destroyed in the reverse order of creation, which is what happens to local variables.
+ *
+ * @code
+ * GCRootGuard guard(rt->getGC(), obj);
+ * @endcode
+ */
+class GCRootGuard {
+private:
+    GC    *gc;
+    size_t index;
+
+public:
+    /**
+     * @brief Construct a new GCRootGuard object
+     *
+     * @param gc The gc. Must be valid.
+     * @param object The object to keep reachable. May be nullptr.
+     */
+    GCRootGuard(GC *gc, Object *object = nullptr);
+
+    GCRootGuard(const GCRootGuard &)            = delete;
+    GCRootGuard &operator=(const GCRootGuard &) = delete;
+
+    /// @brief Pops the root slot of the guard.
+    ~GCRootGuard();
+
+    /**
+     * @brief Makes the guard keep another object reachable instead.
+     *
+     * @param object The object. May be nullptr.
+     */
+    void set(Object *object);
+};
+
+/**
+ * @brief Reports the change in size of an instance to the gc once the guard is destroyed. Create one before
+ * growing or shrinking the buffers of a tracked instance, so that Instance::getSize is accounted for.
+ *
+ * @code
+ * GCResizeGuard guard(rt->getGC(), self->instance);
+ * getArrayDataFast(self).push_back(obj);
+ * @endcode
+ */
+class GCResizeGuard {
+private:
+    GC       *gc;
+    Instance *instance;
+    int64_t   bytes;    // size of the instance when the guard was created
+
+public:
+    /**
+     * @brief Construct a new GCResizeGuard object
+     *
+     * @param gc The gc. Must be valid.
+     * @param instance The instance that may get resized. Must be valid and tracked.
+     */
+    GCResizeGuard(GC *gc, Instance *instance);
+
+    GCResizeGuard(const GCResizeGuard &)            = delete;
+    GCResizeGuard &operator=(const GCResizeGuard &) = delete;
+
+    /// @brief Reports the change in size of the instance, if there was any.
+    ~GCResizeGuard();
 };
 }    // namespace Cotton
@@ -0,0 +1,271 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "heapsnapshot.h"
+#include "../profiler.h"
+#include "gc.h"
+#include "instance.h"
+#include "object.h"
+#include "runtime.h"
+#include "type.h"
+#include <algorithm>
+#include <cstdio>
+#include <unordered_map>
+
+namespace Cotton {
+namespace {
+// adds the references it visits to the snapshot as edges of the node being traced, and new nodes for what hasn't
+// been reached before
+class SnapshotBuilder: public GCVisitor {
+private:
+    HeapSnapshot                       &snapshot;
+    std::unordered_map<void *, int64_t> ids;
+
+    void add(HeapSnapshot::Kind kind, void *ptr, Type *type, int64_t shallow) {
+        auto [it, inserted] = this->ids.try_emplace(ptr, (int64_t)this->snapshot.nodes.size());
+        if (inserted) {
+            this->snapshot.nodes.push_back({kind, ptr, type, shallow, 0, -1});
+        }
+        this->snapshot.edges.push_back(it->second);
+    }
+
+public:
+    Type *owner_type = nullptr;    // type of the object being traced
+
+    SnapshotBuilder(HeapSnapshot &snapshot)
+        : snapshot(snapshot) {}
+
+    void visit(Object *object) {
+        if (object != nullptr) {
+            this->add(HeapSnapshot::OBJECT, object, object->type, sizeof(Object));
+        }
+    }
+
+    void visit(Instance *instance) {
+        if (instance != nullptr) {
+            this->add(HeapSnapshot::INSTANCE, instance, this->owner_type, instance->getSize());
+        }
+    }
+
+    void visit(Type *type) {
+        if (type != nullptr) {
+            this->add(HeapSnapshot::TYPE, type, type, sizeof(Type));
+        }
+    }
+};
+}    // namespace
+
+HeapSnapshot::HeapSnapshot(Runtime *rt) {
+    ProfilerCAPTURE();
+    auto gc = rt->getGC();
+    gc->finishSweep(rt);
+
+    // the nodes are traced in the order they are added, so the references of every node end up next to each other
+    SnapshotBuilder builder(*this);
+    this->nodes.push_back({ROOT, nullptr, nullptr, 0, 0, 0});
+    this->edges_begin.push_back(0);
+    gc->markRoots(rt, [&builder](Object *obj) { builder.visit(obj); });
+    for (size_t i = 1; i < this->nodes.size(); i++) {
+        this->edges_begin.push_back(this->edges.size());
+        auto node = this->nodes[i];    // copied, tracing adds nodes
+        switch (node.kind) {
+        case OBJECT :
+            builder.owner_type = node.type;
+            ((Object *)node.ptr)->trace(builder);
+            break;
+        case INSTANCE : ((Instance *)node.ptr)->trace(builder); break;
+        case TYPE     : ((Type *)node.ptr)->trace(builder); break;
+        case ROOT     : break;
+        }
+    }
+    this->edges_begin.push_back(this->edges.size());
+
+    this->computeDominators();
+    this->computeRetainedSizes();
+}
+
+void HeapSnapshot::computeDominators() {
+    ProfilerCAPTURE();
+    // Lengauer-Tarjan, working on the preorder numbers of a depth first search. The simpler iterative algorithms
+    // are quadratic on long chains whose links share a referent, e.g. their type, and those are common in heaps
+    int64_t n = this->nodes.size();
+
+    // preorder and the parents in the search tree, with an explicit stack since the graph can be as deep as the
+    // longest chain in the heap
+    std::vector<int64_t> number(n, -1);
+    std::vector<int64_t> parent(n, -1);    // by number
+    std::vector<int64_t> next_edge(this->edges_begin.begin(), this->edges_begin.end() - 1);
+    std::vector<int64_t> stack = {0};
+
+    number[0]   = 0;
+    this->order = {0};
+    while (!stack.empty()) {
+        auto node = stack.back();
+        if (next_edge[node] == this->edges_begin[node + 1]) {
+            stack.pop_back();
+            continue;
+        }
+        auto next = this->edges[next_edge[node]++];
+        if (number[next] == -1) {
+            number[next]         = this->order.size();
+            parent[number[next]] = number[node];
+            this->order.push_back(next);
+            stack.push_back(next);
+        }
+    }
+
+    // referrers of every node, by number
+    std::vector<int64_t> preds_begin(n + 1, 0);
+    for (auto to : this->edges) {
+        preds_begin[number[to] + 1]++;
+    }
+    for (int64_t i = 0; i < n; i++) {
+        preds_begin[i + 1] += preds_begin[i];
+    }
+    std::vector<int64_t> preds(this->edges.size());
+    std::vector<int64_t> filled(preds_begin.begin(), preds_begin.end() - 1);
+    for (int64_t from = 0; from < n; from++) {
+        for (auto e = this->edges_begin[from]; e < this->edges_begin[from + 1]; e++) {
+            preds[filled[number[this->edges[e]]]++] = number[from];
+        }
+    }
+
+    std::vector<int64_t> semi(n), label(n), ancestor(n, -1), dominator(n, 0);
+    std::vector<int64_t> bucket_head(n, -1), bucket_next(n, -1);
+    for (int64_t v = 0; v < n; v++) {
+        semi[v]  = v;
+        label[v] = v;
+    }
+    // returns the node with the smallest semidominator on the path from v up to the root of its tree in the forest,
+    // compressing the path on the way
+    std::vector<int64_t> path;
+
+    auto eval = [&](int64_t v) {
+        if (ancestor[v] == -1) {
+            return v;
+        }
+        path.clear();
+        for (auto x = v; ancestor[ancestor[x]] != -1; x = ancestor[x]) {
+            path.push_back(x);
+        }
+        for (size_t i = path.size(); i-- > 0;) {
+            auto x = path[i];
+            if (semi[label[ancestor[x]]] < semi[label[x]]) {
+                label[x] = label[ancestor[x]];
+            }
+            ancestor[x] = ancestor[ancestor[x]];
+        }
+        return label[v];
+    };
+    for (int64_t w = n - 1; w > 0; w--) {
+        for (auto p = preds_begin[w]; p < preds_begin[w + 1]; p++) {
+            auto u = eval(preds[p]);
+            if (semi[u] < semi[w]) {
+                semi[w] = semi[u];
+            }
+        }
+        bucket_next[w]       = bucket_head[semi[w]];
+        bucket_head[semi[w]] = w;
+        ancestor[w]          = parent[w];
+        for (auto v = bucket_head[parent[w]]; v != -1; v = bucket_next[v]) {
+            auto u       = eval(v);
+            dominator[v] = semi[u] < semi[v] ? u : parent[w];
+        }
+        bucket_head[parent[w]] = -1;
+    }
+    for (int64_t w = 1; w < n; w++) {
+        if (dominator[w] != semi[w]) {
+            dominator[w] = dominator[dominator[w]];
+        }
+    }
+
+    for (int64_t w = 0; w < n; w++) {
+        this->nodes[this->order[w]].dominator = this->order[dominator[w]];
+    }
+}
+
+void HeapSnapshot::computeRetainedSizes() {
+    ProfilerCAPTURE();
+    for (auto &node : this->nodes) {
+        node.retained = node.shallow;
+    }
+    // dominators are ancestors in the search tree, so they come before the nodes they dominate in preorder
+    for (size_t i = this->order.size(); i-- > 1;) {
+        auto &node                             = this->nodes[this->order[i]];
+        this->nodes[node.dominator].retained += node.retained;
+    }
+}
+
+static void writeJSONString(FILE *file, const std::string &str) {
+    fputc('"', file);
+    for (auto c : str) {
+        if (c == '"' || c == '\\') {
+            fputc('\\', file);
+            fputc(c, file);
+        }
+        else if ((unsigned char)c < 0x20) {
+            fprintf(file, "\\u%04x", (unsigned char)c);
+        }
+        else {
+            fputc(c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+bool HeapSnapshot::write(const std::string &path, Runtime *rt) {
+    ProfilerCAPTURE();
+    FILE *file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    static const char *KIND_NAMES[] = {"root", "object", "instance", "type"};
+
+    // type names are looked up once per type
+    std::unordered_map<Type *, std::string> names;
+
+    auto getName = [&](Type *type) -> const std::string & {
+        auto [it, inserted] = names.try_emplace(type);
+        if (inserted) {
+            it->second = type != nullptr ? type->userRepr(rt) : "";
+        }
+        return it->second;
+    };
+
+    fprintf(file, "{\n\"node_fields\": [\"kind\", \"name\", \"shallow_size\", \"retained_size\", \"dominator\", ");
+    fprintf(file, "\"references\"],\n\"nodes\": [\n");
+    for (size_t i = 0; i < this->nodes.size(); i++) {
+        auto &node = this->nodes[i];
+        fprintf(file, "[\"%s\", ", KIND_NAMES[node.kind]);
+        writeJSONString(file, node.kind == ROOT ? "(roots)" : getName(node.type));
+        fprintf(file, ", %ld, %ld, %ld, [", node.shallow, node.retained, node.dominator);
+        for (auto e = this->edges_begin[i]; e < this->edges_begin[i + 1]; e++) {
+            fprintf(file, e == this->edges_begin[i] ? "%ld" : ", %ld", this->edges[e]);
+        }
+        fprintf(file, i + 1 < this->nodes.size() ? "]],\n" : "]]\n");
+    }
+    fprintf(file, "]\n}\n");
+
+    bool ok = !ferror(file);
+    return fclose(file) == 0 && ok;
+}
+}    // namespace Cotton
@@ -0,0 +1,87 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Cotton {
+class Runtime;
+class Type;
+
+/**
+ * @brief A snapshot of everything reachable from the roots of the gc. Every object, instance and type is a node of
+ * the snapshot, and references between them are its edges. Along with its own size, every node gets its retained
+ * size: the bytes that would be freed if it became unreachable. Retained sizes are computed from the dominator tree
+ * of the graph, a node retains everything it dominates.
+ */
+class HeapSnapshot {
+public:
+    enum Kind : uint8_t {
+        ROOT,    // the node referencing all of the roots, always the first one
+        OBJECT,
+        INSTANCE,
+        TYPE,
+    };
+
+    class Node {
+    public:
+        Kind    kind;
+        void   *ptr;
+        Type   *type;         // type of the object, of the object the instance was first reached from, or the type
+        int64_t shallow;      // own size in bytes, as counted by the gc
+        int64_t retained;     // size in bytes of everything the node dominates, including itself
+        int64_t dominator;    // index of the immediate dominator. The root dominates itself
+    };
+
+    /// @brief Nodes in the order they were reached in, breadth first from the roots.
+    std::vector<Node> nodes;
+
+    /// @brief References of node i are edges[edges_begin[i]] up to edges[edges_begin[i + 1]], as node indices.
+    std::vector<int64_t> edges_begin;
+    std::vector<int64_t> edges;
+
+    /**
+     * @brief Takes a snapshot of the heap. Waits for the background sweep first. Doesn't allocate anything in the heap,
+     * so it can't trigger a gc cycle.
+     *
+     * @param rt The runtime. Must be valid.
+     */
+    HeapSnapshot(Runtime *rt);
+
+    /**
+     * @brief Writes the snapshot to a file as JSON. tools/heap_summary.py reads it and prints what retains the most.
+     *
+     * @param path Path of the file.
+     * @param rt The runtime. Must be valid.
+     * @return `false` if the file couldn't be written.
+     */
+    bool write(const std::string &path, Runtime *rt);
+
+private:
+    void computeDominators();
+    void computeRetainedSizes();
+
+    std::vector<int64_t> order;    // node indices in preorder of a depth first search from the root
+};
+}    // namespace Cotton
@@ -0,0 +1,109 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "inline_cache.h"
+#include "../profiler.h"
+#include "instance.h"
+#include "object.h"
+#include "runtime.h"
+#include "type.h"
+
+namespace Cotton {
+InlineCache::InlineCache() {
+    ProfilerCAPTURE();
+    this->size        = 0;
+    this->megamorphic = false;
+}
+
+InlineCache *InlineCache::of(OperatorNode *node, Runtime *rt) {
+    ProfilerCAPTURE();
+    if (node->cache_index == -1) {
+        node->cache_index = rt->inline_caches.size();
+        rt->inline_caches.emplace_back();
+    }
+    return &rt->inline_caches[node->cache_index];
+}
+
+Object *InlineCache::select(Object *self, NameId selector, Runtime *rt) {
+    ProfilerCAPTURE();
+    auto    type  = self->type;
+    int64_t stale = -1;
+    for (int64_t i = 0; i < this->size; i++) {
+        auto &entry = this->entries[i];
+        if (entry.type_id != type->id) {
+            continue;
+        }
+        if (entry.version != type->version) {
+            stale = i;
+            break;
+        }
+        if (entry.slot == -1) {
+            rt->ic_stats.hits++;
+            return entry.method;
+        }
+        auto res = self->instance->selectFieldSlot(entry.slot);
+        if (res != nullptr) {
+            rt->ic_stats.hits++;
+            return res;
+        }
+        stale = i;
+        break;
+    }
+
+    if (this->megamorphic) {
+        rt->ic_stats.megamorphic++;
+    }
+    else {
+        rt->ic_stats.misses++;
+    }
+
+    Entry   entry = {type->id, type->version, -1, nullptr};
+    Object *res;
+    if (self->instance->hasField(selector, rt)) {
+        res        = self->instance->selectField(selector, rt);
+        entry.slot = type->getFieldSlot(selector);
+        if (entry.slot == -1) {
+            return res;    // the type doesn't describe where its fields are
+        }
+    }
+    else if (type->hasMethod(selector)) {
+        res          = type->getMethod(selector, rt);
+        entry.method = res;
+        if (type->has_extra_fields) {
+            return res;    // other instances may have a field with that name
+        }
+    }
+    else {
+        return nullptr;
+    }
+
+    if (stale != -1) {
+        this->entries[stale] = entry;
+    }
+    else if (this->size < MAX_ENTRIES) {
+        this->entries[this->size++] = entry;
+    }
+    else {
+        this->megamorphic = true;
+    }
+    return res;
+}
+}    // namespace Cotton
@@ -0,0 +1,75 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "../front/parser.h"
+#include "nameid.h"
+#include <cstdint>
+
+namespace Cotton {
+class Object;
+class Runtime;
+
+/**
+ * @brief Cache of a single selector site (`a.b` or `a.b(...)`). Remembers where the selector was found for up to
+ * MAX_ENTRIES types, after that the site is considered megamorphic and new types are no longer cached.
+ */
+class InlineCache {
+public:
+    static const int MAX_ENTRIES = 4;
+
+    class Entry {
+    public:
+        int64_t type_id;    // Type::id, unlike Type pointers ids are never reused
+        int64_t version;    // Type::version at the moment of caching
+        int64_t slot;       // field slot, -1 if the selector is a method
+        Object *method;
+    };
+
+    Entry   entries[MAX_ENTRIES];
+    int64_t size;
+    bool    megamorphic;
+
+    /// @brief Construct a new empty InlineCache object
+    InlineCache();
+
+    /**
+     * @brief Returns the cache of the given DOT operator, creating it on the first request. The cache is owned by the
+     * runtime, the operator only keeps its index.
+     *
+     * @param node The DOT operator. Must be valid.
+     * @param rt The runtime. Must be valid.
+     * @return InlineCache*
+     */
+    static InlineCache *of(OperatorNode *node, Runtime *rt);
+
+    /**
+     * @brief Selects the field or the method of an instance object, the same way the DOT operator does.
+     *
+     * @param self The object. Must be a valid instance object.
+     * @param selector Nameid of the field or the method.
+     * @param rt The runtime. Must be valid.
+     * @return The selected object, or nullptr if the object has neither a field nor a method with that name.
+     */
+    Object *select(Object *self, NameId selector, Runtime *rt);
+};
+}    // namespace Cotton
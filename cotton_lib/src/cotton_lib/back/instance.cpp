@@ -43,16 +43,55 @@ void Instance::addField(NameId id, Object *obj, Runtime *rt) {
     ProfilerCAPTURE();
 }
 
-Instance::Instance(Runtime *rt, size_t bytes) {
+Object *Instance::selectFieldSlot(int64_t slot) {
     ProfilerCAPTURE();
-    this->gc_mark = !rt->getGC()->gc_mark;
-    this->id      = ++total_instances;
+    return nullptr;
+}
+
+Instance::Instance(Runtime *rt, size_t bytes)
+    : Instance(rt, bytes, false) {
+    ProfilerCAPTURE();
+}
+
+Instance::Instance(Runtime *rt, size_t bytes, bool gc_slab) {
+    ProfilerCAPTURE();
+    this->gc_mark       = !rt->getGC()->gc_mark;
+    this->gc_old        = false;
+    this->gc_remembered = false;
+    this->gc_gray       = false;
+    this->gc_age        = 0;
+    this->gc_slab       = gc_slab;
+    this->id            = ++total_instances;
     rt->getGC()->track(this, bytes);
 }
 
-std::vector<Object *> Instance::getGCReachable() {
+SlabInstance::SlabInstance(Runtime *rt, size_t bytes)
+    : Instance(rt, bytes, true) {
+    ProfilerCAPTURE();
+}
+
+void *SlabInstance::operator new(size_t bytes, Runtime *rt) {
+    ProfilerCAPTURE();
+    return rt->getGC()->slabs.allocateInstance(bytes);
+}
+
+void SlabInstance::operator delete(void *ptr) {
+    ProfilerCAPTURE();
+    SlabPage::of(ptr)->allocator->free(ptr);
+}
+
+WeakInstance::WeakInstance(Runtime *rt, size_t bytes)
+    : Instance(rt, bytes) {
+    ProfilerCAPTURE();
+    rt->getGC()->weak_instances.push_back(this);
+}
+
+void WeakInstance::traceEphemerons(GCVisitor &visitor, const std::function<bool(Instance *)> &is_live) {
+    ProfilerCAPTURE();
+}
+
+void Instance::trace(GCVisitor &visitor) {
     ProfilerCAPTURE();
-    return {};
 }
 
 void Instance::spreadSingleUse() {
@@ -22,11 +22,14 @@
 #pragma once
 #include "../util.h"
 #include "nameid.h"
+#include <atomic>
+#include <functional>
 
 namespace Cotton {
 
 class Runtime;
 class Object;
+class GCVisitor;
 
 /**
  * @brief Class representing an instance of a type.
@@ -35,11 +38,21 @@ class Object;
 class Instance {
 public:
     /// @brief The total number of instances created.
-    static int64_t total_instances;
+    static int64_t    total_instances;
     /// @brief id of the instance
-    int64_t        id;
-    /// @brief gc mark of the instance
-    bool           gc_mark : 1;
+    int64_t           id;
+    /// @brief gc mark of the instance, atomic because of parallel marking
+    std::atomic<bool> gc_mark;
+    /// @brief `true` if the instance belongs to the old generation, see GCStrategy::usesGenerations
+    bool              gc_old : 1;
+    /// @brief `true` if the instance is in the remembered set of the gc
+    bool              gc_remembered : 1;
+    /// @brief `true` if the instance waits in the gray list of an incremental gc cycle
+    bool              gc_gray : 1;
+    /// @brief number of minor gc cycles the instance has survived while young
+    uint8_t           gc_age;
+    /// @brief `true` if the instance is allocated in the slabs of the gc, see SlabInstance
+    bool              gc_slab : 1;
 
     /**
      * @brief Construct a new Instance object.
@@ -49,6 +62,18 @@ public:
      */
     Instance(Runtime *rt, size_t bytes);
 
+protected:
+    /**
+     * @brief Construct a new Instance object.
+     *
+     * @param rt The runtime. Must be valid.
+     * @param bytes Size of instance in bytes.
+     * @param gc_slab Whether the instance is allocated in the slabs of the gc.
+     */
+    Instance(Runtime *rt, size_t bytes, bool gc_slab);
+
+public:
+
     /// @brief Destroy the Instance object
     virtual ~Instance() = default;
 
@@ -79,11 +104,20 @@ public:
     virtual void addField(NameId id, Object *obj, Runtime *rt);
 
     /**
-     * @brief Returns a list of all objects that are reachable from the instance.
+     * @brief Returns the field stored in the given slot. See Type::getFieldSlot.
+     *
+     * @param slot The slot.
+     * @return The field, or nullptr if the slot is empty.
+     */
+    virtual Object *selectFieldSlot(int64_t slot);
+
+    /**
+     * @brief Passes every object the instance references to the visitor. Instances that reference objects must
+     * override it, otherwise the gc frees those objects while they are still in use.
      *
-     * @return List of valid objects.
+     * @param visitor The visitor.
      */
-    virtual std::vector<Object *> getGCReachable();
+    virtual void trace(GCVisitor &visitor);
 
     /**
      * @brief Returns a copy of the instance.
@@ -115,4 +149,64 @@ public:
     virtual void spreadMultiUse();
 };
 
+
+/**
+ * @brief Base class of the fixed size instances, which are allocated in the slabs of the gc instead of one by one,
+ * see SlabHeap. Such instances must be created with `new (rt)`.
+ */
+class SlabInstance: public Instance {
+public:
+    /**
+     * @brief Construct a new SlabInstance object.
+     *
+     * @param rt The runtime. Must be valid.
+     * @param bytes Size of instance in bytes.
+     */
+    SlabInstance(Runtime *rt, size_t bytes);
+
+    /**
+     * @brief Allocates the instance in the slab of its size class.
+     *
+     * @param bytes Size of the instance.
+     * @param rt The runtime. Must be valid.
+     */
+    static void *operator new(size_t bytes, Runtime *rt);
+
+    /// @brief Returns the memory of the instance to its slab.
+    static void operator delete(void *ptr);
+};
+
+/**
+ * @brief Base class of the instances that reference other instances weakly. Weak references don't keep what they
+ * reference alive: they are not passed to `trace`, and once what they reference dies the gc clears them, see
+ * GC::weak_instances.
+ */
+class WeakInstance: public Instance {
+public:
+    /**
+     * @brief Construct a new WeakInstance object, and registers it with the gc.
+     *
+     * @param rt The runtime. Must be valid.
+     * @param bytes Size of instance in bytes.
+     */
+    WeakInstance(Runtime *rt, size_t bytes);
+
+    /**
+     * @brief Passes the objects that are only alive while what they are kept for is alive, like the value of an
+     * entry of a weak map, whose key is referenced weakly. Called by the gc once marking is done, again and again
+     * until it marks nothing new, as marking those objects may bring more keys to life.
+     *
+     * @param visitor The visitor.
+     * @param is_live Returns whether an instance survives the current gc cycle.
+     */
+    virtual void traceEphemerons(GCVisitor &visitor, const std::function<bool(Instance *)> &is_live);
+
+    /**
+     * @brief Clears the weak references to the instances that don't survive the current gc cycle. Called by the gc
+     * before they are freed.
+     *
+     * @param is_live Returns whether an instance survives the current gc cycle.
+     */
+    virtual void clearDead(const std::function<bool(Instance *)> &is_live) = 0;
+};
 }    // namespace Cotton
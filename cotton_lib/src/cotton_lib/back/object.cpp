@@ -8,17 +8,21 @@
 #include <cstdint>
 
 namespace Cotton {
-int64_t Object::total_objects = 0;
+std::atomic<int64_t> Object::total_objects = 0;
 
 Object::Object(bool is_instance, Instance *instance, Type *type, Runtime *rt) {
     ProfilerCAPTURE();
-    this->is_instance = is_instance;
-    this->instance    = instance;
-    this->type        = type;
-    this->gc_mark     = !rt->getGC()->gc_mark;
-    this->id          = ++total_objects;
-    this->can_modify  = true;
-    this->single_use  = false;
+    this->is_instance   = is_instance;
+    this->instance      = instance;
+    this->type          = type;
+    this->gc_mark       = !rt->getGC()->gc_mark;
+    this->gc_old        = false;
+    this->gc_remembered = false;
+    this->gc_gray       = false;
+    this->gc_age        = 0;
+    this->id            = ++total_objects;
+    this->can_modify    = true;
+    this->single_use    = false;
     rt->getGC()->track(this);
 }
 
@@ -29,20 +33,20 @@ Object::~Object() {
     total_objects--;
 }
 
-std::vector<Object *> Object::getGCReachable() {
+void Object::trace(GCVisitor &visitor) {
     ProfilerCAPTURE();
-    std::vector<Object *> res;
-    if (this->instance != nullptr) {
-        for (auto &elem : this->instance->getGCReachable()) {
-            res.push_back(elem);
-        }
-    }
-    if (this->type != nullptr) {
-        for (auto &elem : this->type->getGCReachable()) {
-            res.push_back(elem);
-        }
-    }
-    return res;
+    visitor.visit(this->instance);
+    visitor.visit(this->type);
+}
+
+void *Object::operator new(size_t bytes, Runtime *rt) {
+    ProfilerCAPTURE();
+    return rt->getGC()->slabs.allocateObject();
+}
+
+void Object::operator delete(void *ptr) {
+    ProfilerCAPTURE();
+    SlabPage::of(ptr)->allocator->free(ptr);
 }
 
 std::string Object::userRepr(Runtime *rt) {
@@ -61,9 +65,12 @@ void Object::assignTo(Object *obj, Runtime *rt) {
     if (!this->can_modify) {
         rt->signalError("Cannot assign to " + this->userRepr(rt), rt->getContext().area);
     }
-    auto id  = this->id;
-    *this    = *obj;
-    this->id = id;
+    // id and gc state belong to this object and must survive the assignment
+    this->is_instance = obj->is_instance;
+    this->can_modify  = obj->can_modify;
+    this->instance    = obj->instance;
+    this->type        = obj->type;
+    rt->getGC()->writeBarrier(this);
     this->spreadMultiUse();
 }
 
@@ -72,9 +79,24 @@ void Object::assignToCopyOf(Object *obj, Runtime *rt) {
     if (!this->can_modify) {
         rt->signalError("Cannot assign to " + this->userRepr(rt), rt->getContext().area);
     }
-    auto id  = this->id;
-    *this    = *rt->copy(obj);
-    this->id = id;
+    auto copy         = rt->copy(obj);
+    this->is_instance = copy->is_instance;
+    this->can_modify  = copy->can_modify;
+    this->instance    = copy->instance;
+    this->type        = copy->type;
+    rt->getGC()->writeBarrier(this);
+    this->spreadMultiUse();
+}
+
+void Object::assignToInstance(Instance *instance, Type *type, Runtime *rt) {
+    ProfilerCAPTURE();
+    if (!this->can_modify) {
+        rt->signalError("Cannot assign to " + this->userRepr(rt), rt->getContext().area);
+    }
+    this->is_instance = true;
+    this->instance    = instance;
+    this->type        = type;
+    rt->getGC()->writeBarrier(this);
     this->spreadMultiUse();
 }
 
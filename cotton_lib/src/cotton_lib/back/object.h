@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <ostream>
 #include <vector>
 
@@ -29,11 +30,12 @@ namespace Cotton {
 class Instance;
 class Type;
 class Runtime;
+class GCVisitor;
 
 /// @brief Class representing a Cotton object.
 class Object {
 private:
-    static int64_t total_objects;
+    static std::atomic<int64_t> total_objects;
 
 public:
     /// @brief Id of the object
@@ -43,8 +45,9 @@ public:
     /// called type object)
     bool is_instance : 1;
 
-    /// @brief Mark used by the gc in order to determine if the object is reachable
-    bool gc_mark : 1;
+    /// @brief Mark used by the gc in order to determine if the object is reachable. Atomic, because parallel
+    /// marking may reach the object from several threads
+    std::atomic<bool> gc_mark;
 
     /// @brief if `false`, then assignment to this object will not be possible
     bool can_modify : 1;
@@ -53,6 +56,18 @@ public:
     /// can be made to speed things up
     bool single_use : 1;
 
+    /// @brief `true` if the object belongs to the old generation, see GCStrategy::usesGenerations
+    bool gc_old : 1;
+
+    /// @brief `true` if the object is in the remembered set of the gc
+    bool gc_remembered : 1;
+
+    /// @brief `true` if the object waits in the gray list of an incremental gc cycle
+    bool gc_gray : 1;
+
+    /// @brief Number of minor gc cycles the object has survived while young
+    uint8_t gc_age;
+
     /// @brief Instance of the object. May be nullptr.
     Instance *instance;
 
@@ -73,11 +88,22 @@ public:
     ~Object();
 
     /**
-     * @brief Returns a list of all objects that are reachable from this object.
+     * @brief Allocates the object in the slabs of the gc, see SlabHeap. Objects must be created with `new (rt)`.
      *
-     * @return List of valid objects.
+     * @param bytes Size of the object.
+     * @param rt The runtime. Must be valid.
      */
-    std::vector<Object *> getGCReachable();
+    static void *operator new(size_t bytes, Runtime *rt);
+
+    /// @brief Returns the memory of the object to its slab.
+    static void operator delete(void *ptr);
+
+    /**
+     * @brief Passes the instance and the type of the object to the visitor.
+     *
+     * @param visitor The visitor.
+     */
+    void trace(GCVisitor &visitor);
 
     /**
      * @brief Returns string representation of the object.
@@ -103,6 +129,15 @@ public:
      */
     void assignToCopyOf(Object *obj, Runtime *rt);
 
+    /**
+     * @brief Turns this object into an instance object holding `instance`.
+     *
+     * @param instance The instance. Must be valid and not used by any other object.
+     * @param type The type of the instance. Must be valid.
+     * @param rt The runtime. Must be valid.
+     */
+    void assignToInstance(Instance *instance, Type *type, Runtime *rt);
+
     /// @brief Spreads single use mark to all of the internals of the object.
     virtual void spreadSingleUse();
 
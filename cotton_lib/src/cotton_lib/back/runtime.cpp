@@ -1,26 +1,58 @@
 #include "../builtin/api.h"
 #include "../errors.h"
 #include "../front/parser.h"
+#include "../front/resolver.h"
 #include "../profiler.h"
 #include "gc.h"
+#include "inline_cache.h"
 #include "instance.h"
 #include "nameid.h"
 #include "runtime.h"
 #include "scope.h"
 #include "type.h"
+#include "vm.h"
+#include <algorithm>
 
 namespace Cotton {
 Runtime::Runtime(GCStrategy *gc_strategy, ErrorManager *error_manager, NamesManager *nmgr)
     : nmgr(nmgr) {
     ProfilerCAPTURE();
 
-    this->scope         = new Scope(nullptr, nullptr, false);
-    this->scope->master = this->scope;
-    this->gc            = new GC(gc_strategy);
-    this->gc->rt        = this;
-    this->error_manager = error_manager;
+    this->scope              = new Scope(nullptr, nullptr, false);
+    this->scope->master      = this->scope;
+    this->gc                 = new GC(gc_strategy);
+    this->gc->rt             = this;
+    this->error_manager      = error_manager;
+    this->arg_stack          = new ArgStack();
+    this->vm                 = nullptr;
+    this->optimizer_enabled  = true;
+    this->tail_call_node     = nullptr;
+    this->tail_call_function = nullptr;
+    this->ic_stats           = {0, 0, 0};
     this->newContext();
 
+    // types take the magic methods from these when they get them, so they have to be ready before any type is made
+    const char *magic_method_names[MagicMethods::TOTAL_MAGIC_METHODS] = {
+        "__make__",
+        "__copy__",
+        "__bool__",
+        "__char__",
+        "__int__",
+        "__real__",
+        "__string__",
+        "__repr__",
+        "__read__",
+        "__get_iterator__",
+        "__deref_iterator__",
+        "__next_iterator__",
+        "__is_last_iterator__",
+        "__hash__",
+        "__eq__",
+    };
+    for (int i = 0; i < MagicMethods::TOTAL_MAGIC_METHODS; i++) {
+        this->magic_method_ids[i] = this->nmgr->getId(magic_method_names[i]);
+    }
+
     this->builtin_types.function  = new Builtin::FunctionType(this);
     this->builtin_types.nothing   = new Builtin::NothingType(this);
     this->builtin_types.boolean   = new Builtin::BooleanType(this);
@@ -29,6 +61,10 @@ Runtime::Runtime(GCStrategy *gc_strategy, ErrorManager *error_manager, NamesMana
     this->builtin_types.character = new Builtin::CharacterType(this);
     this->builtin_types.string    = new Builtin::StringType(this);
     this->builtin_types.array     = new Builtin::ArrayType(this);
+    this->builtin_types.dict      = new Builtin::DictType(this);
+    this->builtin_types.set       = new Builtin::SetType(this);
+    this->builtin_types.weakref   = new Builtin::WeakRefType(this);
+    this->builtin_types.weakmap   = new Builtin::WeakMapType(this);
 
     auto nothing_obj        = this->make(this->builtin_types.nothing, Runtime::TYPE_OBJECT);
     nothing_obj->can_modify = false;
@@ -70,6 +106,26 @@ Runtime::Runtime(GCStrategy *gc_strategy, ErrorManager *error_manager, NamesMana
     this->scope->addVariable(this->nmgr->getId("Array"), array_obj, this);
     this->registerTypeObject(this->builtin_types.array, array_obj);
 
+    auto dict_obj        = this->make(this->builtin_types.dict, Runtime::TYPE_OBJECT);
+    dict_obj->can_modify = false;
+    this->scope->addVariable(this->nmgr->getId("Dict"), dict_obj, this);
+    this->registerTypeObject(this->builtin_types.dict, dict_obj);
+
+    auto set_obj        = this->make(this->builtin_types.set, Runtime::TYPE_OBJECT);
+    set_obj->can_modify = false;
+    this->scope->addVariable(this->nmgr->getId("Set"), set_obj, this);
+    this->registerTypeObject(this->builtin_types.set, set_obj);
+
+    auto weakref_obj        = this->make(this->builtin_types.weakref, Runtime::TYPE_OBJECT);
+    weakref_obj->can_modify = false;
+    this->scope->addVariable(this->nmgr->getId("WeakRef"), weakref_obj, this);
+    this->registerTypeObject(this->builtin_types.weakref, weakref_obj);
+
+    auto weakmap_obj        = this->make(this->builtin_types.weakmap, Runtime::TYPE_OBJECT);
+    weakmap_obj->can_modify = false;
+    this->scope->addVariable(this->nmgr->getId("WeakMap"), weakmap_obj, this);
+    this->registerTypeObject(this->builtin_types.weakmap, weakmap_obj);
+
     Builtin::installBooleanMethods(this->builtin_types.boolean, this);
     Builtin::installCharacterMethods(this->builtin_types.character, this);
     Builtin::installFunctionMethods(this->builtin_types.function, this);
@@ -78,6 +134,10 @@ Runtime::Runtime(GCStrategy *gc_strategy, ErrorManager *error_manager, NamesMana
     Builtin::installNothingMethods(this->builtin_types.nothing, this);
     Builtin::installStringMethods(this->builtin_types.string, this);
     Builtin::installArrayMethods(this->builtin_types.array, this);
+    Builtin::installDictMethods(this->builtin_types.dict, this);
+    Builtin::installSetMethods(this->builtin_types.set, this);
+    Builtin::installWeakRefMethods(this->builtin_types.weakref, this);
+    Builtin::installWeakMapMethods(this->builtin_types.weakmap, this);
 
     Builtin::installBuiltinFunctions(this);
 
@@ -149,16 +209,25 @@ Object *Runtime::protectedBoolean(bool val) {
     return val ? this->protected_true : this->protected_false;
 }
 
-void Runtime::newScopeFrame(bool can_access_prev_scope) {
+void Runtime::newScopeFrame(bool can_access_prev_scope, ScopeLayout *layout) {
     ProfilerCAPTURE();
-    auto scope  = new Scope(this->scope, this->scope->master, can_access_prev_scope);
+    Scope *scope;
+    if (!this->scope_pool.empty()) {
+        scope = this->scope_pool.back();
+        this->scope_pool.pop_back();
+        scope->reset(this->scope, this->scope->master, can_access_prev_scope, layout);
+    }
+    else {
+        scope = new Scope(this->scope, this->scope->master, can_access_prev_scope, layout);
+    }
     this->scope = scope;
 }
 
 void Runtime::popScopeFrame() {
     ProfilerCAPTURE();
     auto scope = this->scope->prev;
-    delete this->scope;
+    this->scope->clear();
+    this->scope_pool.push_back(this->scope);
     this->scope = scope;
 }
 
@@ -172,7 +241,7 @@ Object *Runtime::make(Type *type, ObjectOptions object_opt) {
         obj = type->create(this);
     }
     else {
-        obj = new Object(false, nullptr, type, this);
+        obj = new (this) Object(false, nullptr, type, this);
     }
 
     if (obj == nullptr) {
@@ -391,7 +460,7 @@ Object *Runtime::runOperator(OperatorNode::OperatorId id, Object *obj, Object *a
     }
 }
 
-Object *Runtime::runOperator(OperatorNode::OperatorId id, Object *obj, const std::vector<Object *> &args, bool execution_result_matters) {
+Object *Runtime::runOperator(OperatorNode::OperatorId id, Object *obj, ArgSpan args, bool execution_result_matters) {
     ProfilerCAPTURE();
     this->verifyIsValidObject(obj, Runtime::SUB1_CTX);
 
@@ -416,40 +485,124 @@ Object *Runtime::runOperator(OperatorNode::OperatorId id, Object *obj, const std
     }
 }
 
-Object *Runtime::runMethod(NameId id, Object *obj, const std::vector<Object *> &args, bool execution_result_matters) {
+Object *Runtime::runMethod(NameId id, Object *obj, ArgSpan args, bool execution_result_matters) {
     ProfilerCAPTURE();
     auto method = obj->type->getMethod(id, this);
     return this->runOperator(OperatorNode::CALL, method, args, execution_result_matters);
 }
 
+Object *Runtime::runMagicMethod(MagicMethods::MagicMethodId id,
+                                Object                     *obj,
+                                ArgSpan                     args,
+                                bool                        execution_result_matters) {
+    ProfilerCAPTURE();
+    auto method = obj->type->getMagicMethod(id);
+    if (method == nullptr) {
+        this->signalError(obj->type->userRepr(this) + " doesn't have method " + this->nmgr->getString(this->magic_method_ids[id]),
+                          this->getContext().area);
+    }
+    this->verifyIsValidObject(method);
+    return this->runOperator(OperatorNode::CALL, method, args, execution_result_matters);
+}
+
 void Runtime::newContext() {
     ProfilerCAPTURE();
-    this->error_contexts.push_back({});
+    this->lazy_contexts.push_back({nullptr, nullptr, false});
+}
+
+void Runtime::newContext(const TextArea &area, OperatorNode *node) {
+    ProfilerCAPTURE();
+    this->lazy_contexts.push_back({&area, node, false});
 }
 
 void Runtime::popContext() {
     ProfilerCAPTURE();
-    this->error_contexts.pop_back();
+    this->lazy_contexts.pop_back();
+}
+
+static void addOperatorSubAreas(OperatorNode *node, std::vector<TextArea> &sub_areas) {
+    ProfilerCAPTURE();
+    sub_areas.push_back(node->first->text_area);
+    if (node->id == OperatorNode::CALL || node->id == OperatorNode::INDEX) {
+        auto expr = node->second;
+        while (expr != nullptr) {
+            if (expr->id == ExprNode::OPERATOR && expr->op->id == OperatorNode::COMMA) {
+                sub_areas.push_back(expr->op->first->text_area);
+                expr = expr->op->second;
+            }
+            else {
+                sub_areas.push_back(expr->text_area);
+                break;
+            }
+        }
+    }
+    else if (node->second != nullptr) {
+        sub_areas.push_back(node->second->text_area);
+    }
 }
 
 Runtime::ErrorContext &Runtime::getContext() {
     ProfilerCAPTURE();
-    return this->error_contexts.back();
+    int64_t i    = this->lazy_contexts.size() - 1;
+    auto   &lazy = this->lazy_contexts[i];
+    while (this->error_contexts.size() <= i) {
+        this->error_contexts.emplace_back();
+    }
+    auto &ctx = this->error_contexts[i];
+    if (!lazy.materialized) {
+        ctx.area = (lazy.area != nullptr) ? *lazy.area : TextArea();
+        ctx.sub_areas.clear();
+        if (lazy.node != nullptr) {
+            addOperatorSubAreas(lazy.node, ctx.sub_areas);
+        }
+        lazy.materialized = true;
+    }
+    return ctx;
+}
+
+void Runtime::setContextArea(const TextArea &area) {
+    ProfilerCAPTURE();
+    auto &lazy = this->lazy_contexts.back();
+    lazy.area  = &area;
+    if (lazy.materialized) {
+        this->error_contexts[this->lazy_contexts.size() - 1].area = area;
+    }
+}
+
+void Runtime::setContextOperator(OperatorNode *node) {
+    ProfilerCAPTURE();
+    auto &lazy = this->lazy_contexts.back();
+    lazy.node  = node;
+    if (lazy.materialized) {
+        auto &ctx = this->error_contexts[this->lazy_contexts.size() - 1];
+        ctx.sub_areas.clear();
+        if (node != nullptr) {
+            addOperatorSubAreas(node, ctx.sub_areas);
+        }
+    }
 }
 
 void Runtime::signalError(const std::string &message, const TextArea &ta) {
     ProfilerCAPTURE();
     TextArea prev;
-    for (auto c : this->error_contexts) {
-        if (c.area.first_char < c.area.last_char) {
-            if (c.area.first_char == prev.first_char && c.area.last_char == prev.last_char) {
+    for (int64_t i = 0; i < this->lazy_contexts.size(); i++) {
+        auto    &lazy = this->lazy_contexts[i];
+        TextArea area;
+        if (lazy.materialized) {
+            area = this->error_contexts[i].area;
+        }
+        else if (lazy.area != nullptr) {
+            area = *lazy.area;
+        }
+        if (area.first_char < area.last_char) {
+            if (area.first_char == prev.first_char && area.last_char == prev.last_char) {
                 continue;
             }
-            if (c.area.first_char == ta.first_char && c.area.last_char == ta.last_char) {
+            if (area.first_char == ta.first_char && area.last_char == ta.last_char) {
                 continue;
             }
-            this->error_manager->signalError("Error occurred here", c.area, false);
-            prev = c.area;
+            this->error_manager->signalError("Error occurred here", area, false);
+            prev = area;
         }
     }
     this->error_manager->signalError(message, ta);
@@ -487,7 +640,7 @@ Object *Runtime::execute(FuncDefNode *node, bool execution_result_matters) {
         this->signalError("Failed to execute unknown AST node", this->getContext().area);
     }
     this->newContext();
-    this->getContext().area = node->text_area;
+    this->setContextArea(node->text_area);
     // highlight(this, node->function_token);
     auto func               = Builtin::makeFunctionInstanceObject(false, nullptr, node, this);
     if (node->name != nullptr) {
@@ -504,17 +657,17 @@ Object *Runtime::execute(TypeDefNode *node, bool execution_result_matters) {
         this->signalError("Failed to execute unknown AST node", this->getContext().area);
     }
     this->newContext();
-    this->getContext().area = node->text_area;
-    auto type               = new Builtin::RecordType(this);
+    this->setContextArea(node->text_area);
+    auto type = new Builtin::RecordType(this);
     type->nameid            = node->name->nameid;
     for (auto f : node->fields) {
-        type->instance_fields.push_back(this->nmgr->getId(f->data));
+        type->addInstanceField(this->nmgr->getId(f->data));
     }
 
     for (auto method : node->methods) {
         this->newContext();
-        this->getContext().area = method->text_area;
-        auto f                  = Builtin::makeFunctionInstanceObject(false, nullptr, method, this);
+        this->setContextArea(method->text_area);
+        auto f = Builtin::makeFunctionInstanceObject(false, nullptr, method, this);
         type->addMethod(method->name->nameid, f);
         this->popContext();
     }
@@ -527,53 +680,42 @@ Object *Runtime::execute(TypeDefNode *node, bool execution_result_matters) {
     return res;
 }
 
-static std::vector<Object *> getList(ExprNode *expr, Runtime *rt) {
+static size_t countList(ExprNode *expr) {
     ProfilerCAPTURE();
-    std::vector<Object *> res;
+    size_t res = 0;
     while (expr != nullptr) {
-        if (expr->id == ExprNode::OPERATOR && expr->op->id == OperatorNode::COMMA) {
-            auto r = rt->execute(expr->op->first, true);
-            if (rt->isExecFlagDIRECT_PASS()) {
-                res.push_back(r);
-            }
-            else {
-                rt->newContext();
-                rt->getContext().area = expr->op->first->text_area;
-                res.push_back(rt->copy(r));
-                rt->popContext();
-            }
-            rt->getGC()->hold(res.back());
-            expr = expr->op->second;
-        }
-        else {
-            auto r = rt->execute(expr, true);
-            if (rt->isExecFlagDIRECT_PASS()) {
-                res.push_back(r);
-            }
-            else {
-                rt->newContext();
-                rt->getContext().area = expr->text_area;
-                res.push_back(rt->copy(r));
-                rt->popContext();
-            }
-            rt->getGC()->hold(res.back());
+        res++;
+        if (expr->id != ExprNode::OPERATOR || expr->op->id != OperatorNode::COMMA) {
             break;
         }
+        expr = expr->op->second;
     }
     return res;
 }
 
-static void getList_addToContext(ExprNode *expr, Runtime *rt) {
+// evaluates the elements of the list right into the slots, which keep them reachable for the gc
+static void fillList(ExprNode *expr, Object **slots, Runtime *rt) {
     ProfilerCAPTURE();
     while (expr != nullptr) {
+        auto item = expr;
         if (expr->id == ExprNode::OPERATOR && expr->op->id == OperatorNode::COMMA) {
-            rt->getContext().sub_areas.push_back(expr->op->first->text_area);
+            item = expr->op->first;
             expr = expr->op->second;
         }
         else {
-            rt->getContext().sub_areas.push_back(expr->text_area);
-            break;
+            expr = nullptr;
+        }
+        auto r = rt->execute(item, true);
+        if (rt->isExecFlagDIRECT_PASS()) {
+            *slots = r;
         }
+        else {
+            rt->newContext();
+            rt->setContextArea(item->text_area);
+            *slots = rt->copy(r);
+            rt->popContext();
+        }
+        slots++;
     }
 }
 
@@ -584,18 +726,23 @@ Object *Runtime::execute(OperatorNode *node, bool execution_result_matters) {
     }
 
     this->newContext();
-    this->getContext().area = node->text_area;
+    this->setContextArea(node->text_area);
+
+    // only the call that a `return` in tail position is made of may be scheduled instead of being made
+    bool tail_call       = this->tail_call_node == node;
+    this->tail_call_node = nullptr;
 
     if (node->id == OperatorNode::ASSIGN) {
         if (node->first->id == ExprNode::ATOM && node->first->atom->id == AtomNode::IDENTIFIER) {
-            if (!this->scope->queryVariable(node->first->atom->ident->nameid, this)) {
+            auto atom = node->first->atom;
+            if (this->scope->getResolvedVariable(atom) == nullptr && !this->scope->queryVariable(atom->ident->nameid, this)) {
                 this->scope->addVariable(node->first->atom->ident->nameid, Builtin::makeNothingInstanceObject(this), this);
             }
         }
     }
     else if (node->id == OperatorNode::COMMA) {
-        auto res = this->execute(node->first, execution_result_matters);
-        this->gc->hold(res);
+        auto res  = this->execute(node->first, execution_result_matters);
+        auto root = this->gc->pushRoot(res);
         auto expr = node->second;
         while (expr != nullptr) {
             if (expr->id == ExprNode::OPERATOR && expr->op->id == OperatorNode::COMMA) {
@@ -608,13 +755,15 @@ Object *Runtime::execute(OperatorNode *node, bool execution_result_matters) {
             }
         }
         this->popContext();
-        this->gc->release(res);
+        this->gc->popRoots(root);
         return res;
     }
     else if (node->id == OperatorNode::CALL || node->id == OperatorNode::INDEX) {
         if (node->id == OperatorNode::CALL && node->first->id == ExprNode::OPERATOR && node->first->op->id == OperatorNode::DOT) {
-            auto caller = this->execute(node->first->op->first, true);
-            this->gc->hold(caller);
+            // the caller goes first, it's passed as the first argument
+            auto    count    = 1 + countList(node->second);
+            auto    slots    = this->arg_stack->push(count);
+            Object *caller   = slots[0] = this->execute(node->first->op->first, true);
             Object *selected = nullptr;
 
             auto dot = node->first->op;
@@ -625,71 +774,55 @@ Object *Runtime::execute(OperatorNode *node, bool execution_result_matters) {
             if (!this->isInstanceObject(caller, nullptr)) {
                 this->signalError(caller->userRepr(this) + " must be an instance object", dot->first->text_area);
             }
-            if (caller->instance->hasField(selector, this)) {
-                selected = caller->instance->selectField(selector, this);
-            }
-            else if (caller->type->hasMethod(selector)) {
-                selected = caller->type->getMethod(selector, this);
-            }
-            else {
+            selected = InlineCache::of(dot, this)->select(caller, selector, this);
+            if (selected == nullptr) {
                 this->signalError("Invalid selector", dot->second->text_area);
             }
 
-            std::vector<Object *> args;
-            auto                  list = getList(node->second, this);
-            args.reserve(1 + list.size());
-            args.push_back(caller);
+            fillList(node->second, slots + 1, this);
+            ArgSpan args(slots, count);
 
-            for (auto r : list) {
-                args.push_back(r);
+            Object *res = this->protected_nothing;
+            if (!tail_call || !this->scheduleTailCall(selected, args)) {
+                this->newContext();
+                this->setContextArea(node->text_area);
+                this->setContextOperator(node);
+                res = this->runOperator(node->id, selected, args, execution_result_matters);
+                this->popContext();
             }
 
-            this->newContext();
-            this->getContext().area = node->text_area;
-            this->getContext().sub_areas.push_back(dot->text_area);    // caller
-            getList_addToContext(node->second, this);
-            auto res = this->runOperator(node->id, selected, args, execution_result_matters);
-            this->popContext();
-
             this->clearExecFlags();
             this->popContext();
 
-            for (auto &item : list) {
-                this->gc->release(item);
-            }
-            this->gc->release(caller);
+            this->arg_stack->pop(count);
             return res;
         }
         else {
-            Object *self = this->execute(node->first, true);
-            this->gc->hold(self);
-            std::vector<Object *> args;
-            auto                  list = getList(node->second, this);
-            args.reserve(list.size());
-
-            for (auto r : list) {
-                args.push_back(r);
+            // the called object takes the slot below the arguments
+            auto    count = countList(node->second);
+            auto    slots = this->arg_stack->push(1 + count);
+            Object *self  = slots[0] = this->execute(node->first, true);
+            fillList(node->second, slots + 1, this);
+            ArgSpan args(slots + 1, count);
+
+            Object *res = this->protected_nothing;
+            if (!tail_call || !this->scheduleTailCall(self, args)) {
+                this->newContext();
+                this->setContextArea(node->text_area);
+                this->setContextOperator(node);
+                res = this->runOperator(node->id, self, args, execution_result_matters);
+                this->popContext();
             }
 
-            this->newContext();
-            this->getContext().area = node->text_area;
-            this->getContext().sub_areas.push_back(node->first->text_area);    // caller
-            getList_addToContext(node->second, this);
-            auto res = this->runOperator(node->id, self, args, execution_result_matters);
-            this->popContext();
-
             this->clearExecFlags();
             this->popContext();
-            for (auto &item : list) {
-                this->gc->release(item);
-            }
-            this->gc->release(self);
+            this->arg_stack->pop(1 + count);
             return res;
         }
     }
 
-    Object *self = this->execute(node->first, true);
-    this->gc->hold(self);
+    Object *self  = this->execute(node->first, true);
+    auto    root  = this->gc->pushRoot(self);
     Object *other = nullptr;
 
     switch (node->id) {
@@ -701,31 +834,21 @@ Object *Runtime::execute(OperatorNode *node, bool execution_result_matters) {
         if (!isInstanceObject(self)) {
             this->signalError(self->userRepr(this) + " must be an instance object", node->first->text_area);
         }
-        if (self->instance->hasField(selector, this)) {
-            auto res = self->instance->selectField(selector, this);
-
-            this->clearExecFlags();
-            this->popContext();
-            this->gc->release(self);
-            return res;
-        }
-        else if (self->type->hasMethod(selector)) {
-            auto res = self->type->getMethod(selector, this);
-
-            this->clearExecFlags();
-            this->popContext();
-            this->gc->release(self);
-            return res;
-        }
-        else {
+        auto res = InlineCache::of(node, this)->select(self, selector, this);
+        if (res == nullptr) {
             this->signalError("Invalid selector", node->second->text_area);
         }
+
+        this->clearExecFlags();
+        this->popContext();
+        this->gc->popRoots(root);
+        return res;
     }
     case OperatorNode::AT : {
         this->clearExecFlags();
         this->setExecFlagDIRECT_PASS();
         this->popContext();
-        this->gc->release(self);
+        this->gc->popRoots(root);
         return self;
     }
     case OperatorNode::ASSIGN : {
@@ -739,62 +862,57 @@ Object *Runtime::execute(OperatorNode *node, bool execution_result_matters) {
 
         this->clearExecFlags();
         this->popContext();
-        this->gc->release(self);
+        this->gc->popRoots(root);
         return self;
     }
     case OperatorNode::PLUS_ASSIGN : {
         other = this->execute(node->second, true);
-        this->getContext().sub_areas.push_back(node->first->text_area);
-        this->getContext().sub_areas.push_back(node->second->text_area);
+        this->setContextOperator(node);
         self->assignToCopyOf(this->runOperator(OperatorNode::PLUS, self, other, true), this);
 
         this->clearExecFlags();
         this->popContext();
-        this->gc->release(self);
+        this->gc->popRoots(root);
         return self;
     }
     case OperatorNode::MINUS_ASSIGN : {
         other = this->execute(node->second, true);
-        this->getContext().sub_areas.push_back(node->first->text_area);
-        this->getContext().sub_areas.push_back(node->second->text_area);
+        this->setContextOperator(node);
         self->assignToCopyOf(this->runOperator(OperatorNode::MINUS, self, other, true), this);
 
         this->clearExecFlags();
         this->popContext();
-        this->gc->release(self);
+        this->gc->popRoots(root);
         return self;
     }
     case OperatorNode::MULT_ASSIGN : {
         other = this->execute(node->second, true);
-        this->getContext().sub_areas.push_back(node->first->text_area);
-        this->getContext().sub_areas.push_back(node->second->text_area);
+        this->setContextOperator(node);
         self->assignToCopyOf(this->runOperator(OperatorNode::MULT, self, other, true), this);
 
         this->clearExecFlags();
         this->popContext();
-        this->gc->release(self);
+        this->gc->popRoots(root);
         return self;
     }
     case OperatorNode::DIV_ASSIGN : {
         other = this->execute(node->second, true);
-        this->getContext().sub_areas.push_back(node->first->text_area);
-        this->getContext().sub_areas.push_back(node->second->text_area);
+        this->setContextOperator(node);
         self->assignToCopyOf(this->runOperator(OperatorNode::DIV, self, other, true), this);
 
         this->clearExecFlags();
         this->popContext();
-        this->gc->release(self);
+        this->gc->popRoots(root);
         return self;
     }
     case OperatorNode::REM_ASSIGN : {
         other = this->execute(node->second, true);
-        this->getContext().sub_areas.push_back(node->first->text_area);
-        this->getContext().sub_areas.push_back(node->second->text_area);
+        this->setContextOperator(node);
         self->assignToCopyOf(this->runOperator(OperatorNode::REM, self, other, true), this);
 
         this->clearExecFlags();
         this->popContext();
-        this->gc->release(self);
+        this->gc->popRoots(root);
         return self;
     }
     }
@@ -808,21 +926,21 @@ Object *Runtime::execute(OperatorNode *node, bool execution_result_matters) {
     case OperatorNode::PRE_MINUS :
     case OperatorNode::NOT :
     case OperatorNode::INVERSE :
-        this->getContext().sub_areas.push_back(node->first->text_area);
+        this->setContextOperator(node);
         auto res = this->runOperator(node->id, self, execution_result_matters);
         this->clearExecFlags();
         this->popContext();
-        this->gc->release(self);
+        this->gc->popRoots(root);
         return res;
     }
 
     auto arg = this->execute(node->second, true);
-    this->getContext().sub_areas.push_back(node->first->text_area);
-    this->getContext().sub_areas.push_back(node->second->text_area);
+
+    this->setContextOperator(node);
     auto res = this->runOperator(node->id, self, arg, execution_result_matters);
     this->clearExecFlags();
     this->popContext();
-    this->gc->release(self);
+    this->gc->popRoots(root);
     return res;
 }
 
@@ -832,7 +950,7 @@ Object *Runtime::execute(AtomNode *node, bool execution_result_matters) {
         this->signalError("Failed to execute unknown AST node", this->getContext().area);
     }
     this->newContext();
-    this->getContext().area = node->text_area;
+    this->setContextArea(node->text_area);
     HashTable<NameId, Object *>::point_iterator it;
 
     switch (node->id) {
@@ -1005,7 +1123,7 @@ Object *Runtime::execute(AtomNode *node, bool execution_result_matters) {
     }
     case AtomNode::IDENTIFIER : {
         this->clearExecFlags();
-        auto res = this->scope->getVariable(node->token->nameid, this);
+        auto res = this->scope->getVariable(node, this);
         this->popContext();
         return res;
     }
@@ -1026,6 +1144,9 @@ Object *Runtime::execute(StmtNode *node, bool execution_result_matters) {
     if (node == nullptr) {
         this->signalError("Failed to execute unknown AST node", this->getContext().area);
     }
+    if (this->vm != nullptr) {
+        return this->vm->execute(node, execution_result_matters);
+    }
     this->gc->ping(this);
     switch (node->id) {
     case StmtNode::WHILE : {
@@ -1067,48 +1188,63 @@ Object *Runtime::execute(WhileStmtNode *node, bool execution_result_matters) {
     if (node == nullptr) {
         this->signalError("Failed to execute unknown AST node", this->getContext().area);
     }
+    bool frame = ScopeLayout::needsFrame(node->layout);
     this->newContext();
     while (true) {
-        this->getContext().area = node->text_area;
-        this->newScopeFrame();
+        this->setContextArea(node->text_area);
+        if (frame) {
+            this->newScopeFrame(true, node->layout);
+        }
 
         if (node->cond != nullptr) {
-            this->getContext().area = node->cond->text_area;
-            auto cond               = this->execute(node->cond, true);
+            this->setContextArea(node->cond->text_area);
+            auto cond = this->execute(node->cond, true);
 
             if (!Builtin::getBooleanValue(cond, this)) {
-                this->popScopeFrame();
+                if (frame) {
+                    this->popScopeFrame();
+                }
                 break;
             }
         }
 
         if (node->body != nullptr) {
-            this->getContext().area = node->body->text_area;
-            auto body               = this->execute(node->body, execution_result_matters);
+            this->setContextArea(node->body->text_area);
+            auto body = this->execute(node->body, execution_result_matters);
             if (this->isExecFlagBREAK()) {
-                this->popScopeFrame();
+                if (frame) {
+                    this->popScopeFrame();
+                }
                 break;
             }
             else if (this->isExecFlagCONTINUE()) {
-                this->popScopeFrame();
+                if (frame) {
+                    this->popScopeFrame();
+                }
                 continue;
             }
             else if (this->isExecFlagRETURN()) {
                 if (this->isExecFlagDIRECT_PASS()) {
                     this->clearExecFlags();
                     this->setExecFlagRETURN();
-                    this->popScopeFrame();
+                    if (frame) {
+                        this->popScopeFrame();
+                    }
                     this->popContext();
                     return body;
                 }
                 this->clearExecFlags();
                 this->setExecFlagRETURN();
-                this->popScopeFrame();
+                if (frame) {
+                    this->popScopeFrame();
+                }
                 this->popContext();
                 return (execution_result_matters) ? this->copy(body) : nullptr;
             };
         }
-        this->popScopeFrame();
+        if (frame) {
+            this->popScopeFrame();
+        }
     }
     this->clearExecFlags();
     this->popContext();
@@ -1121,7 +1257,11 @@ Object *Runtime::execute(ForStmtNode *node, bool execution_result_matters) {
         this->signalError("Failed to execute unknown AST node", this->getContext().area);
     }
 
-    this->newScopeFrame();
+    bool outer_frame = ScopeLayout::needsFrame(node->outer_layout);
+    bool frame       = ScopeLayout::needsFrame(node->layout);
+    if (outer_frame) {
+        this->newScopeFrame(true, node->outer_layout);
+    }
     if (node->init != nullptr) {
         this->execute(node->init, false);
     }
@@ -1130,59 +1270,79 @@ Object *Runtime::execute(ForStmtNode *node, bool execution_result_matters) {
     while (true) {
         if (!first_cycle) {
             if (node->step != nullptr) {
-                this->getContext().area = node->step->text_area;
+                this->setContextArea(node->step->text_area);
                 this->execute(node->step, false);
             }
         }
         if (first_cycle) {
             first_cycle = false;
         }
-        this->getContext().area = node->text_area;
-        this->newScopeFrame();
+        this->setContextArea(node->text_area);
+        if (frame) {
+            this->newScopeFrame(true, node->layout);
+        }
 
         if (node->cond != nullptr) {
-            this->getContext().area = node->cond->text_area;
-            auto cond               = this->execute(node->cond, true);
+            this->setContextArea(node->cond->text_area);
+            auto cond = this->execute(node->cond, true);
 
             if (!Builtin::getBooleanValue(cond, this)) {
-                this->popScopeFrame();
+                if (frame) {
+                    this->popScopeFrame();
+                }
                 break;
             }
         }
 
         if (node->body != nullptr) {
-            this->getContext().area = node->body->text_area;
-            auto body               = this->execute(node->body, execution_result_matters);
+            this->setContextArea(node->body->text_area);
+            auto body = this->execute(node->body, execution_result_matters);
             if (this->isExecFlagBREAK()) {
-                this->popScopeFrame();
+                if (frame) {
+                    this->popScopeFrame();
+                }
                 break;
             }
             else if (this->isExecFlagCONTINUE()) {
-                this->popScopeFrame();
+                if (frame) {
+                    this->popScopeFrame();
+                }
                 continue;
             }
             else if (this->isExecFlagRETURN()) {
                 if (this->isExecFlagDIRECT_PASS()) {
                     this->clearExecFlags();
                     this->setExecFlagRETURN();
-                    this->popScopeFrame();
-                    this->popScopeFrame();
+                    if (frame) {
+                        this->popScopeFrame();
+                    }
+                    if (outer_frame) {
+                        this->popScopeFrame();
+                    }
                     this->popContext();
                     return body;
                 }
                 this->clearExecFlags();
                 this->setExecFlagRETURN();
-                this->popScopeFrame();
-                this->popScopeFrame();
+                if (frame) {
+                    this->popScopeFrame();
+                }
+                if (outer_frame) {
+                    this->popScopeFrame();
+                }
                 this->popContext();
                 return (execution_result_matters) ? this->copy(body) : nullptr;
             };
         }
-        this->popScopeFrame();
+        if (frame) {
+            this->popScopeFrame();
+        }
     }
     this->clearExecFlags();
     this->popContext();
-    this->popScopeFrame();
+    if (outer_frame) {
+        this->popScopeFrame();
+    }
     return this->protected_nothing;
 }
 
@@ -1194,8 +1354,8 @@ Object *Runtime::execute(IfStmtNode *node, bool execution_result_matters) {
 
     this->newContext();
 
-    this->getContext().area = node->cond->text_area;
-    auto cond               = this->execute(node->cond, true);
+    this->setContextArea(node->cond->text_area);
+    auto cond = this->execute(node->cond, true);
 
     if (Builtin::getBooleanValue(cond, this)) {
         this->popContext();
@@ -1217,7 +1377,7 @@ Object *Runtime::execute(ReturnStmtNode *node, bool execution_result_matters) {
     }
 
     this->newContext();
-    this->getContext().area = node->text_area;
+    this->setContextArea(node->text_area);
 
     if (node->value == nullptr) {
         this->clearExecFlags();
@@ -1226,7 +1386,17 @@ Object *Runtime::execute(ReturnStmtNode *node, bool execution_result_matters) {
         return this->protectedNothing();
     }
 
+    if (node->is_tail_call) {
+        this->tail_call_node = node->value->op;
+    }
     auto res = this->execute(node->value, execution_result_matters);
+    if (this->hasTailCall()) {
+        // the function call that makes the scheduled call ignores the result, it only has to stay valid until then
+        this->clearExecFlags();
+        this->setExecFlagRETURN();
+        this->popContext();
+        return this->protected_nothing;
+    }
     if (this->isExecFlagDIRECT_PASS()) {
         this->clearExecFlags();
         this->setExecFlagRETURN();
@@ -1245,9 +1415,10 @@ Object *Runtime::execute(BlockStmtNode *node, bool execution_result_matters) {
         this->signalError("Failed to execute unknown AST node", this->getContext().area);
     }
     this->newContext();
-    this->getContext().area = node->text_area;
-    if (!node->is_unscoped) {
-        this->newScopeFrame(true);
+    this->setContextArea(node->text_area);
+    bool frame = !node->is_unscoped && ScopeLayout::needsFrame(node->layout);
+    if (frame) {
+        this->newScopeFrame(true, node->layout);
     }
     Object *res = nullptr;
     for (auto stmt : node->list) {
@@ -1256,14 +1427,14 @@ Object *Runtime::execute(BlockStmtNode *node, bool execution_result_matters) {
         }
         res = this->execute(stmt, execution_result_matters);
         if (!this->isExecFlagNONE()) {
-            if (!node->is_unscoped) {
+            if (frame) {
                 this->popScopeFrame();
             }
             this->popContext();
             return res;
         }
     }
-    if (!node->is_unscoped) {
+    if (frame) {
         this->popScopeFrame();
     }
     this->clearExecFlags();
@@ -1348,7 +1519,7 @@ void Runtime::verifyIsOfType(Object *obj, Type *type, Runtime::ContextId ctx_id)
     }
 }
 
-void Runtime::verifyMinArgsAmountFunc(const std::vector<Object *> &args, int64_t amount, Runtime::ContextId ctx_id) {
+void Runtime::verifyMinArgsAmountFunc(ArgSpan args, int64_t amount, Runtime::ContextId ctx_id) {
     ProfilerCAPTURE();
 
     if (args.size() < amount) {
@@ -1357,7 +1528,7 @@ void Runtime::verifyMinArgsAmountFunc(const std::vector<Object *> &args, int64_t
     }
 }
 
-void Runtime::verifyExactArgsAmountFunc(const std::vector<Object *> &args, int64_t amount, Runtime::ContextId ctx_id) {
+void Runtime::verifyExactArgsAmountFunc(ArgSpan args, int64_t amount, Runtime::ContextId ctx_id) {
     ProfilerCAPTURE();
 
     if (args.size() != amount) {
@@ -1366,7 +1537,7 @@ void Runtime::verifyExactArgsAmountFunc(const std::vector<Object *> &args, int64
     }
 }
 
-void Runtime::verifyMinArgsAmountMethod(const std::vector<Object *> &args, int64_t amount, Runtime::ContextId ctx_id) {
+void Runtime::verifyMinArgsAmountMethod(ArgSpan args, int64_t amount, Runtime::ContextId ctx_id) {
     ProfilerCAPTURE();
 
     if (args.size() < amount + 1) {
@@ -1375,7 +1546,7 @@ void Runtime::verifyMinArgsAmountMethod(const std::vector<Object *> &args, int64
     }
 }
 
-void Runtime::verifyExactArgsAmountMethod(const std::vector<Object *> &args, int64_t amount, Runtime::ContextId ctx_id) {
+void Runtime::verifyExactArgsAmountMethod(ArgSpan args, int64_t amount, Runtime::ContextId ctx_id) {
     ProfilerCAPTURE();
 
     if (args.size() != amount + 1) {
@@ -1393,11 +1564,89 @@ void Runtime::verifyHasMethod(Object *obj, NameId id, Runtime::ContextId ctx_id)
     }
 }
 
+void Runtime::verifyHasMagicMethod(Object *obj, MagicMethods::MagicMethodId id, Runtime::ContextId ctx_id) {
+    ProfilerCAPTURE();
+
+    this->verifyIsValidObject(obj, ctx_id);
+    if (obj->type->getMagicMethod(id) == nullptr) {
+        this->signalError(obj->userRepr(this) + " doesn't have method " + this->nmgr->getString(this->magic_method_ids[id]),
+                          this->getTextArea(ctx_id));
+    }
+}
+
 GC *Runtime::getGC() {
     ProfilerCAPTURE();
     return this->gc;
 }
 
+ArgStack *Runtime::getArgStack() {
+    ProfilerCAPTURE();
+    return this->arg_stack;
+}
+
+void Runtime::enableVM() {
+    ProfilerCAPTURE();
+    if (this->vm == nullptr) {
+        this->vm = new VM(this);
+    }
+}
+
+VM *Runtime::getVM() {
+    ProfilerCAPTURE();
+    return this->vm;
+}
+
+bool Runtime::scheduleTailCall(Object *function, ArgSpan args) {
+    ProfilerCAPTURE();
+    if (!this->isInstanceObject(function, this->builtin_types.function)
+        || icast(function->instance, Builtin::FunctionInstance)->is_internal)
+    {
+        return false;
+    }
+    this->tail_call_function = function;
+    this->tail_call_args.assign(args.begin(), args.end());
+    return true;
+}
+
+bool Runtime::takeTailCall(Object **&slots, size_t &capacity, ArgSpan &args) {
+    ProfilerCAPTURE();
+    if (this->tail_call_function == nullptr) {
+        return false;
+    }
+    auto count = 1 + this->tail_call_args.size();
+    if (count > capacity) {
+        if (slots != nullptr) {
+            this->arg_stack->pop(capacity);
+        }
+        slots    = this->arg_stack->push(count);
+        capacity = count;
+    }
+    slots[0] = this->tail_call_function;
+    std::copy(this->tail_call_args.begin(), this->tail_call_args.end(), slots + 1);
+    // slots left over from a longer call must not keep its arguments alive
+    std::fill(slots + count, slots + capacity, nullptr);
+    args = ArgSpan(slots + 1, count - 1);
+
+    this->tail_call_function = nullptr;
+    this->tail_call_args.clear();
+    return true;
+}
+
+bool Runtime::hasTailCall() {
+    ProfilerCAPTURE();
+    return this->tail_call_function != nullptr;
+}
+
+void Runtime::disableOptimizer() {
+    ProfilerCAPTURE();
+    this->optimizer_enabled = false;
+}
+
+bool Runtime::isOptimizerEnabled() {
+    ProfilerCAPTURE();
+    return this->optimizer_enabled;
+}
+
 ErrorManager *Runtime::getErrorManager() {
     ProfilerCAPTURE();
     return this->error_manager;
@@ -1461,67 +1710,77 @@ bool Runtime::isExecFlagDIRECT_PASS() {
 namespace MagicMethods {
     NameId mm__make__(Runtime *rt) {
         ProfilerCAPTURE();
-        return rt->nmgr->getId("__make__");
+        return rt->magic_method_ids[MM_MAKE];
     }
 
     NameId mm__copy__(Runtime *rt) {
         ProfilerCAPTURE();
-        return rt->nmgr->getId("__copy__");
+        return rt->magic_method_ids[MM_COPY];
     }
 
     NameId mm__bool__(Runtime *rt) {
         ProfilerCAPTURE();
-        return rt->nmgr->getId("__bool__");
+        return rt->magic_method_ids[MM_BOOL];
     }
 
     NameId mm__char__(Runtime *rt) {
         ProfilerCAPTURE();
-        return rt->nmgr->getId("__char__");
+        return rt->magic_method_ids[MM_CHAR];
     }
 
     NameId mm__int__(Runtime *rt) {
         ProfilerCAPTURE();
-        return rt->nmgr->getId("__int__");
+        return rt->magic_method_ids[MM_INT];
     }
 
     NameId mm__real__(Runtime *rt) {
         ProfilerCAPTURE();
-        return rt->nmgr->getId("__real__");
+        return rt->magic_method_ids[MM_REAL];
     }
 
     NameId mm__string__(Runtime *rt) {
         ProfilerCAPTURE();
-        return rt->nmgr->getId("__string__");
+        return rt->magic_method_ids[MM_STRING];
     }
 
     NameId mm__repr__(Runtime *rt) {
         ProfilerCAPTURE();
-        return rt->nmgr->getId("__repr__");
+        return rt->magic_method_ids[MM_REPR];
     }
 
     NameId mm__read__(Runtime *rt) {
         ProfilerCAPTURE();
-        return rt->nmgr->getId("__read__");
+        return rt->magic_method_ids[MM_READ];
     }
 
     NameId mm__get_iterator__(Runtime *rt) {
         ProfilerCAPTURE();
-        return rt->nmgr->getId("__get_iterator__");
+        return rt->magic_method_ids[MM_GET_ITERATOR];
     }
 
     NameId mm__deref_iterator__(Runtime *rt) {
         ProfilerCAPTURE();
-        return rt->nmgr->getId("__deref_iterator__");
+        return rt->magic_method_ids[MM_DEREF_ITERATOR];
     }
 
     NameId mm__next_iterator__(Runtime *rt) {
         ProfilerCAPTURE();
-        return rt->nmgr->getId("__next_iterator__");
+        return rt->magic_method_ids[MM_NEXT_ITERATOR];
     }
 
     NameId mm__is_last_iterator__(Runtime *rt) {
         ProfilerCAPTURE();
-        return rt->nmgr->getId("__is_last_iterator__");
+        return rt->magic_method_ids[MM_IS_LAST_ITERATOR];
+    }
+
+    NameId mm__hash__(Runtime *rt) {
+        ProfilerCAPTURE();
+        return rt->magic_method_ids[MM_HASH];
+    }
+
+    NameId mm__eq__(Runtime *rt) {
+        ProfilerCAPTURE();
+        return rt->magic_method_ids[MM_EQ];
     }
 }    // namespace MagicMethods
 
@@ -23,8 +23,12 @@
 
 #include "../front/parser.h"
 #include "../util.h"
+#include "argstack.h"
+#include "inline_cache.h"
 #include "nameid.h"
 #include "object.h"
+#include "type.h"
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -39,6 +43,8 @@ class Token;
 class ExprNode;
 class StmtNode;
 class GCStrategy;
+class VM;
+class ScopeLayout;
 
 namespace Builtin {
     class NothingType;
@@ -49,6 +55,10 @@ namespace Builtin {
     class CharacterType;
     class StringType;
     class ArrayType;
+    class DictType;
+    class SetType;
+    class WeakRefType;
+    class WeakMapType;
 }    // namespace Builtin
 
 /// @brief Class that is responsible for actual execution of the Cotton language.
@@ -70,6 +80,25 @@ private:
 
     Scope *scope;
 
+    /// @brief Popped scope frames, reused by newScopeFrame in LIFO order.
+    std::vector<Scope *> scope_pool;
+
+    /// @brief Arguments of the calls that are being made, by both the tree-walking executor and the VM.
+    ArgStack *arg_stack;
+
+    /// @brief Bytecode VM that executes statements. If nullptr, the tree-walking executor is used.
+    VM *vm;
+
+    /// @brief Whether programs loaded at runtime go through the Optimizer before being resolved.
+    bool optimizer_enabled;
+
+    /// @brief CALL operator of the `return` in tail position that is being executed, nullptr if there is none.
+    OperatorNode *tail_call_node;
+
+    /// @brief Call left by scheduleTailCall. tail_call_function is nullptr if there is none.
+    Object               *tail_call_function;
+    std::vector<Object *> tail_call_args;
+
     uint8_t execution_flags;
 
     enum ExecutionFlags { NONE = 0, CONTINUE = 1, BREAK = 2, RETURN = 4, DIRECT_PASS = 8 };
@@ -96,6 +125,9 @@ public:
     /// @brief NamesManager of the runtime.
     NamesManager *const nmgr;
 
+    /// @brief Nameids of the magic methods, indexed by MagicMethods::MagicMethodId. Interned once on construction.
+    NameId magic_method_ids[MagicMethods::TOTAL_MAGIC_METHODS];
+
     /// @brief Class storing all builtin types.
     class {
     public:
@@ -107,10 +139,38 @@ public:
         Builtin::CharacterType *character;
         Builtin::StringType    *string;
         Builtin::ArrayType     *array;
+        Builtin::DictType      *dict;
+        Builtin::SetType       *set;
+        Builtin::WeakRefType   *weakref;
+        Builtin::WeakMapType   *weakmap;
     } builtin_types;
 
+    /// @brief Counters of the selector inline caches, useful for profiling.
+    class {
+    public:
+        int64_t hits;           // lookups answered by the cache
+        int64_t misses;         // lookups that had to go through the type and the instance
+        int64_t megamorphic;    // misses on sites that no longer cache new types
+    } ic_stats;
+
+    /// @brief The selector inline caches, indexed by OperatorNode::cache_index. Caches never move once created.
+    std::deque<InlineCache> inline_caches;
+
 private:
-    std::vector<ErrorContext> error_contexts;
+    /// @brief What the runtime records for each error context. The TextAreas are taken from the AST only when the
+    /// context is actually read.
+    class LazyErrorContext {
+    public:
+        const TextArea *area;            // nullptr means an empty area
+        OperatorNode   *node;            // operator whose operands make up the sub areas, may be nullptr
+        bool            materialized;    // whether error_contexts holds the up-to-date ErrorContext
+    };
+
+    std::vector<LazyErrorContext> lazy_contexts;
+
+    /// @brief Materialized contexts, indexed the same way as lazy_contexts. A deque keeps references returned by
+    /// getContext() valid when new contexts get created.
+    std::deque<ErrorContext> error_contexts;
 
 public:
     /**
@@ -195,8 +255,9 @@ public:
      *
      * @param can_access_prev_scope if `true`, the new scope frame will be able to access its parent scope frame.
      * Otherwise it won't.
+     * @param layout Layout of the frame's slots, produced by the resolver. May be nullptr.
      */
-    void newScopeFrame(bool can_access_prev_scope = true);
+    void newScopeFrame(bool can_access_prev_scope = true, ScopeLayout *layout = nullptr);
 
     /// @brief Pops the topmost scope frame.
     void popScopeFrame();
@@ -204,12 +265,36 @@ public:
     /// @brief Creates a new empty error context.
     void newContext();
 
+    /**
+     * @brief Creates a new error context with the given area and operator, same as newContext() followed by
+     * setContextArea() and setContextOperator().
+     *
+     * @param area The area. Must stay valid while the context exists.
+     * @param node The operator. May be nullptr.
+     */
+    void newContext(const TextArea &area, OperatorNode *node = nullptr);
+
     /// @brief Pops the topmost error context.
     void popContext();
 
-    /// @brief Returns the current error context.
+    /// @brief Returns the current error context. It gets built from the AST on the first call.
     ErrorContext &getContext();
 
+    /**
+     * @brief Sets the area of the current error context without building it.
+     *
+     * @param area The area. Must outlive the context, which is the case for areas of AST nodes.
+     */
+    void setContextArea(const TextArea &area);
+
+    /**
+     * @brief Sets the sub areas of the current error context to the areas of the operator's operands, without
+     * building it. For calls and indexing the sub areas are the callee followed by each argument.
+     *
+     * @param node The operator. May be nullptr, which means no sub areas.
+     */
+    void setContextOperator(OperatorNode *node);
+
     /**
      * @brief Returns the selected text area from the current context.
      *
@@ -307,7 +392,7 @@ public:
      *
      * @return Result of the operator. May not be valid if `execution_result_matters` is `false`.
      */
-    Object *runOperator(OperatorNode::OperatorId id, Object *obj, const std::vector<Object *> &args, bool execution_result_matters);
+    Object *runOperator(OperatorNode::OperatorId id, Object *obj, ArgSpan args, bool execution_result_matters);
 
     /**
      * @brief Runs method with the given id. Signals an error if no such method exists.
@@ -320,7 +405,24 @@ public:
      *
      * @return Result of the method. May not be valid if `execution_result_matters` is `false`.
      */
-    Object *runMethod(NameId id, Object *obj, const std::vector<Object *> &args, bool execution_result_matters);
+    Object *runMethod(NameId id, Object *obj, ArgSpan args, bool execution_result_matters);
+
+    /**
+     * @brief Runs the magic method with the given id. Has the same semantics as runMethod, but takes the method
+     * from its slot in the type instead of looking it up by name.
+     *
+     * @param id The magic method.
+     * @param obj Object on which the method will be run. Must be valid.
+     * @param args Arguments of the method. Each of the arguments must be valid.
+     * @param execution_result_matters if `false`, the returned object is not guaranteed to be valid. However,
+     * certain optimizations will be run.
+     *
+     * @return Result of the method. May not be valid if `execution_result_matters` is `false`.
+     */
+    Object *runMagicMethod(MagicMethods::MagicMethodId id,
+                           Object                     *obj,
+                           ArgSpan                     args,
+                           bool                        execution_result_matters);
 
     /**
      * @brief Checks whether the provided object is valid.
@@ -405,7 +507,7 @@ public:
      * @param amount The minimal amount of arguments.
      * @param ctx_id Id of the context part which will be included in the error message.
      */
-    void verifyMinArgsAmountFunc(const std::vector<Object *> &args, int64_t amount, ContextId ctx_id = ContextId::AREA_CTX);
+    void verifyMinArgsAmountFunc(ArgSpan args, int64_t amount, ContextId ctx_id = ContextId::AREA_CTX);
 
     /**
      * @brief Signals an error if the provided list of arguments contains different amount of elements than
@@ -416,7 +518,7 @@ public:
      * @param amount The exact amount of arguments.
      * @param ctx_id Id of the context part which will be included in the error message.
      */
-    void verifyExactArgsAmountFunc(const std::vector<Object *> &args, int64_t amount, ContextId ctx_id = ContextId::AREA_CTX);
+    void verifyExactArgsAmountFunc(ArgSpan args, int64_t amount, ContextId ctx_id = ContextId::AREA_CTX);
     /**
      * @brief Signals an error if the provided list of arguments contains less elements than `amount`. Since the
      * first argument is always present, it is not counted in the total number of arguments. Therefore, this
@@ -428,7 +530,7 @@ public:
      * @param amount The minimal amount of arguments.
      * @param ctx_id Id of the context part which will be included in the error message.
      */
-    void verifyMinArgsAmountMethod(const std::vector<Object *> &args, int64_t amount, ContextId ctx_id = ContextId::AREA_CTX);
+    void verifyMinArgsAmountMethod(ArgSpan args, int64_t amount, ContextId ctx_id = ContextId::AREA_CTX);
     /**
      * @brief Signals an error if the provided list of arguments contains different number of elements than
      * `amount`. Since the first argument is always present, it is not counted in the total number of arguments.
@@ -439,7 +541,7 @@ public:
      * @param amount The minimal amount of arguments.
      * @param ctx_id Id of the context part which will be included in the error message.
      */
-    void verifyExactArgsAmountMethod(const std::vector<Object *> &args, int64_t amount, ContextId ctx_id = ContextId::AREA_CTX);
+    void verifyExactArgsAmountMethod(ArgSpan args, int64_t amount, ContextId ctx_id = ContextId::AREA_CTX);
 
     /**
      * @brief Signals an error if the provided object doesn't have method with the given id.
@@ -450,6 +552,15 @@ public:
      */
     void verifyHasMethod(Object *obj, NameId id, ContextId ctx_id = ContextId::AREA_CTX);
 
+    /**
+     * @brief Signals an error if the provided object doesn't have the given magic method.
+     *
+     * @param obj Object to check.
+     * @param id The magic method.
+     * @param ctx_id Id of the context part which will be included in the error message.
+     */
+    void verifyHasMagicMethod(Object *obj, MagicMethods::MagicMethodId id, ContextId ctx_id = ContextId::AREA_CTX);
+
     /**
      * @brief Returns the current garbage collector.
      *
@@ -457,6 +568,13 @@ public:
      */
     GC *getGC();
 
+    /**
+     * @brief Returns the stack that the arguments of calls are pushed onto.
+     *
+     * @return ArgStack*
+     */
+    ArgStack *getArgStack();
+
     /**
      * @brief Returns the current error manager.
      *
@@ -464,6 +582,51 @@ public:
      */
     ErrorManager *getErrorManager();
 
+    /// @brief Makes all statements to be executed by the bytecode VM instead of the tree-walking executor.
+    void enableVM();
+
+    /**
+     * @brief Returns the bytecode VM, or nullptr if it is not enabled.
+     *
+     * @return VM*
+     */
+    VM *getVM();
+
+    /**
+     * @brief Leaves a call for the innermost running Cotton function to make once it returns, in place of itself.
+     * This is how `return` statements in tail position call, so that tail calls don't grow the C++ stack.
+     *
+     * @param function The function to call. Must be valid.
+     * @param args Arguments of the call. Each of the arguments must be valid.
+     * @return `false` if the function is not a Cotton function, in which case nothing is scheduled.
+     */
+    bool scheduleTailCall(Object *function, ArgSpan args);
+
+    /**
+     * @brief Takes the call left by scheduleTailCall, staging it on slots of the argument stack: the function goes
+     * into the first slot and the arguments follow it. The same slots are reused by every call taken with them, they
+     * are pushed again only when the call doesn't fit. They must be the topmost slots of the stack, if any.
+     *
+     * @param slots The staging slots, nullptr if there are none yet. Updated if they get pushed again.
+     * @param capacity Amount of the staging slots. Updated if they get pushed again.
+     * @param args Set to the arguments of the call, the function is slots[0].
+     * @return `false` if no call is scheduled.
+     */
+    bool takeTailCall(Object **&slots, size_t &capacity, ArgSpan &args);
+
+    /// @brief Returns whether a call left by scheduleTailCall is waiting to be made.
+    bool hasTailCall();
+
+    /// @brief Makes programs loaded at runtime (`load`, `smartrun`, `dumbrun`) to be executed as parsed.
+    void disableOptimizer();
+
+    /**
+     * @brief Returns whether programs loaded at runtime get optimized.
+     *
+     * @return bool
+     */
+    bool isOptimizerEnabled();
+
     /**
      * @brief Returns the current scope.
      *
@@ -574,6 +737,20 @@ namespace MagicMethods {
      * @return NameId of the method.
      */
     NameId mm__read__(Runtime *rt);
+    /**
+     * @brief Returns the nameid of the method called __hash__.
+     *
+     * @param rt The runtime. Must be valid.
+     * @return NameId of the method.
+     */
+    NameId mm__hash__(Runtime *rt);
+    /**
+     * @brief Returns the nameid of the method called __eq__.
+     *
+     * @param rt The runtime. Must be valid.
+     * @return NameId of the method.
+     */
+    NameId mm__eq__(Runtime *rt);
     /**
      * @brief Returns the nameid of the method called __get_iterator__.
      *
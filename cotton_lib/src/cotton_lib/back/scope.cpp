@@ -1,24 +1,48 @@
 #include "scope.h"
+#include "../front/resolver.h"
 #include "../profiler.h"
 #include "nameid.h"
 #include "runtime.h"
 
 namespace Cotton {
-Scope::Scope(Scope *prev, Scope *master, bool can_access_prev) {
+Scope::Scope(Scope *prev, Scope *master, bool can_access_prev, ScopeLayout *layout) {
+    ProfilerCAPTURE();
+    this->reset(prev, master, can_access_prev, layout);
+}
+
+Scope::~Scope() {
+    ProfilerCAPTURE();
+    this->clear();
+}
+
+void Scope::reset(Scope *prev, Scope *master, bool can_access_prev, ScopeLayout *layout) {
     ProfilerCAPTURE();
     this->prev             = prev;
     this->master           = master;
+    this->layout           = layout;
     this->can_access_prev  = can_access_prev;
     this->is_function_call = false;
+    if (layout != nullptr) {
+        this->slots.assign(layout->size(), nullptr);
+    }
 }
 
-Scope::~Scope() {
+void Scope::clear() {
     ProfilerCAPTURE();
     this->prev            = nullptr;
     this->master          = nullptr;
+    this->layout          = nullptr;
     this->can_access_prev = false;
-    this->variables.clear();
-    this->arguments.clear();
+    this->slots.clear();
+    if (!this->variables.empty()) {
+        this->variables.clear();
+    }
+    this->arguments = ArgSpan();
+}
+
+bool Scope::hasLocalVariable(NameId id) {
+    ProfilerCAPTURE();
+    return this->findLocal(id) != nullptr;
 }
 
 Scope *Scope::getPrev() {
@@ -31,11 +55,16 @@ Scope *Scope::getMaster() {
     return this->master;
 }
 
-std::vector<Object *> &Scope::getArguments() {
+ArgSpan Scope::getArguments() {
     ProfilerCAPTURE();
     return this->arguments;
 }
 
+void Scope::setArguments(ArgSpan args) {
+    ProfilerCAPTURE();
+    this->arguments = args;
+}
+
 bool Scope::canAccessPrev() {
     ProfilerCAPTURE();
     return this->can_access_prev;
@@ -56,19 +85,64 @@ void Scope::setIsFunctionCall(bool value) {
     this->is_function_call = value;
 }
 
+Object *Scope::findLocal(NameId id) {
+    ProfilerCAPTURE();
+    if (this->layout != nullptr) {
+        auto slot = this->layout->find(id);
+        if (slot != -1) {
+            return this->slots[slot];
+        }
+    }
+    auto it = this->variables.find(id);
+    if (it != this->variables.end()) {
+        return it->second;
+    }
+    return nullptr;
+}
+
 void Scope::addVariable(NameId id, Object *obj, Runtime *rt) {
     ProfilerCAPTURE();
-    this->variables[id] = obj;
+    int64_t slot = (this->layout != nullptr) ? this->layout->find(id) : -1;
+    if (slot != -1) {
+        this->slots[slot] = obj;
+    }
+    else {
+        this->variables[id] = obj;
+    }
     obj->spreadMultiUse();
 }
 
+Object *Scope::getResolvedVariable(AtomNode *node) {
+    ProfilerCAPTURE();
+    if (node->resolved_depth == -1) {
+        return nullptr;
+    }
+    Scope *s = this;
+    for (int64_t i = 0; i < node->resolved_depth && s != nullptr; i++) {
+        s = s->prev;
+    }
+    if (s == nullptr || s->layout != node->resolved_layout) {
+        return nullptr;
+    }
+    return s->slots[node->resolved_slot];
+}
+
+Object *Scope::getVariable(AtomNode *node, Runtime *rt) {
+    ProfilerCAPTURE();
+    auto res = this->getResolvedVariable(node);
+    if (res != nullptr) {
+        return res;
+    }
+    return this->getVariable(node->token->nameid, rt);
+}
+
 Object *Scope::getVariable(NameId id, Runtime *rt) {
     ProfilerCAPTURE();
     Scope *s = this;
     while (s != nullptr) {
-        auto it = s->variables.find(id);
-        if (it != s->variables.end()) {
-            return it->second;
+        auto res = s->findLocal(id);
+        if (res != nullptr) {
+            return res;
         }
         if (s->can_access_prev) {
             s = s->prev;
@@ -88,15 +162,20 @@ Object *Scope::getVariable(NameId id, Runtime *rt) {
 
 void Scope::removeVariable(NameId id, Runtime *rt) {
     ProfilerCAPTURE();
-    this->variables.erase(id);
+    int64_t slot = (this->layout != nullptr) ? this->layout->find(id) : -1;
+    if (slot != -1) {
+        this->slots[slot] = nullptr;
+    }
+    else {
+        this->variables.erase(id);
+    }
 }
 
 bool Scope::queryVariable(NameId id, Runtime *rt) {
     ProfilerCAPTURE();
     Scope *s = this;
     while (s != nullptr) {
-        auto it = s->variables.find(id);
-        if (it != s->variables.end()) {
+        if (s->findLocal(id) != nullptr) {
             return true;
         }
         if (s->can_access_prev) {
@@ -21,6 +21,7 @@
 
 #pragma once
 #include "../util.h"
+#include "argstack.h"
 #include "nameid.h"
 
 namespace Cotton {
@@ -28,6 +29,8 @@ namespace Cotton {
 class Object;
 class Runtime;
 class GC;
+class ScopeLayout;
+class AtomNode;
 
 /// @brief Class representing a scope that holds variables and function arguments
 class Scope {
@@ -36,11 +39,23 @@ class Scope {
 
 private:
     Scope                      *prev, *master;
-    HashTable<NameId, Object *> variables;
-    std::vector<Object *>       arguments;
+    ScopeLayout                *layout;       // may be nullptr
+    std::vector<Object *>       slots;        // variables described by the layout, nullptr if not declared
+    HashTable<NameId, Object *> variables;    // variables the layout doesn't describe
+    ArgSpan                     arguments;    // owned by the caller of the function
     bool                        can_access_prev;
     bool                        is_function_call;
 
+    /// @brief Returns the variable with the given id if the current scope has it, nullptr otherwise.
+    Object *findLocal(NameId id);
+
+    /// @brief Makes the scope look like it has just been constructed with the given arguments. Used for reusing
+    /// scopes that were popped.
+    void reset(Scope *prev, Scope *master, bool can_access_prev, ScopeLayout *layout);
+
+    /// @brief Drops all variables and arguments, so that the scope doesn't keep any objects alive.
+    void clear();
+
 public:
     /**
      * @brief Construct a new Scope object
@@ -49,10 +64,20 @@ public:
      * @param master Master scope. The first scope created. Must be valid.
      * @param can_access_prev If `true`, lookup for variables in the current scope will be able to access the
      * previous scope, and look there recursively as well.
+     * @param layout Layout of the slots, produced by the resolver. May be nullptr.
      */
-    Scope(Scope *prev, Scope *master, bool can_access_prev);
+    Scope(Scope *prev, Scope *master, bool can_access_prev, ScopeLayout *layout = nullptr);
     ~Scope();
 
+    /**
+     * @brief Returns whether the current scope itself has a variable with the given nameid. Previous scopes are not
+     * checked.
+     *
+     * @param id Nameid of the variable.
+     * @return `true` if such a variable exists, `false` otherwise.
+     */
+    bool hasLocalVariable(NameId id);
+
     /// @brief Returns previous scope
     Scope *getPrev();
 
@@ -60,7 +85,10 @@ public:
     Scope *getMaster();
 
     /// @brief Returns a list of function arguments.
-    std::vector<Object *> &getArguments();
+    ArgSpan getArguments();
+
+    /// @brief Sets the list of function arguments. They must stay valid until the scope is popped.
+    void setArguments(ArgSpan args);
 
     /// @brief returns `can_access_prev` of the current scope
     bool canAccessPrev();
@@ -111,6 +139,27 @@ public:
      */
     Object *getVariable(NameId id, Runtime *rt);
 
+    /**
+     * @brief Returns the variable referred to by the given identifier, using the slot assigned by the resolver.
+     *
+     * Looks at the scope `depth` frames above the current one. If that scope doesn't have the expected layout,
+     * or the variable hasn't been declared yet, falls back to getVariable.
+     *
+     * @param node Identifier atom. Must be valid.
+     * @param rt The runtime. Must be valid.
+     * @return Object*
+     */
+    Object *getVariable(AtomNode *node, Runtime *rt);
+
+    /**
+     * @brief Returns the variable that the resolver has put into the given slot, without falling back to the lookup
+     * by name.
+     *
+     * @param node Identifier atom. Must be valid.
+     * @return The variable, or nullptr if the slot is empty or the node was not resolved.
+     */
+    Object *getResolvedVariable(AtomNode *node);
+
     /**
      * @brief Removes variable with the given nameid from the current scope.
      *
@@ -0,0 +1,233 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "slab.h"
+#include "../profiler.h"
+#include "instance.h"
+#include "object.h"
+#include <cstdlib>
+
+namespace Cotton {
+static const size_t SLAB_HEADER_BYTES
+= (sizeof(SlabPage) + SlabPage::MIN_SLOT_BYTES - 1) / SlabPage::MIN_SLOT_BYTES * SlabPage::MIN_SLOT_BYTES;
+
+void *SlabPage::getSlot(size_t index) {
+    return (char *)this + SLAB_HEADER_BYTES + index * this->slot_bytes;
+}
+
+size_t SlabPage::getIndex(void *slot) {
+    return ((char *)slot - (char *)this - SLAB_HEADER_BYTES) / this->slot_bytes;
+}
+
+SlabPage *SlabPage::of(void *slot) {
+    return (SlabPage *)((uintptr_t)slot & ~(uintptr_t)(PAGE_BYTES - 1));
+}
+
+SlabAllocator::SlabAllocator(size_t slot_bytes) {
+    ProfilerCAPTURE();
+    this->slot_bytes = (slot_bytes + SlabPage::MIN_SLOT_BYTES - 1) / SlabPage::MIN_SLOT_BYTES
+                       * SlabPage::MIN_SLOT_BYTES;
+    this->live       = 0;
+}
+
+SlabAllocator::~SlabAllocator() {
+    ProfilerCAPTURE();
+    for (auto page : this->pages) {
+        std::free(page);
+    }
+}
+
+void SlabAllocator::addPage() {
+    ProfilerCAPTURE();
+    auto page        = (SlabPage *)std::aligned_alloc(SlabPage::PAGE_BYTES, SlabPage::PAGE_BYTES);
+    page->allocator  = this;
+    page->slot_bytes = this->slot_bytes;
+    page->slots      = (SlabPage::PAGE_BYTES - SLAB_HEADER_BYTES) / this->slot_bytes;
+    page->used       = 0;
+    std::fill(std::begin(page->allocated), std::end(page->allocated), 0);
+    this->pages.push_back(page);
+    // in reverse, so that the slots get allocated in the order of their addresses
+    for (size_t i = page->slots; i-- > 0;) {
+        this->free_slots.push_back(page->getSlot(i));
+    }
+}
+
+void SlabAllocator::releasePage(SlabPage *page) {
+    ProfilerCAPTURE();
+    std::free(page);
+}
+
+void *SlabAllocator::allocate() {
+    ProfilerCAPTURE();
+    if (this->free_slots.empty()) {
+        this->addPage();
+    }
+    auto slot = this->free_slots.back();
+    this->free_slots.pop_back();
+    auto page                    = SlabPage::of(slot);
+    auto index                   = page->getIndex(slot);
+    page->allocated[index / 64] |= 1ull << (index % 64);
+    page->used++;
+    this->live++;
+    return slot;
+}
+
+void SlabAllocator::free(void *slot) {
+    ProfilerCAPTURE();
+    auto page                    = SlabPage::of(slot);
+    auto index                   = page->getIndex(slot);
+    page->allocated[index / 64] &= ~(1ull << (index % 64));
+    page->used--;
+    this->live--;
+    this->free_slots.push_back(slot);
+}
+
+int64_t SlabAllocator::getLive() {
+    ProfilerCAPTURE();
+    return this->live;
+}
+
+size_t SlabAllocator::getSlotBytes() {
+    ProfilerCAPTURE();
+    return this->slot_bytes;
+}
+
+void SlabAllocator::takePages(SlabAllocator &other) {
+    ProfilerCAPTURE();
+    for (auto page : other.pages) {
+        page->allocator = this;
+        this->pages.push_back(page);
+    }
+    this->free_slots.insert(this->free_slots.end(), other.free_slots.begin(), other.free_slots.end());
+    this->live += other.live;
+    other.pages.clear();
+    other.free_slots.clear();
+    other.live = 0;
+}
+
+SlabHeap::SlabHeap() {
+    ProfilerCAPTURE();
+    this->objects = std::make_unique<SlabAllocator>(sizeof(Object));
+}
+
+void *SlabHeap::allocateObject() {
+    ProfilerCAPTURE();
+    return this->objects->allocate();
+}
+
+void *SlabHeap::allocateInstance(size_t bytes) {
+    ProfilerCAPTURE();
+    auto size_class = (bytes + SlabPage::MIN_SLOT_BYTES - 1) / SlabPage::MIN_SLOT_BYTES;
+    if (size_class >= this->instances.size()) {
+        this->instances.resize(size_class + 1);
+    }
+    auto &allocator = this->instances[size_class];
+    if (allocator == nullptr) {
+        allocator = std::make_unique<SlabAllocator>(size_class * SlabPage::MIN_SLOT_BYTES);
+    }
+    return allocator->allocate();
+}
+
+int64_t SlabHeap::getLive() {
+    ProfilerCAPTURE();
+    int64_t res = this->objects->getLive();
+    for (auto &allocator : this->instances) {
+        if (allocator != nullptr) {
+            res += allocator->getLive();
+        }
+    }
+    return res;
+}
+
+int64_t SlabHeap::getBytes() {
+    ProfilerCAPTURE();
+    int64_t res = this->objects->getLive() * this->objects->getSlotBytes();
+    for (auto &allocator : this->instances) {
+        if (allocator != nullptr) {
+            res += allocator->getLive() * allocator->getSlotBytes();
+        }
+    }
+    return res;
+}
+
+void SlabHeap::takePages(SlabHeap &other) {
+    ProfilerCAPTURE();
+    this->objects->takePages(*other.objects);
+    if (this->instances.size() < other.instances.size()) {
+        this->instances.resize(other.instances.size());
+    }
+    for (size_t i = 0; i < other.instances.size(); i++) {
+        if (other.instances[i] == nullptr) {
+            continue;
+        }
+        if (this->instances[i] == nullptr) {
+            this->instances[i] = std::make_unique<SlabAllocator>(other.instances[i]->getSlotBytes());
+        }
+        this->instances[i]->takePages(*other.instances[i]);
+    }
+}
+
+void SlabHeap::sweep(bool mark, int64_t &freed_count, int64_t &freed_bytes) {
+    ProfilerCAPTURE();
+    this->objects->sweep([&](void *slot) {
+        auto obj = (Object *)slot;
+        if (obj->gc_mark == mark) {
+            return false;
+        }
+        obj->~Object();
+        freed_count++;
+        freed_bytes += sizeof(Object);
+        return true;
+    });
+    for (auto &allocator : this->instances) {
+        if (allocator == nullptr) {
+            continue;
+        }
+        allocator->sweep([&](void *slot) {
+            auto ins = (Instance *)slot;
+            if (ins->gc_mark == mark) {
+                return false;
+            }
+            freed_count++;
+            freed_bytes += ins->getSize();
+            ins->~Instance();
+            return true;
+        });
+    }
+}
+
+void SlabHeap::clear() {
+    ProfilerCAPTURE();
+    this->objects->sweep([](void *slot) {
+        ((Object *)slot)->~Object();
+        return true;
+    });
+    for (auto &allocator : this->instances) {
+        if (allocator == nullptr) {
+            continue;
+        }
+        allocator->sweep([](void *slot) {
+            ((Instance *)slot)->~Instance();
+            return true;
+        });
+    }
+}
+}    // namespace Cotton
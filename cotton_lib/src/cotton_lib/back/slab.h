@@ -0,0 +1,238 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Cotton {
+class Object;
+class Instance;
+class SlabAllocator;
+
+/**
+ * @brief A page of equally sized slots, starting with this header. Pages are aligned to PAGE_BYTES, so the page of
+ * a slot can be found from the address of the slot alone.
+ */
+class SlabPage {
+public:
+    static const size_t PAGE_BYTES     = 64 * 1024;
+    static const size_t MIN_SLOT_BYTES = 16;
+    static const size_t BITMAP_WORDS   = PAGE_BYTES / MIN_SLOT_BYTES / 64;
+
+    SlabAllocator *allocator;    // the allocator that currently owns the page
+    size_t         slot_bytes;
+    size_t         slots;
+    size_t         used;                       // number of allocated slots
+    uint64_t       allocated[BITMAP_WORDS];    // bit i is set if slot i is allocated
+
+    /// @brief Returns the slot with the given index.
+    void *getSlot(size_t index);
+
+    /// @brief Returns the index of the slot at the given address.
+    size_t getIndex(void *slot);
+
+    /// @brief Returns the page that the slot belongs to. The slot must have been allocated by a SlabAllocator.
+    static SlabPage *of(void *slot);
+};
+
+/**
+ * @brief Allocates slots of a single size out of pages. Every page keeps a bitmap of its allocated slots, so that
+ * the allocations can be swept with a linear scan over the pages instead of being tracked one by one.
+ */
+class SlabAllocator {
+private:
+    size_t                  slot_bytes;
+    std::vector<SlabPage *> pages;
+    std::vector<void *>     free_slots;
+    int64_t                 live;    // number of allocated slots
+
+    void addPage();
+    void releasePage(SlabPage *page);
+
+public:
+    /**
+     * @brief Construct a new SlabAllocator object
+     *
+     * @param slot_bytes Size of the slots. Rounded up to a multiple of SlabPage::MIN_SLOT_BYTES.
+     */
+    SlabAllocator(size_t slot_bytes);
+
+    /// @brief Releases all of the pages. Whatever is still allocated in them doesn't get destroyed.
+    ~SlabAllocator();
+
+    SlabAllocator(const SlabAllocator &)            = delete;
+    SlabAllocator &operator=(const SlabAllocator &) = delete;
+
+    /// @brief Returns an uninitialized slot.
+    void *allocate();
+
+    /**
+     * @brief Frees the slot. Doesn't destroy what it holds.
+     *
+     * @param slot The slot. Must have been allocated by this allocator.
+     */
+    void free(void *slot);
+
+    /// @brief Returns the number of allocated slots.
+    int64_t getLive();
+
+    /// @brief Returns the size of the slots in bytes.
+    size_t getSlotBytes();
+
+    /**
+     * @brief Moves all of the pages of `other` into this allocator, leaving `other` empty.
+     *
+     * @param other The allocator to take the pages from.
+     */
+    void takePages(SlabAllocator &other);
+
+    /**
+     * @brief Calls `f` for every allocated slot.
+     *
+     * @param f The function.
+     */
+    template<typename F>
+    void forEach(F f) {
+        for (auto page : this->pages) {
+            for (size_t word = 0; word < SlabPage::BITMAP_WORDS; word++) {
+                for (auto bits = page->allocated[word]; bits != 0; bits &= bits - 1) {
+                    f(page->getSlot(word * 64 + __builtin_ctzll(bits)));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Calls `dead` for every allocated slot, and frees the slots it returns `true` for. `dead` must destroy what
+     * the slot holds before returning `true`. Pages left empty are released.
+     *
+     * @param dead The predicate.
+     */
+    template<typename F>
+    void sweep(F dead) {
+        size_t kept = 0;
+        for (auto page : this->pages) {
+            for (size_t word = 0; word < SlabPage::BITMAP_WORDS; word++) {
+                for (auto bits = page->allocated[word]; bits != 0; bits &= bits - 1) {
+                    auto bit = __builtin_ctzll(bits);
+                    if (dead(page->getSlot(word * 64 + bit))) {
+                        page->allocated[word] &= ~(1ull << bit);
+                        page->used--;
+                        this->live--;
+                    }
+                }
+            }
+            if (page->used == 0) {
+                this->releasePage(page);
+                continue;
+            }
+            this->pages[kept++] = page;
+        }
+        this->pages.resize(kept);
+        // the slots of the released pages may still be in the list, so it is built anew
+        this->free_slots.clear();
+        for (auto page : this->pages) {
+            for (size_t i = page->slots; i-- > 0;) {
+                if ((page->allocated[i / 64] >> (i % 64) & 1) == 0) {
+                    this->free_slots.push_back(page->getSlot(i));
+                }
+            }
+        }
+    }
+};
+
+/**
+ * @brief Slab allocators for objects and for fixed size instances, one for every size class of instances. Objects
+ * and instances are kept apart, so that a sweep knows what every slot holds.
+ */
+class SlabHeap {
+private:
+    std::unique_ptr<SlabAllocator>              objects;
+    std::vector<std::unique_ptr<SlabAllocator>> instances;    // by size class
+
+public:
+    /// @brief Construct a new SlabHeap object
+    SlabHeap();
+
+    /// @brief Returns uninitialized memory for an Object.
+    void *allocateObject();
+
+    /**
+     * @brief Returns uninitialized memory for an instance.
+     *
+     * @param bytes Size of the instance.
+     */
+    void *allocateInstance(size_t bytes);
+
+    /// @brief Returns the number of allocated objects and instances.
+    int64_t getLive();
+
+    /// @brief Returns the size of the allocated objects and instances in bytes.
+    int64_t getBytes();
+
+    /**
+     * @brief Calls `f` for every allocated object.
+     *
+     * @param f The function, takes an Object*.
+     */
+    template<typename F>
+    void forEachObject(F f) {
+        this->objects->forEach([&](void *slot) { f((Object *)slot); });
+    }
+
+    /**
+     * @brief Calls `f` for every allocated instance.
+     *
+     * @param f The function, takes an Instance*.
+     */
+    template<typename F>
+    void forEachInstance(F f) {
+        for (auto &allocator : this->instances) {
+            if (allocator != nullptr) {
+                allocator->forEach([&](void *slot) { f((Instance *)slot); });
+            }
+        }
+    }
+
+    /**
+     * @brief Moves all of the pages of `other` into this heap, leaving `other` empty.
+     *
+     * @param other The heap to take the pages from.
+     */
+    void takePages(SlabHeap &other);
+
+    /**
+     * @brief Destroys and frees every object and instance that isn't marked with `mark`.
+     *
+     * @param mark The mark of the reachable ones.
+     * @param freed_count Increased by the number of freed objects and instances.
+     * @param freed_bytes Increased by their size in bytes, as reported when they got tracked.
+     */
+    void sweep(bool mark, int64_t &freed_count, int64_t &freed_bytes);
+
+    /// @brief Destroys and frees every object and instance.
+    void clear();
+};
+}    // namespace Cotton
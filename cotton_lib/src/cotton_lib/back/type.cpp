@@ -40,7 +40,13 @@ Type::Type(Runtime *rt) {
     = neq_op = bitand_op = bitxor_op = bitor_op = and_op = or_op = nullptr;
 
     call_op = index_op = nullptr;
-    this->gc_mark      = !rt->getGC()->gc_mark;
+    this->gc_mark          = !rt->getGC()->gc_mark;
+    this->version          = 0;
+    this->has_extra_fields = false;
+    this->magic_method_ids = rt->magic_method_ids;
+    for (auto &method : this->magic_methods) {
+        method = nullptr;
+    }
 
     rt->getGC()->track(this);
 }
@@ -60,6 +66,12 @@ Type::~Type() {
 void Type::addMethod(NameId id, Object *method) {
     ProfilerCAPTURE();
     this->methods[id] = method;
+    this->version++;
+    for (int i = 0; i < MagicMethods::TOTAL_MAGIC_METHODS; i++) {
+        if (this->magic_method_ids[i] == id) {
+            this->magic_methods[i] = method;
+        }
+    }
 }
 
 Object *Type::getMethod(NameId id, Runtime *rt) {
@@ -78,13 +90,21 @@ bool Type::hasMethod(NameId id) {
     return it != this->methods.end();
 }
 
-std::vector<Object *> Type::getGCReachable() {
+Object *Type::getMagicMethod(MagicMethods::MagicMethodId id) {
+    ProfilerCAPTURE();
+    return this->magic_methods[id];
+}
+
+int64_t Type::getFieldSlot(NameId id) {
+    ProfilerCAPTURE();
+    return -1;
+}
+
+void Type::trace(GCVisitor &visitor) {
     ProfilerCAPTURE();
-    std::vector<Object *> res;
     for (auto &elem : this->methods) {
-        res.push_back(elem.second);
+        visitor.visit(elem.second);
     }
-    return res;
 }
 
 };    // namespace Cotton
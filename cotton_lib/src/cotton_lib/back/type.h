@@ -23,20 +23,42 @@
 
 #include "../front/api.h"
 #include "../util.h"
+#include "argstack.h"
 #include "nameid.h"
+#include <atomic>
 
 namespace Cotton {
 
 class Object;
 class Runtime;
 class Type;
+class GCVisitor;
+
+namespace MagicMethods {
+    /// @brief Magic methods that get a slot of their own in every type.
+    enum MagicMethodId {
+        MM_MAKE,
+        MM_COPY,
+        MM_BOOL,
+        MM_CHAR,
+        MM_INT,
+        MM_REAL,
+        MM_STRING,
+        MM_REPR,
+        MM_READ,
+        MM_GET_ITERATOR,
+        MM_DEREF_ITERATOR,
+        MM_NEXT_ITERATOR,
+        MM_IS_LAST_ITERATOR,
+        MM_HASH,
+        MM_EQ,
+        TOTAL_MAGIC_METHODS
+    };
+}    // namespace MagicMethods
 
 typedef Object *(*UnaryOperatorAdapter)(Object *self, Runtime *rt, bool execution_result_matters);
 typedef Object *(*BinaryOperatorAdapter)(Object *self, Object *arg, Runtime *rt, bool execution_result_matters);
-typedef Object *(*NaryOperatorAdapter)(Object                      *self,
-                                       const std::vector<Object *> &args,
-                                       Runtime                     *rt,
-                                       bool                         execution_result_matters);
+typedef Object *(*NaryOperatorAdapter)(Object *self, ArgSpan args, Runtime *rt, bool execution_result_matters);
 
 /// @brief Class representing a type in Cotton.
 class Type {
@@ -54,12 +76,25 @@ public:    // TODOs
 
     HashTable<NameId, Object *> methods;
 
+    /// @brief Nameids of the magic methods, owned by the runtime. Used to keep magic_methods in sync with methods.
+    const NameId *magic_method_ids;
+
+    /// @brief Magic methods of the type, indexed by MagicMethods::MagicMethodId. nullptr means not present.
+    Object *magic_methods[MagicMethods::TOTAL_MAGIC_METHODS];
+
 public:
     /// @brief id of the type
     int64_t id;
 
-    /// @brief current garbage collector mark of this type
-    bool gc_mark : 1;
+    /// @brief current garbage collector mark of this type, atomic because of parallel marking
+    std::atomic<bool> gc_mark;
+
+    /// @brief Incremented every time the methods change, so that inline caches notice it
+    int64_t version;
+
+    /// @brief Whether some instance has a field that getFieldSlot doesn't describe. Such a field may hide a method, so
+    /// inline caches don't remember methods of the type then
+    bool has_extra_fields;
 
     /**
      * @brief Construct a new Type object
@@ -96,6 +131,14 @@ public:
      */
     bool hasMethod(NameId id);
 
+    /**
+     * @brief Returns the magic method from its slot, without looking it up by name.
+     *
+     * @param id The magic method.
+     * @return The method, or nullptr if the type doesn't have it.
+     */
+    Object *getMagicMethod(MagicMethods::MagicMethodId id);
+
     /**
      * TODO
      * @brief Adds an unary operator to the type. Signals an error if the provided `id` is not of a unary operator.
@@ -107,8 +150,24 @@ public:
     void addOperator(OperatorNode::OperatorId id, BinaryOperatorAdapter op);
     void addOperator(OperatorNode::OperatorId id, NaryOperatorAdapter op);
 
-    virtual std::vector<Object *> getGCReachable();
-    virtual size_t                getInstanceSize() = 0;    // for placement on stack in case of is_simple
+    /**
+     * @brief Returns the slot that the field given by id occupies in the instances of this type. Types whose
+     * instances have fields must describe them here, and bump the version if the layout changes.
+     *
+     * @param id Nameid of the field.
+     * @return The slot, or -1 if the instances don't have such a field.
+     */
+    virtual int64_t getFieldSlot(NameId id);
+
+    /**
+     * @brief Passes every object the type references to the visitor. Types that reference objects other than
+     * their methods must override it.
+     *
+     * @param visitor The visitor.
+     */
+    virtual void trace(GCVisitor &visitor);
+
+    virtual size_t getInstanceSize() = 0;    // for placement on stack in case of is_simple
 
     // creates a valid (non-null) object
     virtual Object *create(Runtime *rt)            = 0;
@@ -0,0 +1,170 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "value.h"
+#include "../builtin/api.h"
+#include "../profiler.h"
+#include "object.h"
+#include "runtime.h"
+
+namespace Cotton {
+Value Value::unbox(Runtime *rt) const {
+    ProfilerCAPTURE();
+    if (this->kind != OBJECT || this->object == nullptr || !this->object->is_instance) {
+        return *this;
+    }
+    auto type = this->object->type;
+    if (type == rt->builtin_types.integer) {
+        return Value::makeInteger(getIntegerValueFast(this->object));
+    }
+    if (type == rt->builtin_types.real) {
+        return Value::makeReal(getRealValueFast(this->object));
+    }
+    if (type == rt->builtin_types.boolean) {
+        return Value::makeBoolean(getBooleanValueFast(this->object));
+    }
+    if (type == rt->builtin_types.character) {
+        return Value::makeCharacter(getCharacterValueFast(this->object));
+    }
+    return *this;
+}
+
+Object *Value::toObject(Runtime *rt) const {
+    ProfilerCAPTURE();
+    switch (this->kind) {
+    case INTEGER : return Builtin::makeIntegerInstanceObject(this->integer, rt);
+    case REAL : return Builtin::makeRealInstanceObject(this->real, rt);
+    case BOOLEAN : return rt->protectedBoolean(this->boolean);
+    case CHARACTER : return Builtin::makeCharacterInstanceObject(this->character, rt);
+    case NOTHING : return rt->protectedNothing();
+    default : return this->object;
+    }
+}
+
+void Value::assignTo(Object *obj, Runtime *rt) const {
+    ProfilerCAPTURE();
+    switch (this->kind) {
+    case INTEGER : {
+        auto res   = new (rt) Builtin::IntegerInstance(rt);
+        res->value = this->integer;
+        obj->assignToInstance(res, rt->builtin_types.integer, rt);
+        return;
+    }
+    case REAL : {
+        auto res   = new (rt) Builtin::RealInstance(rt);
+        res->value = this->real;
+        obj->assignToInstance(res, rt->builtin_types.real, rt);
+        return;
+    }
+    case BOOLEAN : {
+        auto res   = new (rt) Builtin::BooleanInstance(rt);
+        res->value = this->boolean;
+        obj->assignToInstance(res, rt->builtin_types.boolean, rt);
+        return;
+    }
+    case CHARACTER : {
+        auto res   = new (rt) Builtin::CharacterInstance(rt);
+        res->value = this->character;
+        obj->assignToInstance(res, rt->builtin_types.character, rt);
+        return;
+    }
+    default : obj->assignToCopyOf(this->toObject(rt), rt); return;
+    }
+}
+
+// faulting integer divisions are left to the adapters, which report them
+static inline bool isFaultingDivision(OperatorNode::OperatorId id, const Value &self, const Value &arg) {
+    ProfilerCAPTURE();
+    return (id == OperatorNode::DIV || id == OperatorNode::REM) && self.kind == Value::INTEGER
+           && (arg.integer == 0 || (arg.integer == -1 && self.integer == INT64_MIN));
+}
+
+// quickened operators guard on the kinds of both operands, the site falls back to the generic path otherwise
+#define QUICK_OPERATOR(KIND, OP, MAKE, EXPR)                                                                         \
+    case OperatorNode::OP :                                                                                          \
+        return [](const Value &self, const Value &arg, Value &res) {                                                 \
+            ProfilerCAPTURE();                                                                                       \
+            if (self.kind != Value::KIND || arg.kind != Value::KIND) {                                               \
+                return false;                                                                                        \
+            }                                                                                                        \
+            if (isFaultingDivision(OperatorNode::OP, self, arg)) {                                                   \
+                return false;                                                                                        \
+            }                                                                                                        \
+            res = Value::MAKE(EXPR);                                                                                 \
+            return true;                                                                                             \
+        };
+#define INTEGER_QUICK_OPERATOR(OP, MAKE, EXPR) QUICK_OPERATOR(INTEGER, OP, MAKE, EXPR)
+#define REAL_QUICK_OPERATOR(OP, MAKE, EXPR)    QUICK_OPERATOR(REAL, OP, MAKE, EXPR)
+#define BOOLEAN_QUICK_OPERATOR(OP, MAKE, EXPR) QUICK_OPERATOR(BOOLEAN, OP, MAKE, EXPR)
+
+QuickBinaryOperator getQuickOperator(OperatorNode::OperatorId id, Value::Kind kind) {
+    ProfilerCAPTURE();
+    switch (kind) {
+    case Value::INTEGER :
+        switch (id) {
+            INTEGER_QUICK_OPERATORS(INTEGER_QUICK_OPERATOR)
+        default : return nullptr;
+        }
+    case Value::REAL :
+        switch (id) {
+            REAL_QUICK_OPERATORS(REAL_QUICK_OPERATOR)
+        default : return nullptr;
+        }
+    case Value::BOOLEAN :
+        switch (id) {
+            BOOLEAN_QUICK_OPERATORS(BOOLEAN_QUICK_OPERATOR)
+        default : return nullptr;
+        }
+    default : return nullptr;
+    }
+}
+
+#undef QUICK_OPERATOR
+#undef INTEGER_QUICK_OPERATOR
+#undef REAL_QUICK_OPERATOR
+#undef BOOLEAN_QUICK_OPERATOR
+
+bool runImmediateOperator(OperatorNode::OperatorId id, const Value &self, Value &res) {
+    ProfilerCAPTURE();
+    switch (self.kind) {
+    case Value::INTEGER : return Builtin::runIntegerImmediateOperator(id, self.integer, res);
+    case Value::REAL : return Builtin::runRealImmediateOperator(id, self.real, res);
+    case Value::BOOLEAN : return Builtin::runBooleanImmediateOperator(id, self.boolean, res);
+    case Value::CHARACTER : return Builtin::runCharacterImmediateOperator(id, self.character, res);
+    default : return false;
+    }
+}
+
+bool runImmediateOperator(OperatorNode::OperatorId id, const Value &self, const Value &arg, Value &res) {
+    ProfilerCAPTURE();
+    // mixed operands are left to the adapters, so that comparisons and errors stay the same
+    if (self.kind != arg.kind) {
+        return false;
+    }
+    switch (self.kind) {
+    case Value::INTEGER : return Builtin::runIntegerImmediateOperator(id, self.integer, arg.integer, res);
+    case Value::REAL : return Builtin::runRealImmediateOperator(id, self.real, arg.real, res);
+    case Value::BOOLEAN : return Builtin::runBooleanImmediateOperator(id, self.boolean, arg.boolean, res);
+    case Value::CHARACTER : return Builtin::runCharacterImmediateOperator(id, self.character, arg.character, res);
+    default : return false;
+    }
+}
+}    // namespace Cotton
@@ -0,0 +1,170 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "../front/parser.h"
+#include <cstdint>
+
+namespace Cotton {
+class Object;
+class Runtime;
+
+/**
+ * @brief A value that is either an object or an unboxed Integer, Real, Boolean, Character or Nothing.
+ *
+ * Immediates carry no identity. They only live on the operand stack and in the constants of the bytecode VM, the
+ * tree-walker, scope slots, arrays and function arguments always hold objects. An immediate is turned into an object
+ * as soon as it leaves the operand stack, e.g. when it gets assigned, passed to a function or returned, and reading a
+ * variable yields its object again. So only the intermediate results of an expression stay unboxed.
+ */
+class Value {
+public:
+    enum Kind : uint8_t {
+        OBJECT,
+        INTEGER,
+        REAL,
+        BOOLEAN,
+        CHARACTER,
+        NOTHING,
+    };
+
+    Kind kind;
+
+    union {
+        Object *object;
+        int64_t integer;
+        double  real;
+        bool    boolean;
+        uint8_t character;
+    };
+
+    Value()
+        : kind(OBJECT)
+        , object(nullptr) {}
+
+    Value(Object *object)
+        : kind(OBJECT)
+        , object(object) {}
+
+    static Value makeInteger(int64_t value) {
+        Value res;
+        res.kind    = INTEGER;
+        res.integer = value;
+        return res;
+    }
+
+    static Value makeReal(double value) {
+        Value res;
+        res.kind = REAL;
+        res.real = value;
+        return res;
+    }
+
+    static Value makeBoolean(bool value) {
+        Value res;
+        res.kind    = BOOLEAN;
+        res.boolean = value;
+        return res;
+    }
+
+    static Value makeCharacter(uint8_t value) {
+        Value res;
+        res.kind      = CHARACTER;
+        res.character = value;
+        return res;
+    }
+
+    static Value makeNothing() {
+        Value res;
+        res.kind = NOTHING;
+        return res;
+    }
+
+    /// @brief Returns `true` if the value is not an object.
+    bool isImmediate() const {
+        return this->kind != OBJECT;
+    }
+
+    /**
+     * @brief Returns an immediate holding the value of the object if it is an instance object of Integer, Real,
+     * Boolean or Character. Otherwise returns the value itself.
+     *
+     * @param rt The runtime. Must be valid.
+     * @return Value
+     */
+    Value unbox(Runtime *rt) const;
+
+    /**
+     * @brief Returns the object this value stands for. Immediates get materialized into new single use objects,
+     * booleans and nothing use the protected objects of the runtime.
+     *
+     * @param rt The runtime. Must be valid.
+     * @return Object*
+     */
+    Object *toObject(Runtime *rt) const;
+
+    /**
+     * @brief Assigns `obj` to a copy of this value. Has the same semantics as Object::assignToCopyOf, but
+     * immediates only create the instance.
+     *
+     * @param obj The object to assign to. Must be valid.
+     * @param rt The runtime. Must be valid.
+     */
+    void assignTo(Object *obj, Runtime *rt) const;
+};
+
+/// @brief Operator specialized for the operand kinds seen at a site. Returns `false` if the guard on the kinds fails.
+typedef bool (*QuickBinaryOperator)(const Value &self, const Value &arg, Value &res);
+
+/// @brief After that many failed guards a site stays generic for good.
+const uint8_t MAX_QUICKENING_DEOPTS = 4;
+
+/**
+ * @brief Returns the operator specialized for two immediates of the given kind.
+ *
+ * @param id The operator.
+ * @param kind Kind of both operands.
+ * @return The specialization, or nullptr if there is none.
+ */
+QuickBinaryOperator getQuickOperator(OperatorNode::OperatorId id, Value::Kind kind);
+
+/**
+ * @brief Runs the unary operator on an immediate.
+ *
+ * @param id The operator. Operators that need identity (`++`, `--`) are never handled.
+ * @param self The operand. Must be an immediate.
+ * @param res The result, set only on success.
+ * @return `true` if the operator was handled, `false` if it has to go through Runtime::runOperator.
+ */
+bool runImmediateOperator(OperatorNode::OperatorId id, const Value &self, Value &res);
+
+/**
+ * @brief Runs the binary operator on two immediates.
+ *
+ * @param id The operator.
+ * @param self The left operand. Must be an immediate.
+ * @param arg The right operand. Must be an immediate.
+ * @param res The result, set only on success.
+ * @return `true` if the operator was handled, `false` if it has to go through Runtime::runOperator.
+ */
+bool runImmediateOperator(OperatorNode::OperatorId id, const Value &self, const Value &arg, Value &res);
+}    // namespace Cotton
@@ -0,0 +1,470 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "vm.h"
+#include "../builtin/api.h"
+#include "../profiler.h"
+#include "gc.h"
+#include "inline_cache.h"
+#include "instance.h"
+#include "object.h"
+#include "runtime.h"
+#include "scope.h"
+#include "type.h"
+
+// labels as values let every handler jump straight to the next one instead of going through a switch
+#if defined(__GNUC__)
+#define COTTON_VM_THREADED_DISPATCH
+#endif
+
+#ifdef COTTON_VM_THREADED_DISPATCH
+#define VM_CASE(NAME) op_##NAME:
+#define VM_DISPATCH() goto *dispatch_table[ip->opcode]
+#else
+#define VM_CASE(NAME) case Instruction::NAME:
+#define VM_DISPATCH() goto dispatch
+#endif
+
+#define VM_NEXT()                                                                                                  \
+    do {                                                                                                           \
+        ++ip;                                                                                                      \
+        VM_DISPATCH();                                                                                             \
+    } while (0)
+
+// instructions that may fail get an error context of their own, just like the nodes of the tree-walking executor, so
+// that the contexts of the enclosing nodes stay as they are
+#define VM_PUSH_AREA()    this->rt->newContext(*ip->area)
+#define VM_PUSH_CONTEXT() this->rt->newContext(*ip->area, ip->node)
+#define VM_POP_CONTEXT()  this->rt->popContext()
+// operands of an operator without ENTER_CONTEXT push its context below their own, see Compiler::compileOperator
+#define VM_PUSH_OPERAND_AREA()                                                                                     \
+    do {                                                                                                           \
+        if (ip->node != nullptr) {                                                                                 \
+            this->rt->newContext(ip->node->text_area);                                                             \
+        }                                                                                                          \
+        VM_PUSH_AREA();                                                                                            \
+    } while (0)
+#define VM_POP_OPERAND_CONTEXT()                                                                                   \
+    do {                                                                                                           \
+        VM_POP_CONTEXT();                                                                                          \
+        if (ip->node != nullptr) {                                                                                 \
+            VM_POP_CONTEXT();                                                                                      \
+        }                                                                                                          \
+    } while (0)
+
+namespace Cotton {
+// turns an immediate into an object in place, so that the object stays reachable for the gc while it is in use. Every
+// value that leaves the operand stack goes through here, nothing else holds immediates
+static inline Object *materialize(Value &value, Runtime *rt) {
+    if (value.isImmediate()) {
+        value = value.toObject(rt);
+    }
+    return value.object;
+}
+
+// copies the values from `first` to the top of the stack onto the argument stack, after `reserved` free slots
+static inline Object **pushArgs(std::vector<Value> &stack, size_t first, size_t reserved, Runtime *rt) {
+    auto slots = rt->getArgStack()->push(reserved + stack.size() - first);
+    for (auto i = first; i < stack.size(); i++) {
+        slots[reserved + i - first] = materialize(stack[i], rt);
+    }
+    return slots;
+}
+
+VM::VM(Runtime *rt) {
+    ProfilerCAPTURE();
+    this->rt = rt;
+    this->stack.reserve(1024);
+}
+
+VM::~VM() {
+    ProfilerCAPTURE();
+    for (auto &[_, chunk] : this->chunks) {
+        delete chunk;
+    }
+}
+
+Chunk *VM::getChunk(StmtNode *node) {
+    ProfilerCAPTURE();
+    auto it = this->chunks.find(node);
+    if (it != this->chunks.end()) {
+        return it->second;
+    }
+    Compiler compiler(this->rt);
+    auto     chunk     = compiler.compile(node);
+    this->chunks[node] = chunk;
+    return chunk;
+}
+
+Object *VM::execute(StmtNode *node, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    if (node == nullptr) {
+        this->rt->signalError("Failed to execute unknown AST node", this->rt->getContext().area);
+    }
+    return this->run(this->getChunk(node));
+}
+
+Object *VM::run(Chunk *chunk) {
+    ProfilerCAPTURE();
+#ifdef COTTON_VM_THREADED_DISPATCH
+    static void *dispatch_table[] = {
+        &&op_LOAD_CONST,
+        &&op_LOAD_VAR,
+        &&op_DECLARE_VAR,
+        &&op_POP,
+        &&op_COPY,
+        &&op_UNARY_OP,
+        &&op_BINARY_OP,
+        &&op_BINARY_OP_QUICK,
+        &&op_ASSIGN,
+        &&op_COMPOUND_ASSIGN,
+        &&op_SELECT,
+        &&op_SELECT_METHOD,
+        &&op_CALL,
+        &&op_CALL_METHOD,
+        &&op_TAIL_CALL,
+        &&op_TAIL_CALL_METHOD,
+        &&op_INDEX,
+        &&op_EVAL,
+        &&op_ENTER_SCOPE,
+        &&op_LEAVE_SCOPE,
+        &&op_ENTER_CONTEXT,
+        &&op_LEAVE_CONTEXT,
+        &&op_JUMP,
+        &&op_LOOP,
+        &&op_JUMP_IF_FALSE,
+        &&op_RETURN,
+        &&op_HALT,
+    };
+    static_assert(sizeof(dispatch_table) / sizeof(void *) == Instruction::TOTAL_OPCODES);
+#endif
+
+    auto   &stack       = this->stack;
+    auto    base        = stack.size();
+    auto    entry_scope = this->rt->getScope();
+    auto    code        = chunk->code.data();
+    auto    ip          = code;
+    Object *res         = nullptr;
+    int64_t contexts    = 0;
+    Value   value;
+
+    this->rt->newContext();
+    this->rt->getGC()->ping(this->rt);
+
+#ifdef COTTON_VM_THREADED_DISPATCH
+    VM_DISPATCH();
+#else
+dispatch:
+    switch (ip->opcode) {
+#endif
+
+    VM_CASE(LOAD_CONST) {
+        stack.push_back(chunk->constants[ip->arg]);
+        VM_NEXT();
+    }
+
+    VM_CASE(LOAD_VAR) {
+        auto var = this->rt->getScope()->getResolvedVariable(ip->atom);
+        if (var == nullptr) {
+            VM_PUSH_OPERAND_AREA();
+            var = this->rt->getScope()->getVariable(ip->atom, this->rt);
+            VM_POP_OPERAND_CONTEXT();
+        }
+        stack.push_back(var);
+        VM_NEXT();
+    }
+
+    VM_CASE(DECLARE_VAR) {
+        auto scope = this->rt->getScope();
+        auto id    = ip->atom->ident->nameid;
+        if (scope->getResolvedVariable(ip->atom) == nullptr && !scope->queryVariable(id, this->rt)) {
+            scope->addVariable(id, Builtin::makeNothingInstanceObject(this->rt), this->rt);
+        }
+        VM_NEXT();
+    }
+
+    VM_CASE(POP) {
+        stack.pop_back();
+        VM_NEXT();
+    }
+
+    VM_CASE(COPY) {
+        // immediates have no identity, so they never need to be copied
+        if (stack.back().kind == Value::OBJECT || stack.back().kind == Value::NOTHING) {
+            VM_PUSH_OPERAND_AREA();
+            stack.back() = this->rt->copy(stack.back().toObject(this->rt));
+            VM_POP_OPERAND_CONTEXT();
+        }
+        VM_NEXT();
+    }
+
+    VM_CASE(UNARY_OP) {
+        if (runImmediateOperator(ip->op, stack.back().unbox(this->rt), value)) {
+            stack.back() = value;
+            VM_NEXT();
+        }
+        VM_PUSH_CONTEXT();
+        auto self    = materialize(stack.back(), this->rt);
+        stack.back() = this->rt->runOperator(ip->op, self, ip->execution_result_matters);
+        VM_POP_CONTEXT();
+        VM_NEXT();
+    }
+
+    VM_CASE(BINARY_OP) {
+        if (runImmediateOperator(ip->op, stack[stack.size() - 2].unbox(this->rt), stack.back().unbox(this->rt), value)) {
+            // the operands had the same immediate kind, so the site can be specialized for it
+            if (ip->deopts < MAX_QUICKENING_DEOPTS) {
+                ip->quick = getQuickOperator(ip->op, stack.back().unbox(this->rt).kind);
+                if (ip->quick != nullptr) {
+                    ip->opcode = Instruction::BINARY_OP_QUICK;
+                }
+            }
+            stack.pop_back();
+            stack.back() = value;
+            VM_NEXT();
+        }
+        VM_PUSH_CONTEXT();
+        auto self = materialize(stack[stack.size() - 2], this->rt);
+        auto arg  = materialize(stack.back(), this->rt);
+        res       = this->rt->runOperator(ip->op, self, arg, ip->execution_result_matters);
+        VM_POP_CONTEXT();
+        stack.pop_back();
+        stack.back() = res;
+        VM_NEXT();
+    }
+
+    VM_CASE(BINARY_OP_QUICK) {
+        if (ip->quick(stack[stack.size() - 2].unbox(this->rt), stack.back().unbox(this->rt), value)) {
+            stack.pop_back();
+            stack.back() = value;
+            VM_NEXT();
+        }
+        // the guard failed, the site goes back to the generic operator
+        ip->opcode = Instruction::BINARY_OP;
+        ip->quick  = nullptr;
+        ip->deopts++;
+        VM_DISPATCH();
+    }
+
+    VM_CASE(ASSIGN) {
+        VM_PUSH_AREA();
+        auto self = materialize(stack[stack.size() - 2], this->rt);
+        if (ip->arg) {
+            self->assignTo(materialize(stack.back(), this->rt), this->rt);
+        }
+        else {
+            stack.back().unbox(this->rt).assignTo(self, this->rt);
+        }
+        VM_POP_CONTEXT();
+        stack.pop_back();
+        VM_NEXT();
+    }
+
+    VM_CASE(COMPOUND_ASSIGN) {
+        VM_PUSH_CONTEXT();
+        auto self = materialize(stack[stack.size() - 2], this->rt);
+        if (runImmediateOperator(ip->op, Value(self).unbox(this->rt), stack.back().unbox(this->rt), value)) {
+            value.assignTo(self, this->rt);
+        }
+        else {
+            auto other = materialize(stack.back(), this->rt);
+            self->assignToCopyOf(this->rt->runOperator(ip->op, self, other, true), this->rt);
+        }
+        VM_POP_CONTEXT();
+        stack.pop_back();
+        VM_NEXT();
+    }
+
+    VM_CASE(SELECT) {
+        VM_PUSH_AREA();
+        auto self = materialize(stack.back(), this->rt);
+        if (!this->rt->isInstanceObject(self)) {
+            this->rt->signalError(self->userRepr(this->rt) + " must be an instance object", ip->node->first->text_area);
+        }
+        auto selected = InlineCache::of(ip->node, this->rt)->select(self, ip->nameid, this->rt);
+        if (selected == nullptr) {
+            this->rt->signalError("Invalid selector", ip->node->second->text_area);
+        }
+        VM_POP_CONTEXT();
+        stack.back() = selected;
+        VM_NEXT();
+    }
+
+    VM_CASE(SELECT_METHOD) {
+        VM_PUSH_AREA();
+        auto caller = materialize(stack.back(), this->rt);
+        if (!this->rt->isInstanceObject(caller, nullptr)) {
+            this->rt->signalError(caller->userRepr(this->rt) + " must be an instance object", ip->node->first->text_area);
+        }
+        auto selected = InlineCache::of(ip->node, this->rt)->select(caller, ip->nameid, this->rt);
+        if (selected == nullptr) {
+            this->rt->signalError("Invalid selector", ip->node->second->text_area);
+        }
+        VM_POP_CONTEXT();
+        stack.push_back(selected);
+        VM_NEXT();
+    }
+
+    VM_CASE(TAIL_CALL)
+    VM_CASE(CALL) {
+        auto    first = stack.size() - ip->arg;
+        auto    self  = materialize(stack[first - 1], this->rt);
+        ArgSpan args(pushArgs(stack, first, 0, this->rt), ip->arg);
+        if (ip->opcode == Instruction::TAIL_CALL && this->rt->scheduleTailCall(self, args)) {
+            this->rt->getArgStack()->pop(args.size());
+            res = nullptr;
+            goto finish;
+        }
+        VM_PUSH_CONTEXT();
+        res = this->rt->runOperator(OperatorNode::CALL, self, args, ip->execution_result_matters);
+        VM_POP_CONTEXT();
+        this->rt->getArgStack()->pop(args.size());
+        stack.resize(first);
+        stack.back() = res;
+        VM_NEXT();
+    }
+
+    VM_CASE(TAIL_CALL_METHOD)
+    VM_CASE(CALL_METHOD) {
+        auto first    = stack.size() - ip->arg;
+        auto selected = materialize(stack[first - 1], this->rt);
+        auto slots    = pushArgs(stack, first, 1, this->rt);
+        slots[0]      = stack[first - 2].object;
+        ArgSpan args(slots, ip->arg + 1);
+        if (ip->opcode == Instruction::TAIL_CALL_METHOD && this->rt->scheduleTailCall(selected, args)) {
+            this->rt->getArgStack()->pop(args.size());
+            res = nullptr;
+            goto finish;
+        }
+        VM_PUSH_CONTEXT();
+        res = this->rt->runOperator(OperatorNode::CALL, selected, args, ip->execution_result_matters);
+        VM_POP_CONTEXT();
+        this->rt->getArgStack()->pop(args.size());
+        stack.resize(first - 1);
+        stack.back() = res;
+        VM_NEXT();
+    }
+
+    VM_CASE(INDEX) {
+        auto    first = stack.size() - ip->arg;
+        auto    self  = materialize(stack[first - 1], this->rt);
+        ArgSpan args(pushArgs(stack, first, 0, this->rt), ip->arg);
+        VM_PUSH_CONTEXT();
+        res = this->rt->runOperator(OperatorNode::INDEX, self, args, ip->execution_result_matters);
+        VM_POP_CONTEXT();
+        this->rt->getArgStack()->pop(args.size());
+        stack.resize(first);
+        stack.back() = res;
+        VM_NEXT();
+    }
+
+    VM_CASE(EVAL) {
+        VM_PUSH_AREA();
+        stack.push_back(this->rt->execute(ip->expr, ip->execution_result_matters));
+        VM_POP_CONTEXT();
+        this->rt->clearExecFlags();
+        VM_NEXT();
+    }
+
+    VM_CASE(ENTER_SCOPE) {
+        this->rt->newScopeFrame(true, ip->layout);
+        VM_NEXT();
+    }
+
+    VM_CASE(LEAVE_SCOPE) {
+        this->rt->popScopeFrame();
+        VM_NEXT();
+    }
+
+    VM_CASE(ENTER_CONTEXT) {
+        this->rt->newContext(*ip->area);
+        contexts++;
+        VM_NEXT();
+    }
+
+    VM_CASE(LEAVE_CONTEXT) {
+        this->rt->popContext();
+        contexts--;
+        VM_NEXT();
+    }
+
+    VM_CASE(JUMP) {
+        ip = code + ip->arg;
+        VM_DISPATCH();
+    }
+
+    VM_CASE(LOOP) {
+        this->rt->getGC()->ping(this->rt);
+        ip = code + ip->arg;
+        VM_DISPATCH();
+    }
+
+    VM_CASE(JUMP_IF_FALSE) {
+        bool cond;
+        if (stack.back().kind == Value::BOOLEAN) {
+            cond = stack.back().boolean;
+        }
+        else {
+            VM_PUSH_AREA();
+            cond = Builtin::getBooleanValue(materialize(stack.back(), this->rt), this->rt);
+            VM_POP_CONTEXT();
+        }
+        stack.pop_back();
+        if (!cond) {
+            ip = code + ip->arg;
+            VM_DISPATCH();
+        }
+        VM_NEXT();
+    }
+
+    VM_CASE(RETURN) {
+        res = materialize(stack.back(), this->rt);
+        if (!ip->arg) {
+            VM_PUSH_AREA();
+            res = this->rt->copy(res);
+            VM_POP_CONTEXT();
+        }
+        goto finish;
+    }
+
+    VM_CASE(HALT) {
+        res = (stack.size() > base) ? materialize(stack.back(), this->rt) : nullptr;
+        goto finish;
+    }
+
+#ifndef COTTON_VM_THREADED_DISPATCH
+    default : this->rt->signalError("Unknown instruction", *ip->area);
+    }
+#endif
+
+finish:
+    while (this->rt->getScope() != entry_scope) {
+        this->rt->popScopeFrame();
+    }
+    stack.resize(base);
+    for (; contexts > 0; contexts--) {
+        this->rt->popContext();
+    }
+    this->rt->popContext();
+    this->rt->clearExecFlags();
+    return (res != nullptr) ? res : this->rt->protectedNothing();
+}
+}    // namespace Cotton
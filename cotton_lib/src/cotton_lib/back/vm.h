@@ -0,0 +1,81 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "../front/parser.h"
+#include "../util.h"
+#include "bytecode.h"
+#include <vector>
+
+namespace Cotton {
+class Object;
+class Runtime;
+class GC;
+
+/// @brief Bytecode virtual machine. Compiles statements on their first execution and runs the produced chunks.
+class VM {
+    friend class GC;
+
+private:
+    Runtime                       *rt;
+    HashTable<StmtNode *, Chunk *> chunks;
+
+    /// @brief Stack of values shared by all nested runs. Every object on it is reachable for the gc.
+    std::vector<Value> stack;
+
+public:
+    /**
+     * @brief Construct a new VM object
+     *
+     * @param rt The runtime. Must be valid.
+     */
+    VM(Runtime *rt);
+
+    /// @brief Destroy the VM object and all of the compiled chunks.
+    ~VM();
+
+    /**
+     * @brief Returns the chunk compiled from the given node. The node gets compiled on the first request.
+     *
+     * @param node The statement. Must be valid.
+     * @return Chunk*
+     */
+    Chunk *getChunk(StmtNode *node);
+
+    /**
+     * @brief Executes the given node. Has the same semantics as Runtime::execute.
+     *
+     * @param node Node to be executed. Must be valid.
+     * @param execution_result_matters If `false`, certain optimizations may happen.
+     * @return The result of the execution.
+     */
+    Object *execute(StmtNode *node, bool execution_result_matters);
+
+    /**
+     * @brief Runs the given chunk.
+     *
+     * @param chunk The chunk. Must be valid.
+     * @return The result of the execution.
+     */
+    Object *run(Chunk *chunk);
+};
+}    // namespace Cotton
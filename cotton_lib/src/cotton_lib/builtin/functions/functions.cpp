@@ -27,7 +27,7 @@
 
 namespace Cotton::Builtin {
 // make(type) - makes an object of a given type
-static Object *CF_make(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_make(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -35,83 +35,83 @@ static Object *CF_make(const std::vector<Object *> &args, Runtime *rt, bool exec
 
     auto res = rt->make(arg->type, Runtime::INSTANCE_OBJECT);
 
-    if (rt->isValidObject(res) && res->type->hasMethod(MagicMethods::mm__make__(rt))) {
-        return rt->runMethod(MagicMethods::mm__make__(rt), res, {res}, true);
+    if (rt->isValidObject(res) && res->type->getMagicMethod(MagicMethods::MM_MAKE) != nullptr) {
+        return rt->runMagicMethod(MagicMethods::MM_MAKE, res, ArgSpan(&res, 1), true);
     }
     return res;
 }
 
 // copy(obj) - copies obj
-static Object *CF_copy(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_copy(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
     rt->verifyIsValidObject(arg, FunctionArgCtx(0));
 
-    if (arg->type->hasMethod(MagicMethods::mm__copy__(rt))) {
-        return rt->runMethod(MagicMethods::mm__copy__(rt), arg, {arg}, true);
+    if (arg->type->getMagicMethod(MagicMethods::MM_COPY) != nullptr) {
+        return rt->runMagicMethod(MagicMethods::MM_COPY, arg, ArgSpan(&arg, 1), true);
     }
 
     return rt->copy(args[0]);
 }
 
 // bool(obj) - converts obj to Boolean
-static Object *CF_bool(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_bool(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
     rt->verifyIsValidObject(arg, FunctionArgCtx(0));
 
-    rt->verifyHasMethod(arg, MagicMethods::mm__bool__(rt), FunctionArgCtx(0));
-    return rt->runMethod(MagicMethods::mm__bool__(rt), arg, {arg}, execution_result_matters);
+    rt->verifyHasMagicMethod(arg, MagicMethods::MM_BOOL, FunctionArgCtx(0));
+    return rt->runMagicMethod(MagicMethods::MM_BOOL, arg, ArgSpan(&arg, 1), execution_result_matters);
 }
 
 // char(obj) - converts obj to Character
-static Object *CF_char(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_char(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
     rt->verifyIsValidObject(arg, FunctionArgCtx(0));
 
-    rt->verifyHasMethod(arg, MagicMethods::mm__char__(rt), FunctionArgCtx(0));
-    return rt->runMethod(MagicMethods::mm__char__(rt), arg, {arg}, execution_result_matters);
+    rt->verifyHasMagicMethod(arg, MagicMethods::MM_CHAR, FunctionArgCtx(0));
+    return rt->runMagicMethod(MagicMethods::MM_CHAR, arg, ArgSpan(&arg, 1), execution_result_matters);
 }
 
 // int(obj) - converts obj to Integer
-static Object *CF_int(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_int(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
     rt->verifyIsValidObject(arg, FunctionArgCtx(0));
 
-    rt->verifyHasMethod(arg, MagicMethods::mm__int__(rt), FunctionArgCtx(0));
-    return rt->runMethod(MagicMethods::mm__int__(rt), arg, {arg}, execution_result_matters);
+    rt->verifyHasMagicMethod(arg, MagicMethods::MM_INT, FunctionArgCtx(0));
+    return rt->runMagicMethod(MagicMethods::MM_INT, arg, ArgSpan(&arg, 1), execution_result_matters);
 }
 
 // real(obj) - converts obj to Real
-static Object *CF_real(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_real(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
     rt->verifyIsValidObject(arg, FunctionArgCtx(0));
 
-    rt->verifyHasMethod(arg, MagicMethods::mm__real__(rt), FunctionArgCtx(0));
-    return rt->runMethod(MagicMethods::mm__real__(rt), arg, {arg}, execution_result_matters);
+    rt->verifyHasMagicMethod(arg, MagicMethods::MM_REAL, FunctionArgCtx(0));
+    return rt->runMagicMethod(MagicMethods::MM_REAL, arg, ArgSpan(&arg, 1), execution_result_matters);
 }
 
 // string(obj) - converts obj to String
-static Object *CF_string(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_string(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
     rt->verifyIsValidObject(arg, FunctionArgCtx(0));
 
-    rt->verifyHasMethod(arg, MagicMethods::mm__string__(rt), FunctionArgCtx(0));
-    return rt->runMethod(MagicMethods::mm__string__(rt), arg, {arg}, execution_result_matters);
+    rt->verifyHasMagicMethod(arg, MagicMethods::MM_STRING, FunctionArgCtx(0));
+    return rt->runMagicMethod(MagicMethods::MM_STRING, arg, ArgSpan(&arg, 1), execution_result_matters);
 }
 
 // printraw(...) - prints arguments without adding any spaces or new lines
-static Object *CF_printraw(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_printraw(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     int64_t index = -1;
     for (auto arg : args) {
@@ -122,21 +122,21 @@ static Object *CF_printraw(const std::vector<Object *> &args, Runtime *rt, bool
             continue;
         }
 
-        rt->verifyHasMethod(arg, MagicMethods::mm__string__(rt), FunctionArgCtx(index));
+        rt->verifyHasMagicMethod(arg, MagicMethods::MM_STRING, FunctionArgCtx(index));
 
         auto &ta = rt->getContext().sub_areas[index];
         rt->newContext();
         rt->getContext().area      = ta;
         rt->getContext().sub_areas = {ta, ta};
-        auto res                   = rt->runMethod(MagicMethods::mm__string__(rt), arg, {arg}, true);
-        CF_printraw({res}, rt, false);
+        auto res                   = rt->runMagicMethod(MagicMethods::MM_STRING, arg, ArgSpan(&arg, 1), true);
+        CF_printraw(ArgSpan(&res, 1), rt, false);
         rt->popContext();
     }
     return rt->protectedNothing();
 }
 
 // print(...) - prints arguments with adding spaces in between them, but not adding the trailing newline
-static Object *CF_print(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_print(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     bool    f     = false;
     int64_t index = 0;
@@ -152,14 +152,14 @@ static Object *CF_print(const std::vector<Object *> &args, Runtime *rt, bool exe
         rt->newContext();
         rt->getContext().area      = ata;
         rt->getContext().sub_areas = {fta, ita};
-        CF_printraw({arg}, rt, false);
+        CF_printraw(ArgSpan(&arg, 1), rt, false);
         rt->popContext();
     }
     return rt->protectedNothing();
 }
 
 // printf(fmt, ...) - prints arguments with a given format
-static Object *CF_printf(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_printf(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyMinArgsAmountFunc(args, 1);
     auto fmt = args[0];
@@ -216,7 +216,7 @@ static Object *CF_printf(const std::vector<Object *> &args, Runtime *rt, bool ex
                         rt->getContext().sub_areas = {ctx.sub_areas[pos + 1], ctx.sub_areas[pos + 1]};
                         std::cout << res;
                         res = "";
-                        CF_printraw({arg}, rt, false);
+                        CF_printraw(ArgSpan(&arg, 1), rt, false);
                         rt->popContext();
                     }
                     else {
@@ -239,7 +239,7 @@ static Object *CF_printf(const std::vector<Object *> &args, Runtime *rt, bool ex
 }
 
 // println(...) - prints arguments with adding spaces in between them, as well as adding the trailing newline
-static Object *CF_println(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_println(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     CF_print(args, rt, execution_result_matters);
     std::cout << std::endl;
@@ -247,7 +247,7 @@ static Object *CF_println(const std::vector<Object *> &args, Runtime *rt, bool e
 }
 
 // readraw() - scans a single character, including spaces and other special characters
-static Object *CF_readraw(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_readraw(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 0);
 
@@ -261,18 +261,18 @@ static Object *CF_readraw(const std::vector<Object *> &args, Runtime *rt, bool e
 }
 
 // read(type) - scans a value of given type
-static Object *CF_read(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_read(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
     rt->verifyIsTypeObject(arg, nullptr, FunctionArgCtx(0));
 
-    rt->verifyHasMethod(arg, MagicMethods::mm__read__(rt), FunctionArgCtx(0));
-    return rt->runMethod(MagicMethods::mm__read__(rt), arg, {arg}, execution_result_matters);
+    rt->verifyHasMagicMethod(arg, MagicMethods::MM_READ, FunctionArgCtx(0));
+    return rt->runMagicMethod(MagicMethods::MM_READ, arg, ArgSpan(&arg, 1), execution_result_matters);
 }
 
 // readln() - scans an entire line
-static Object *CF_readln(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_readln(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 0);
 
@@ -286,7 +286,7 @@ static Object *CF_readln(const std::vector<Object *> &args, Runtime *rt, bool ex
 }
 
 // exit(code) - exits with a given code
-static Object *CF_exit(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_exit(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -296,7 +296,7 @@ static Object *CF_exit(const std::vector<Object *> &args, Runtime *rt, bool exec
 }
 
 // fork() - does fork()
-static Object *CF_fork(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_fork(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 0);
 
@@ -309,7 +309,7 @@ static Object *CF_fork(const std::vector<Object *> &args, Runtime *rt, bool exec
 }
 
 // system(str) - does system(str)
-static Object *CF_system(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_system(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -324,7 +324,7 @@ static Object *CF_system(const std::vector<Object *> &args, Runtime *rt, bool ex
 }
 
 // sleep(tm) - sleems for the given amount of seconds
-static Object *CF_sleep(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_sleep(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -336,7 +336,7 @@ static Object *CF_sleep(const std::vector<Object *> &args, Runtime *rt, bool exe
 }
 
 // error(msg) - signals an error with the given message
-static Object *CF_error(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_error(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -346,7 +346,7 @@ static Object *CF_error(const std::vector<Object *> &args, Runtime *rt, bool exe
 }
 
 // cotton(str) - executes cotton code given in the string
-static Object *CF_cotton(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_cotton(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -370,7 +370,7 @@ static Object *CF_cotton(const std::vector<Object *> &args, Runtime *rt, bool ex
 }
 
 // argc() - returns the number of arguments passed to the current function
-static Object *CF_argc(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_argc(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 0);
 
@@ -378,7 +378,7 @@ static Object *CF_argc(const std::vector<Object *> &args, Runtime *rt, bool exec
         return nullptr;
     }
 
-    auto s = rt->getScope()->getPrev();
+    auto s = rt->getScope();
     while (s != nullptr && !s->isFunctionCall()) {
         s = s->getPrev();
     }
@@ -389,7 +389,7 @@ static Object *CF_argc(const std::vector<Object *> &args, Runtime *rt, bool exec
 }
 
 // argv() - returns an array made of arguments passed to the current functions
-static Object *CF_argv(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_argv(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 0);
 
@@ -397,18 +397,19 @@ static Object *CF_argv(const std::vector<Object *> &args, Runtime *rt, bool exec
         return nullptr;
     }
 
-    auto s = rt->getScope()->getPrev();
+    auto s = rt->getScope();
     while (s != nullptr && !s->isFunctionCall()) {
         s = s->getPrev();
     }
     if (s == nullptr) {
         return Builtin::makeArrayInstanceObject({}, rt);
     }
-    return Builtin::makeArrayInstanceObject(s->getArguments(), rt);
+    auto arguments = s->getArguments();
+    return Builtin::makeArrayInstanceObject(std::vector<Object *>(arguments.begin(), arguments.end()), rt);
 }
 
 // argg(index) - returns a function arguments at position index
-static Object *CF_argg(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_argg(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -420,7 +421,7 @@ static Object *CF_argg(const std::vector<Object *> &args, Runtime *rt, bool exec
 
     int64_t i = getIntegerValue(arg, rt);
 
-    auto s = rt->getScope()->getPrev();
+    auto s = rt->getScope();
     while (s != nullptr && !s->isFunctionCall()) {
         s = s->getPrev();
     }
@@ -436,7 +437,7 @@ static Object *CF_argg(const std::vector<Object *> &args, Runtime *rt, bool exec
 }
 
 // is(obj1, obj2) - returns whether obj1 is obj2
-static Object *CF_is(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_is(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 2);
     auto arg1 = args[0];
@@ -448,7 +449,7 @@ static Object *CF_is(const std::vector<Object *> &args, Runtime *rt, bool execut
 }
 
 // typeof(obj) - returns a type object with type of obj
-static Object *CF_typeof(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_typeof(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -463,7 +464,7 @@ static Object *CF_typeof(const std::vector<Object *> &args, Runtime *rt, bool ex
 
 // isinsobj(obj, type) - tells whether obj is an instance object of the given type (or any type if nothing is
 // given)
-static Object *CF_isinsobj(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_isinsobj(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyMinArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -485,7 +486,7 @@ static Object *CF_isinsobj(const std::vector<Object *> &args, Runtime *rt, bool
 
 // istypeobj(obj, type) - tells whether obj is a type object of the given type (or any type if nothing is
 // given)
-static Object *CF_istypeobj(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_istypeobj(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyMinArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -506,18 +507,18 @@ static Object *CF_istypeobj(const std::vector<Object *> &args, Runtime *rt, bool
 }
 
 // repr(obj) - gives a string representation of obj
-static Object *CF_repr(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_repr(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
     rt->verifyIsValidObject(arg, FunctionArgCtx(0));
 
-    rt->verifyHasMethod(arg, MagicMethods::mm__repr__(rt), FunctionArgCtx(0));
-    return rt->runMethod(MagicMethods::mm__repr__(rt), arg, {arg}, execution_result_matters);
+    rt->verifyHasMagicMethod(arg, MagicMethods::MM_REPR, FunctionArgCtx(0));
+    return rt->runMagicMethod(MagicMethods::MM_REPR, arg, ArgSpan(&arg, 1), execution_result_matters);
 }
 
 // hasfield(obj, str) - tells whether obj has field given in str
-static Object *CF_hasfield(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_hasfield(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 2);
     auto obj = args[0];
@@ -532,7 +533,7 @@ static Object *CF_hasfield(const std::vector<Object *> &args, Runtime *rt, bool
 }
 
 // hasmethod(obj, str) - tells whether obj has method given in str
-static Object *CF_hasmethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_hasmethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 2);
     auto obj = args[0];
@@ -547,7 +548,7 @@ static Object *CF_hasmethod(const std::vector<Object *> &args, Runtime *rt, bool
 }
 
 // assert(val, str) - raises an error given in str(or "assertion error" is str is absent) if value is not true
-static Object *CF_assert(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_assert(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyMinArgsAmountFunc(args, 1);
     auto val = args[0];
@@ -566,13 +567,11 @@ static Object *CF_assert(const std::vector<Object *> &args, Runtime *rt, bool ex
         rt->signalError(message, rt->getContext().area);
     }
 
-    if (!execution_result_matters) {
-        return rt->protectedNothing();
-    }
+    return rt->protectedNothing();
 }
 
 // isinscope(str) - returns whether variable with name str can be accessed from the current scope
-static Object *CF_isinscope(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_isinscope(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -582,7 +581,7 @@ static Object *CF_isinscope(const std::vector<Object *> &args, Runtime *rt, bool
 }
 
 // checkglobal(str) - returns whether global variable with name str was defined
-static Object *CF_checkglobal(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_checkglobal(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -592,7 +591,7 @@ static Object *CF_checkglobal(const std::vector<Object *> &args, Runtime *rt, bo
 }
 
 // getglobal(str) - returns global variable with name str
-static Object *CF_getglobal(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_getglobal(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -602,7 +601,7 @@ static Object *CF_getglobal(const std::vector<Object *> &args, Runtime *rt, bool
 }
 
 // setglobal(str, obj) - sets global variable with name str to obj
-static Object *CF_setglobal(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_setglobal(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 2);
     auto arg1 = args[0];
@@ -615,7 +614,7 @@ static Object *CF_setglobal(const std::vector<Object *> &args, Runtime *rt, bool
 }
 
 // removeglobal(str) - removes global variable with name str
-static Object *CF_removeglobal(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_removeglobal(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg1 = args[0];
@@ -625,7 +624,7 @@ static Object *CF_removeglobal(const std::vector<Object *> &args, Runtime *rt, b
     return rt->protectedNothing();
 }
 
-static Object *CF_sharedlibrary(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_sharedlibrary(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg1 = args[0];
@@ -681,7 +680,7 @@ static Object *CF_sharedlibrary(const std::vector<Object *> &args, Runtime *rt,
     return res;
 }
 
-static Object *CF_load(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_load(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg1 = args[0];
@@ -727,14 +726,18 @@ static Object *CF_load(const std::vector<Object *> &args, Runtime *rt, bool exec
         token.nameid = rt->nmgr->getId(token.data);
     }
     auto program = parser->parse(tokens);
+    if (rt->isOptimizerEnabled()) {
+        program = Optimizer(rt->nmgr).optimize(program);
+    }
+    Resolver().resolve(program);
 
     auto id = rt->nmgr->getId("load: " + path.string());
     rt->setGlobal(id, rt->protectedNothing());
 
     rt->newScopeFrame(false);
     rt->newContext();
-    rt->getContext().area = program->text_area;
-    auto res              = rt->execute(program, true);
+    rt->setContextArea(program->text_area);
+    auto res = rt->execute(program, true);
     rt->popContext();
     rt->popScopeFrame();
 
@@ -744,7 +747,7 @@ static Object *CF_load(const std::vector<Object *> &args, Runtime *rt, bool exec
 }
 
 // smartrun(file) - runs file if it hasn't been run before; returns the result of running it.
-static Object *CF_smartrun(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_smartrun(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg1 = args[0];
@@ -772,6 +775,10 @@ static Object *CF_smartrun(const std::vector<Object *> &args, Runtime *rt, bool
         token.nameid = rt->nmgr->getId(token.data);
     }
     auto program = parser.parse(tokens);
+    if (rt->isOptimizerEnabled()) {
+        program = Optimizer(rt->nmgr).optimize(program);
+    }
+    Resolver().resolve(program);
     rt->setGlobal(id, rt->protectedNothing());
 
     rt->newScopeFrame();
@@ -784,7 +791,7 @@ static Object *CF_smartrun(const std::vector<Object *> &args, Runtime *rt, bool
 }
 
 // dumbrun(file) - runs file and returns the result of running it.
-static Object *CF_dumbrun(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_dumbrun(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg1 = args[0];
@@ -807,6 +814,10 @@ static Object *CF_dumbrun(const std::vector<Object *> &args, Runtime *rt, bool e
         token.nameid = rt->nmgr->getId(token.data);
     }
     auto program = parser.parse(tokens);
+    if (rt->isOptimizerEnabled()) {
+        program = Optimizer(rt->nmgr).optimize(program);
+    }
+    Resolver().resolve(program);
 
     rt->newScopeFrame();
     auto res = rt->execute(program, true);
@@ -817,7 +828,7 @@ static Object *CF_dumbrun(const std::vector<Object *> &args, Runtime *rt, bool e
 }
 
 //  loadlibrary(file) - loads C++ shared library
-static Object *CF_loadlibrary(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_loadlibrary(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg1 = args[0];
@@ -852,7 +863,7 @@ static Object *CF_loadlibrary(const std::vector<Object *> &args, Runtime *rt, bo
 }
 
 // swap(a, b) - swaps a and b
-static Object *CF_swap(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_swap(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 2);
     auto first  = args[0];
@@ -865,7 +876,7 @@ static Object *CF_swap(const std::vector<Object *> &args, Runtime *rt, bool exec
 }
 
 // hide(str) - removes first found variable with name str
-static Object *CF_hide(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_hide(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto str = args[0];
@@ -895,7 +906,7 @@ static Object *CF_hide(const std::vector<Object *> &args, Runtime *rt, bool exec
 }
 
 // unlockscope() - removes limitation of not being able to access the previous scope of the current function
-static Object *CF_unlockscope(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_unlockscope(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 0);
 
@@ -915,7 +926,7 @@ static Object *CF_unlockscope(const std::vector<Object *> &args, Runtime *rt, bo
 }
 
 // lockscope() - adds limitation of not being able to access the previous scope of the current function
-static Object *CF_lockscope(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_lockscope(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 0);
 
@@ -935,7 +946,7 @@ static Object *CF_lockscope(const std::vector<Object *> &args, Runtime *rt, bool
 }
 
 // cfastio() - enables fast C io
-static Object *CF_cfastio(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_cfastio(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 0);
     std::ios_base::sync_with_stdio(0);
@@ -945,7 +956,7 @@ static Object *CF_cfastio(const std::vector<Object *> &args, Runtime *rt, bool e
 }
 
 // abs(x) - returns absolute value of x
-static Object *CF_abs(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_abs(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 1);
     auto arg = args[0];
@@ -960,7 +971,7 @@ static Object *CF_abs(const std::vector<Object *> &args, Runtime *rt, bool execu
 }
 
 // max(a, b) - returns max value of a and b
-static Object *CF_max(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_max(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 2);
     auto arg1 = args[0];
@@ -975,7 +986,7 @@ static Object *CF_max(const std::vector<Object *> &args, Runtime *rt, bool execu
 }
 
 // min(a, b) - returns min value of a and b
-static Object *CF_min(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *CF_min(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountFunc(args, 2);
     auto arg1 = args[0];
@@ -24,9 +24,13 @@
 #include "array.h"
 #include "boolean.h"
 #include "character.h"
+#include "dict.h"
 #include "function.h"
 #include "integer.h"
 #include "nothing.h"
 #include "real.h"
+#include "set.h"
 #include "string.h"
 #include "record.h"
+#include "weakmap.h"
+#include "weakref.h"
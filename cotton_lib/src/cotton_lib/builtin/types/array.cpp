@@ -41,6 +41,7 @@ Instance *ArrayInstance::copy(Runtime *rt) {
     if (res == nullptr) {
         rt->signalError("Failed to copy " + this->userRepr(rt), rt->getContext().area);
     }
+    GCResizeGuard guard(rt->getGC(), res);
     for (auto obj : this->data) {
         ((ArrayInstance *)res)->data.push_back(rt->copy(obj));
     }
@@ -57,16 +58,14 @@ std::string ArrayInstance::userRepr(Runtime *rt) {
 
 size_t ArrayInstance::getSize() {
     ProfilerCAPTURE();
-    return sizeof(ArrayInstance);
+    return sizeof(ArrayInstance) + this->data.capacity() * sizeof(Object *);
 }
 
-std::vector<Object *> ArrayInstance::getGCReachable() {
+void ArrayInstance::trace(GCVisitor &visitor) {
     ProfilerCAPTURE();
-    auto res = Instance::getGCReachable();
     for (auto obj : this->data) {
-        res.push_back(obj);
+        visitor.visit(obj);
     }
-    return res;
 }
 
 void ArrayInstance::spreadSingleUse() {
@@ -88,7 +87,7 @@ size_t ArrayType::getInstanceSize() {
     return sizeof(ArrayInstance);
 }
 
-static Object *ArrayIndexAdapter(Object *self, const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *ArrayIndexAdapter(Object *self, ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
 
     rt->verifyExactArgsAmountFunc(args, 1);
@@ -151,7 +150,7 @@ static Object *ArrayNeqAdapter(Object *self, Object *arg, Runtime *rt, bool exec
     return rt->protectedBoolean(!getBooleanValueFast(res));
 }
 
-static Object *arraySizeMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arraySizeMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -163,7 +162,7 @@ static Object *arraySizeMethod(const std::vector<Object *> &args, Runtime *rt, b
     return makeIntegerInstanceObject(getArrayDataFast(self).size(), rt);
 }
 
-static Object *arrayResizeMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayResizeMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self     = args[0];
@@ -176,11 +175,13 @@ static Object *arrayResizeMethod(const std::vector<Object *> &args, Runtime *rt,
     if (newn <= 0) {
         rt->signalError("New array size must be positive: " + new_size->userRepr(rt), rt->getContext().sub_areas[1]);
     }
+    GCResizeGuard guard(rt->getGC(), self->instance);
     getArrayDataFast(self).resize(newn);
 
     for (int64_t i = oldn; i < newn; i++) {
         getArrayDataFast(self)[i] = makeNothingInstanceObject(rt);
     }
+    rt->getGC()->writeBarrier(self->instance);
 
     if (!self->single_use) {
         self->spreadMultiUse();
@@ -189,20 +190,22 @@ static Object *arrayResizeMethod(const std::vector<Object *> &args, Runtime *rt,
     return self;
 }
 
-static Object *arrayAppendMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayAppendMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyMinArgsAmountMethod(args, 1);
     auto self = args[0];
 
-    auto &data = getArrayDataFast(self);
+    auto         &data = getArrayDataFast(self);
+    GCResizeGuard guard(rt->getGC(), self->instance);
     for (int64_t i = 1; i < args.size(); i++) {
         rt->verifyIsValidObject(args[i], MethodArgCtx(i));
         data.push_back(args[i]);
     }
+    rt->getGC()->writeBarrier(self->instance);
     return self;
 }
 
-static Object *arrayPrependMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayPrependMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyMinArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -216,11 +219,13 @@ static Object *arrayPrependMethod(const std::vector<Object *> &args, Runtime *rt
     for (auto &item : data) {
         pref.push_back(item);
     }
+    GCResizeGuard guard(rt->getGC(), self->instance);
     data = pref;
+    rt->getGC()->writeBarrier(self->instance);
     return self;
 }
 
-static Object *arrayPoplastMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayPoplastMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -233,7 +238,7 @@ static Object *arrayPoplastMethod(const std::vector<Object *> &args, Runtime *rt
     return self;
 }
 
-static Object *arrayPopfirstMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayPopfirstMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -246,7 +251,7 @@ static Object *arrayPopfirstMethod(const std::vector<Object *> &args, Runtime *r
     return self;
 }
 
-static Object *arrayFirstMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayFirstMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -258,7 +263,7 @@ static Object *arrayFirstMethod(const std::vector<Object *> &args, Runtime *rt,
     return data[0];
 }
 
-static Object *arrayLastMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayLastMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -270,7 +275,7 @@ static Object *arrayLastMethod(const std::vector<Object *> &args, Runtime *rt, b
     return data.back();
 }
 
-static Object *arrayEmptyMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayEmptyMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -279,7 +284,7 @@ static Object *arrayEmptyMethod(const std::vector<Object *> &args, Runtime *rt,
     return rt->protectedBoolean(data.empty());
 }
 
-static Object *arrayClearMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayClearMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -289,7 +294,7 @@ static Object *arrayClearMethod(const std::vector<Object *> &args, Runtime *rt,
     return self;
 }
 
-static Object *arrayCopyMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayCopyMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -297,7 +302,7 @@ static Object *arrayCopyMethod(const std::vector<Object *> &args, Runtime *rt, b
     return rt->copy(self);
 }
 
-static Object *arrayFilterMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayFilterMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -311,18 +316,20 @@ static Object *arrayFilterMethod(const std::vector<Object *> &args, Runtime *rt,
     rt->getContext().area      = ctx.area;
     rt->getContext().sub_areas = {ctx.area, ctx.area};
     for (auto &obj : getArrayDataFast(self)) {
-        auto res = rt->runOperator(OperatorNode::CALL, arg, std::vector<Object *> {obj}, true);
+        Object *call_args[] = {obj};
+        auto    res         = rt->runOperator(OperatorNode::CALL, arg, call_args, true);
         if (getBooleanValue(res, rt)) {
             new_data.push_back(obj);
         }
     }
     rt->popContext();
 
+    GCResizeGuard guard(rt->getGC(), self->instance);
     getArrayDataFast(self) = new_data;
     return self;
 }
 
-static Object *arrayApplyMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayApplyMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -335,14 +342,15 @@ static Object *arrayApplyMethod(const std::vector<Object *> &args, Runtime *rt,
     rt->getContext().area      = ctx.area;
     rt->getContext().sub_areas = {ctx.area, ctx.area};
     for (auto &obj : getArrayDataFast(self)) {
-        rt->runOperator(OperatorNode::CALL, arg, std::vector<Object *> {obj}, true);
+        Object *call_args[] = {obj};
+        rt->runOperator(OperatorNode::CALL, arg, call_args, true);
     }
     rt->popContext();
 
     return self;
 }
 
-static Object *arrayReverseMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayReverseMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -351,7 +359,7 @@ static Object *arrayReverseMethod(const std::vector<Object *> &args, Runtime *rt
     return self;
 }
 
-static Object *arraySortMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arraySortMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -364,14 +372,15 @@ static Object *arraySortMethod(const std::vector<Object *> &args, Runtime *rt, b
     rt->getContext().area      = ctx.area;
     rt->getContext().sub_areas = {ctx.area, ctx.area};
     std::sort(getArrayDataFast(self).begin(), getArrayDataFast(self).end(), [rt, arg](const auto &a, const auto &b) {
-        auto res = rt->runOperator(OperatorNode::CALL, arg, std::vector<Object *> {a, b}, true);
+        Object *call_args[] = {a, b};
+        auto    res         = rt->runOperator(OperatorNode::CALL, arg, call_args, true);
         return getBooleanValue(res, rt);
     });
     rt->popContext();
     return self;
 }
 
-static Object *arrayCombineMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayCombineMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 2);
     auto self = args[0];
@@ -386,13 +395,14 @@ static Object *arrayCombineMethod(const std::vector<Object *> &args, Runtime *rt
     rt->getContext().area      = ctx.area;
     rt->getContext().sub_areas = {ctx.area, ctx.area};
     for (auto obj : getArrayDataFast(self)) {
-        init = rt->runOperator(OperatorNode::CALL, arg, std::vector<Object *> {init, obj}, true);
+        Object *call_args[] = {init, obj};
+        init                = rt->runOperator(OperatorNode::CALL, arg, call_args, true);
     }
     rt->popContext();
     return init;
 }
 
-static Object *arrayFindfirstfMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayFindfirstfMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -405,7 +415,8 @@ static Object *arrayFindfirstfMethod(const std::vector<Object *> &args, Runtime
     rt->getContext().area      = ctx.area;
     rt->getContext().sub_areas = {ctx.area, ctx.area};
     for (auto obj : getArrayDataFast(self)) {
-        auto res = rt->runOperator(OperatorNode::CALL, arg, std::vector<Object *> {obj}, true);
+        Object *call_args[] = {obj};
+        auto    res         = rt->runOperator(OperatorNode::CALL, arg, call_args, true);
         if (getBooleanValue(res, rt)) {
             rt->popContext();
             return obj;
@@ -415,7 +426,7 @@ static Object *arrayFindfirstfMethod(const std::vector<Object *> &args, Runtime
     return rt->protectedNothing();
 }
 
-static Object *arrayFindlastfMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayFindlastfMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -428,7 +439,8 @@ static Object *arrayFindlastfMethod(const std::vector<Object *> &args, Runtime *
     rt->getContext().area      = ctx.area;
     rt->getContext().sub_areas = {ctx.area, ctx.area};
     for (auto it = getArrayDataFast(self).rbegin(); it != getArrayDataFast(self).rend(); it++) {
-        auto res = rt->runOperator(OperatorNode::CALL, arg, std::vector<Object *> {*it}, true);
+        Object *call_args[] = {*it};
+        auto    res         = rt->runOperator(OperatorNode::CALL, arg, call_args, true);
         if (getBooleanValue(res, rt)) {
             rt->popContext();
             return *it;
@@ -438,7 +450,7 @@ static Object *arrayFindlastfMethod(const std::vector<Object *> &args, Runtime *
     return rt->protectedNothing();
 }
 
-static Object *arrayLocatefirstfMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayLocatefirstfMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -452,7 +464,8 @@ static Object *arrayLocatefirstfMethod(const std::vector<Object *> &args, Runtim
     rt->getContext().sub_areas = {ctx.area, ctx.area};
     int64_t pos                = 0;
     for (auto obj : getArrayDataFast(self)) {
-        auto res = rt->runOperator(OperatorNode::CALL, arg, std::vector<Object *> {obj}, true);
+        Object *call_args[] = {obj};
+        auto    res         = rt->runOperator(OperatorNode::CALL, arg, call_args, true);
         if (getBooleanValue(res, rt)) {
             rt->popContext();
             return makeIntegerInstanceObject(pos, rt);
@@ -463,7 +476,7 @@ static Object *arrayLocatefirstfMethod(const std::vector<Object *> &args, Runtim
     return makeIntegerInstanceObject(getArrayDataFast(self).size(), rt);
 }
 
-static Object *arrayLocatelastfMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayLocatelastfMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -477,7 +490,8 @@ static Object *arrayLocatelastfMethod(const std::vector<Object *> &args, Runtime
     rt->getContext().sub_areas = {ctx.area, ctx.area};
     int64_t pos                = getArrayDataFast(self).size() - 1;
     for (auto it = getArrayDataFast(self).rbegin(); it != getArrayDataFast(self).rend(); it++) {
-        auto res = rt->runOperator(OperatorNode::CALL, arg, std::vector<Object *> {*it}, true);
+        Object *call_args[] = {*it};
+        auto    res         = rt->runOperator(OperatorNode::CALL, arg, call_args, true);
         if (getBooleanValue(res, rt)) {
             rt->popContext();
             return makeIntegerInstanceObject(pos, rt);
@@ -488,7 +502,7 @@ static Object *arrayLocatelastfMethod(const std::vector<Object *> &args, Runtime
     return makeIntegerInstanceObject(getArrayDataFast(self).size(), rt);
 }
 
-static Object *arrayFindfirstMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayFindfirstMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -512,7 +526,7 @@ static Object *arrayFindfirstMethod(const std::vector<Object *> &args, Runtime *
     return rt->protectedNothing();
 }
 
-static Object *arrayFindlastMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayFindlastMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -536,7 +550,7 @@ static Object *arrayFindlastMethod(const std::vector<Object *> &args, Runtime *r
     return rt->protectedNothing();
 }
 
-static Object *arrayLocatefirstMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayLocatefirstMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -562,7 +576,7 @@ static Object *arrayLocatefirstMethod(const std::vector<Object *> &args, Runtime
     return makeIntegerInstanceObject(getArrayDataFast(self).size(), rt);
 }
 
-static Object *arrayLocatelastMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayLocatelastMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -588,7 +602,7 @@ static Object *arrayLocatelastMethod(const std::vector<Object *> &args, Runtime
     return makeIntegerInstanceObject(getArrayDataFast(self).size(), rt);
 }
 
-static Object *arrayAllMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayAllMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -601,7 +615,8 @@ static Object *arrayAllMethod(const std::vector<Object *> &args, Runtime *rt, bo
     rt->getContext().area      = ctx.area;
     rt->getContext().sub_areas = {ctx.area, ctx.area};
     for (auto obj : getArrayDataFast(self)) {
-        auto res = rt->runOperator(OperatorNode::CALL, arg, std::vector<Object *> {obj}, true);
+        Object *call_args[] = {obj};
+        auto    res         = rt->runOperator(OperatorNode::CALL, arg, call_args, true);
         if (!getBooleanValue(res, rt)) {
             rt->popContext();
             return rt->protectedBoolean(false);
@@ -611,7 +626,7 @@ static Object *arrayAllMethod(const std::vector<Object *> &args, Runtime *rt, bo
     return rt->protectedBoolean(true);
 }
 
-static Object *arrayAnyMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayAnyMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -624,7 +639,8 @@ static Object *arrayAnyMethod(const std::vector<Object *> &args, Runtime *rt, bo
     rt->getContext().area      = ctx.area;
     rt->getContext().sub_areas = {ctx.area, ctx.area};
     for (auto obj : getArrayDataFast(self)) {
-        auto res = rt->runOperator(OperatorNode::CALL, arg, std::vector<Object *> {obj}, true);
+        Object *call_args[] = {obj};
+        auto    res         = rt->runOperator(OperatorNode::CALL, arg, call_args, true);
         if (getBooleanValue(res, rt)) {
             rt->popContext();
             return rt->protectedBoolean(true);
@@ -634,7 +650,7 @@ static Object *arrayAnyMethod(const std::vector<Object *> &args, Runtime *rt, bo
     return rt->protectedBoolean(false);
 }
 
-static Object *arrayNoneMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayNoneMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -647,7 +663,8 @@ static Object *arrayNoneMethod(const std::vector<Object *> &args, Runtime *rt, b
     rt->getContext().area      = ctx.area;
     rt->getContext().sub_areas = {ctx.area, ctx.area};
     for (auto obj : getArrayDataFast(self)) {
-        auto res = rt->runOperator(OperatorNode::CALL, arg, std::vector<Object *> {obj}, true);
+        Object *call_args[] = {obj};
+        auto    res         = rt->runOperator(OperatorNode::CALL, arg, call_args, true);
         if (getBooleanValue(res, rt)) {
             rt->popContext();
             return rt->protectedBoolean(false);
@@ -657,7 +674,7 @@ static Object *arrayNoneMethod(const std::vector<Object *> &args, Runtime *rt, b
     return rt->protectedBoolean(true);
 }
 
-static Object *arrayCountfMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayCountfMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -671,7 +688,8 @@ static Object *arrayCountfMethod(const std::vector<Object *> &args, Runtime *rt,
     rt->getContext().area      = ctx.area;
     rt->getContext().sub_areas = {ctx.area, ctx.area};
     for (auto obj : getArrayDataFast(self)) {
-        auto res = rt->runOperator(OperatorNode::CALL, arg, std::vector<Object *> {obj}, true);
+        Object *call_args[] = {obj};
+        auto    res         = rt->runOperator(OperatorNode::CALL, arg, call_args, true);
         if (getBooleanValue(res, rt)) {
             ans++;
         }
@@ -680,7 +698,7 @@ static Object *arrayCountfMethod(const std::vector<Object *> &args, Runtime *rt,
     return makeIntegerInstanceObject(ans, rt);
 }
 
-static Object *arrayCountMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arrayCountMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -703,7 +721,7 @@ static Object *arrayCountMethod(const std::vector<Object *> &args, Runtime *rt,
     return makeIntegerInstanceObject(ans, rt);
 }
 
-static Object *arraySliceMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *arraySliceMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 2);
     auto self  = args[0];
@@ -735,7 +753,7 @@ static Object *arraySliceMethod(const std::vector<Object *> &args, Runtime *rt,
     return makeArrayInstanceObject(subarr, rt);
 }
 
-static Object *array_mm__repr__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *array_mm__repr__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -751,13 +769,13 @@ static Object *array_mm__repr__(const std::vector<Object *> &args, Runtime *rt,
     auto       &arr = getArrayDataFast(self);
     std::string res = "{";
     if (arr.size() != 0) {
-        auto o = rt->runMethod(MagicMethods::mm__repr__(rt), arr[0], {arr[0]}, true);
+        auto o = rt->runMagicMethod(MagicMethods::MM_REPR, arr[0], ArgSpan(&arr[0], 1), true);
         rt->verifyIsInstanceObject(o, rt->builtin_types.string, Runtime::AREA_CTX);
         res += getStringDataFast(o);
     }
 
     for (int64_t i = 1; i < arr.size(); i++) {
-        auto o = rt->runMethod(MagicMethods::mm__repr__(rt), arr[i], {arr[i]}, true);
+        auto o = rt->runMagicMethod(MagicMethods::MM_REPR, arr[i], ArgSpan(&arr[i], 1), true);
         rt->verifyIsInstanceObject(o, rt->builtin_types.string, Runtime::AREA_CTX);
         res += ", " + getStringDataFast(o);
     }
@@ -815,7 +833,7 @@ ArrayType::ArrayType(Runtime *rt)
 Object *ArrayType::create(Runtime *rt) {
     ProfilerCAPTURE();
     Instance *ins = new ArrayInstance(rt);
-    Object   *obj = new Object(true, ins, this, rt);
+    Object   *obj = new (rt) Object(true, ins, this, rt);
     return obj;
 }
 
@@ -823,10 +841,10 @@ Object *ArrayType::copy(Object *obj, Runtime *rt) {
     ProfilerCAPTURE();
     rt->verifyIsOfType(obj, rt->builtin_types.array);
     if (obj->instance == nullptr) {
-        return new Object(false, nullptr, this, rt);
+        return new (rt) Object(false, nullptr, this, rt);
     }
     auto ins = obj->instance->copy(rt);
-    auto res = new Object(true, ins, this, rt);
+    auto res = new (rt) Object(true, ins, this, rt);
     return res;
 }
 
@@ -852,7 +870,8 @@ std::vector<Object *> &getArrayData(Object *obj, Runtime *rt, Runtime::ContextId
 
 Object *makeArrayInstanceObject(const std::vector<Object *> &data, Runtime *rt) {
     ProfilerCAPTURE();
-    auto res              = rt->make(rt->builtin_types.array, Runtime::INSTANCE_OBJECT);
+    auto          res = rt->make(rt->builtin_types.array, Runtime::INSTANCE_OBJECT);
+    GCResizeGuard guard(rt->getGC(), res->instance);
     getArrayDataFast(res) = data;
     return res;
 }
@@ -35,7 +35,7 @@ public:
     Instance             *copy(Runtime *rt);
     size_t                getSize();
     std::string           userRepr(Runtime *rt);
-    std::vector<Object *> getGCReachable();
+    void                  trace(GCVisitor &visitor);
     void                  spreadSingleUse();
     void                  spreadMultiUse();
 };
@@ -25,7 +25,7 @@
 
 namespace Cotton::Builtin {
 BooleanInstance::BooleanInstance(Runtime *rt)
-    : Instance(rt, sizeof(BooleanInstance)) {
+    : SlabInstance(rt, sizeof(BooleanInstance)) {
     ProfilerCAPTURE();
     this->value = false;
 }
@@ -36,7 +36,7 @@ BooleanInstance::~BooleanInstance() {
 
 Instance *BooleanInstance::copy(Runtime *rt) {
     ProfilerCAPTURE();
-    Instance *res = new BooleanInstance(rt);
+    Instance *res = new (rt) BooleanInstance(rt);
     if (res == nullptr) {
         rt->signalError("Failed to copy " + this->userRepr(rt), rt->getContext().area);
     }
@@ -115,7 +115,7 @@ static Object *BooleanOrAdapter(Object *self, Object *arg, Runtime *rt, bool exe
     return rt->protectedBoolean(getBooleanValueFast(self) || getBooleanValueFast(arg));
 }
 
-static Object *boolean_mm__bool__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *boolean_mm__bool__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -131,7 +131,7 @@ static Object *boolean_mm__bool__(const std::vector<Object *> &args, Runtime *rt
     return self;
 }
 
-static Object *boolean_mm__char__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *boolean_mm__char__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -143,7 +143,7 @@ static Object *boolean_mm__char__(const std::vector<Object *> &args, Runtime *rt
     return makeCharacterInstanceObject('0' + getBooleanValueFast(self), rt);
 }
 
-static Object *boolean_mm__int__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *boolean_mm__int__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -155,7 +155,7 @@ static Object *boolean_mm__int__(const std::vector<Object *> &args, Runtime *rt,
     return makeIntegerInstanceObject(getBooleanValueFast(self), rt);
 }
 
-static Object *boolean_mm__real__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *boolean_mm__real__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -167,7 +167,7 @@ static Object *boolean_mm__real__(const std::vector<Object *> &args, Runtime *rt
     return makeRealInstanceObject(getBooleanValueFast(self), rt);
 }
 
-static Object *boolean_mm__string__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *boolean_mm__string__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -184,7 +184,7 @@ static Object *boolean_mm__string__(const std::vector<Object *> &args, Runtime *
     return makeStringInstanceObject(getBooleanValueFast(self) ? "true" : "false", rt);
 }
 
-static Object *boolean_mm__repr__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *boolean_mm__repr__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -201,7 +201,7 @@ static Object *boolean_mm__repr__(const std::vector<Object *> &args, Runtime *rt
     return makeStringInstanceObject(getBooleanValueFast(self) ? "true" : "false", rt);
 }
 
-static Object *boolean_mm__read__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *boolean_mm__read__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -247,8 +247,8 @@ BooleanType::BooleanType(Runtime *rt)
 
 Object *BooleanType::create(Runtime *rt) {
     ProfilerCAPTURE();
-    Instance *ins = new BooleanInstance(rt);
-    Object   *obj = new Object(true, ins, this, rt);
+    Instance *ins = new (rt) BooleanInstance(rt);
+    Object   *obj = new (rt) Object(true, ins, this, rt);
     return obj;
 }
 
@@ -256,10 +256,10 @@ Object *BooleanType::copy(Object *obj, Runtime *rt) {
     ProfilerCAPTURE();
     rt->verifyIsOfType(obj, rt->builtin_types.boolean);
     if (obj->instance == nullptr) {
-        return new Object(false, nullptr, this, rt);
+        return new (rt) Object(false, nullptr, this, rt);
     }
     auto ins = obj->instance->copy(rt);
-    auto res = new Object(true, ins, this, rt);
+    auto res = new (rt) Object(true, ins, this, rt);
     return res;
 }
 
@@ -283,6 +283,25 @@ bool &getBooleanValue(Object *obj, Runtime *rt, Runtime::ContextId ctx_id) {
     return icast(obj->instance, Cotton::Builtin::BooleanInstance)->value;
 }
 
+bool runBooleanImmediateOperator(OperatorNode::OperatorId id, bool self, Value &res) {
+    ProfilerCAPTURE();
+    switch (id) {
+    case OperatorNode::NOT : res = Value::makeBoolean(!self); return true;
+    default : return false;
+    }
+}
+
+bool runBooleanImmediateOperator(OperatorNode::OperatorId id, bool self, bool arg, Value &res) {
+    ProfilerCAPTURE();
+    switch (id) {
+    case OperatorNode::EQUAL : res = Value::makeBoolean(self == arg); return true;
+    case OperatorNode::NOT_EQUAL : res = Value::makeBoolean(self != arg); return true;
+    case OperatorNode::AND : res = Value::makeBoolean(self && arg); return true;
+    case OperatorNode::OR : res = Value::makeBoolean(self || arg); return true;
+    default : return false;
+    }
+}
+
 Object *makeBooleanInstanceObject(bool value, Runtime *rt) {
     ProfilerCAPTURE();
     auto res                                     = rt->make(rt->builtin_types.boolean, Runtime::INSTANCE_OBJECT);
@@ -25,7 +25,7 @@
 
 namespace Cotton::Builtin {
 
-class BooleanInstance: public Instance {
+class BooleanInstance: public SlabInstance {
 public:
     bool value;
 
@@ -51,6 +51,18 @@ void installBooleanMethods(Type *type, Runtime *rt);
 
 Object *makeBooleanInstanceObject(bool value, Runtime *rt);
 
+/// @brief Immediate counterparts of the Boolean operator adapters. Return `false` if the operator must go through
+/// the adapters instead.
+bool runBooleanImmediateOperator(OperatorNode::OperatorId id, bool self, Value &res);
+bool runBooleanImmediateOperator(OperatorNode::OperatorId id, bool self, bool arg, Value &res);
+
+/// @brief Binary operators quickened for two booleans, as X(operator, Value maker, result). See getQuickOperator.
+#define BOOLEAN_QUICK_OPERATORS(X)                                                                                   \
+    X(EQUAL, makeBoolean, self.boolean == arg.boolean)                                                               \
+    X(NOT_EQUAL, makeBoolean, self.boolean != arg.boolean)                                                           \
+    X(AND, makeBoolean, self.boolean && arg.boolean)                                                                 \
+    X(OR, makeBoolean, self.boolean || arg.boolean)
+
 bool &getBooleanValue(Object *obj, Runtime *rt);
 bool &getBooleanValue(Object *obj, Runtime *rt, Runtime::ContextId ctx_id);
 #define getBooleanValueFast(obj) (icast(obj->instance, Cotton::Builtin::BooleanInstance)->value)
@@ -24,7 +24,7 @@
 
 namespace Cotton::Builtin {
 CharacterInstance::CharacterInstance(Runtime *rt)
-    : Instance(rt, sizeof(CharacterInstance)) {
+    : SlabInstance(rt, sizeof(CharacterInstance)) {
     ProfilerCAPTURE();
     this->value = '\0';
 }
@@ -35,7 +35,7 @@ CharacterInstance::~CharacterInstance() {
 
 Instance *CharacterInstance::copy(Runtime *rt) {
     ProfilerCAPTURE();
-    Instance *res = new CharacterInstance(rt);
+    Instance *res = new (rt) CharacterInstance(rt);
     if (res == nullptr) {
         rt->signalError("Failed to copy " + this->userRepr(rt), rt->getContext().area);
     }
@@ -242,7 +242,7 @@ static Object *CharacterNeqAdapter(Object *self, Object *arg, Runtime *rt, bool
     return rt->protectedBoolean(!getBooleanValueFast(res));
 }
 
-static Object *character_mm__bool__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *character_mm__bool__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -254,7 +254,7 @@ static Object *character_mm__bool__(const std::vector<Object *> &args, Runtime *
     return makeBooleanInstanceObject(getCharacterValueFast(self) != '0', rt);
 }
 
-static Object *character_mm__char__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *character_mm__char__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -266,7 +266,7 @@ static Object *character_mm__char__(const std::vector<Object *> &args, Runtime *
     return makeCharacterInstanceObject(getCharacterValueFast(self), rt);
 }
 
-static Object *character_mm__int__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *character_mm__int__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -278,7 +278,7 @@ static Object *character_mm__int__(const std::vector<Object *> &args, Runtime *r
     return makeIntegerInstanceObject(getCharacterValueFast(self), rt);
 }
 
-static Object *character_mm__real__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *character_mm__real__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -290,7 +290,7 @@ static Object *character_mm__real__(const std::vector<Object *> &args, Runtime *
     return makeRealInstanceObject(getCharacterValueFast(self), rt);
 }
 
-static Object *character_mm__string__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *character_mm__string__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -307,7 +307,7 @@ static Object *character_mm__string__(const std::vector<Object *> &args, Runtime
     return makeStringInstanceObject(std::string() + (char)getCharacterValueFast(self), rt);
 }
 
-static Object *character_mm__repr__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *character_mm__repr__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -324,7 +324,7 @@ static Object *character_mm__repr__(const std::vector<Object *> &args, Runtime *
     return makeStringInstanceObject(std::string("\'") + (char)getCharacterValueFast(self) + "\'", rt);
 }
 
-static Object *character_mm__read__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *character_mm__read__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -372,8 +372,8 @@ CharacterType::CharacterType(Runtime *rt)
 
 Object *CharacterType::create(Runtime *rt) {
     ProfilerCAPTURE();
-    Instance *ins = new CharacterInstance(rt);
-    Object   *obj = new Object(true, ins, this, rt);
+    Instance *ins = new (rt) CharacterInstance(rt);
+    Object   *obj = new (rt) Object(true, ins, this, rt);
     return obj;
 }
 
@@ -381,10 +381,10 @@ Object *CharacterType::copy(Object *obj, Runtime *rt) {
     ProfilerCAPTURE();
     rt->verifyIsOfType(obj, rt->builtin_types.character);
     if (obj->instance == nullptr) {
-        return new Object(false, nullptr, this, rt);
+        return new (rt) Object(false, nullptr, this, rt);
     }
     auto ins = obj->instance->copy(rt);
-    auto res = new Object(true, ins, this, rt);
+    auto res = new (rt) Object(true, ins, this, rt);
     return res;
 }
 
@@ -408,6 +408,30 @@ uint8_t &getCharacterValue(Object *obj, Runtime *rt, Runtime::ContextId ctx_id)
     return icast(obj->instance, Cotton::Builtin::CharacterInstance)->value;
 }
 
+bool runCharacterImmediateOperator(OperatorNode::OperatorId id, uint8_t self, Value &res) {
+    ProfilerCAPTURE();
+    switch (id) {
+    case OperatorNode::PRE_PLUS : res = Value::makeCharacter(self); return true;
+    case OperatorNode::PRE_MINUS : res = Value::makeCharacter(self * -1); return true;
+    default : return false;
+    }
+}
+
+bool runCharacterImmediateOperator(OperatorNode::OperatorId id, uint8_t self, uint8_t arg, Value &res) {
+    ProfilerCAPTURE();
+    switch (id) {
+    case OperatorNode::PLUS : res = Value::makeCharacter(self + arg); return true;
+    case OperatorNode::MINUS : res = Value::makeCharacter(self - arg); return true;
+    case OperatorNode::LESS : res = Value::makeBoolean(self < arg); return true;
+    case OperatorNode::LESS_EQUAL : res = Value::makeBoolean(self <= arg); return true;
+    case OperatorNode::GREATER : res = Value::makeBoolean(self > arg); return true;
+    case OperatorNode::GREATER_EQUAL : res = Value::makeBoolean(self >= arg); return true;
+    case OperatorNode::EQUAL : res = Value::makeBoolean(self == arg); return true;
+    case OperatorNode::NOT_EQUAL : res = Value::makeBoolean(self != arg); return true;
+    default : return false;
+    }
+}
+
 Object *makeCharacterInstanceObject(uint8_t value, Runtime *rt) {
     ProfilerCAPTURE();
     auto res                                       = rt->make(rt->builtin_types.character, Runtime::INSTANCE_OBJECT);
@@ -25,7 +25,7 @@
 
 namespace Cotton::Builtin {
 
-class CharacterInstance: public Instance {
+class CharacterInstance: public SlabInstance {
 public:
     uint8_t value;
 
@@ -49,6 +49,11 @@ public:
 
 Object *makeCharacterInstanceObject(uint8_t value, Runtime *rt);
 
+/// @brief Immediate counterparts of the Character operator adapters. Return `false` if the operator must go through
+/// the adapters instead.
+bool runCharacterImmediateOperator(OperatorNode::OperatorId id, uint8_t self, Value &res);
+bool runCharacterImmediateOperator(OperatorNode::OperatorId id, uint8_t self, uint8_t arg, Value &res);
+
 void installCharacterMethods(Type *type, Runtime *rt);
 
 uint8_t &getCharacterValue(Object *obj, Runtime *rt);
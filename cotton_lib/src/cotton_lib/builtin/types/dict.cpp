@@ -0,0 +1,307 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "dict.h"
+#include "../../profiler.h"
+#include "api.h"
+
+namespace Cotton::Builtin {
+DictInstance::DictInstance(Runtime *rt)
+    : Instance(rt, sizeof(DictInstance)) {
+    ProfilerCAPTURE();
+}
+
+DictInstance::~DictInstance() {
+    ProfilerCAPTURE();
+}
+
+Instance *DictInstance::copy(Runtime *rt) {
+    ProfilerCAPTURE();
+    auto res = new DictInstance(rt);
+
+    if (res == nullptr) {
+        rt->signalError("Failed to copy " + this->userRepr(rt), rt->getContext().area);
+    }
+    GCResizeGuard guard(rt->getGC(), res);
+    res->data.copyFrom(this->data, rt);
+    return res;
+}
+
+std::string DictInstance::userRepr(Runtime *rt) {
+    ProfilerCAPTURE();
+    if (this == nullptr) {
+        return "Dict(nullptr)";
+    }
+    return "Dict(size = " + std::to_string(this->data.live) + ", data = ...)";
+}
+
+size_t DictInstance::getSize() {
+    ProfilerCAPTURE();
+    return sizeof(DictInstance) + this->data.getBuffersSize();
+}
+
+void DictInstance::trace(GCVisitor &visitor) {
+    ProfilerCAPTURE();
+    this->data.trace(visitor);
+}
+
+void DictInstance::spreadSingleUse() {
+    ProfilerCAPTURE();
+    this->data.spreadSingleUse();
+}
+
+void DictInstance::spreadMultiUse() {
+    ProfilerCAPTURE();
+    this->data.spreadMultiUse();
+}
+
+size_t DictType::getInstanceSize() {
+    ProfilerCAPTURE();
+    return sizeof(DictInstance);
+}
+
+static Object *DictIndexAdapter(Object *self, ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+
+    rt->verifyExactArgsAmountFunc(args, 1);
+    auto &arg = args[0];
+    rt->verifyIsValidObject(arg, OperatorArgCtx(1));
+
+    auto &data = getDictDataFast(self);
+    auto  pos  = data.find(arg, hashKey(arg, rt), rt);
+    if (pos == -1) {
+        rt->signalError("Key " + arg->userRepr(rt) + " is not in dict " + self->userRepr(rt), rt->getContext().sub_areas[1]);
+    }
+    return data.entries[pos].value;
+}
+
+static Object *dictSetMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 2);
+    auto self  = args[0];
+    auto key   = args[1];
+    auto value = args[2];
+
+    rt->verifyIsValidObject(key, MethodArgCtx(0));
+    rt->verifyIsValidObject(value, MethodArgCtx(1));
+
+    auto &data = getDictDataFast(self);
+    auto  hash = hashKey(key, rt);
+    auto  pos  = data.find(key, hash, rt);
+    if (pos != -1) {
+        data.entries[pos].value = value;
+    }
+    else {
+        GCResizeGuard guard(rt->getGC(), self->instance);
+        data.insert({hash, key, value});
+    }
+    rt->getGC()->writeBarrier(self->instance);
+    return self;
+}
+
+static Object *dictGetMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 1);
+    auto self = args[0];
+    auto key  = args[1];
+
+    rt->verifyIsValidObject(key, MethodArgCtx(0));
+
+    auto &data = getDictDataFast(self);
+    auto  pos  = data.find(key, hashKey(key, rt), rt);
+    if (pos == -1) {
+        return rt->protectedNothing();
+    }
+    return data.entries[pos].value;
+}
+
+static Object *dictHasMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 1);
+    auto self = args[0];
+    auto key  = args[1];
+
+    rt->verifyIsValidObject(key, MethodArgCtx(0));
+
+    auto &data = getDictDataFast(self);
+    return rt->protectedBoolean(data.find(key, hashKey(key, rt), rt) != -1);
+}
+
+static Object *dictRemoveMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 1);
+    auto self = args[0];
+    auto key  = args[1];
+
+    rt->verifyIsValidObject(key, MethodArgCtx(0));
+
+    getDictDataFast(self).remove(key, hashKey(key, rt), rt);
+    return self;
+}
+
+static Object *dictSizeMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    if (!execution_result_matters) {
+        return nullptr;
+    }
+
+    return makeIntegerInstanceObject(getDictDataFast(self).live, rt);
+}
+
+static Object *dictEmptyMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    return rt->protectedBoolean(getDictDataFast(self).live == 0);
+}
+
+static Object *dictClearMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    getDictDataFast(self).clear();
+    return self;
+}
+
+static Object *dictKeysMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    // the keys are copied, changing them in place would break the table
+    std::vector<Object *> keys;
+    for (auto &entry : getDictDataFast(self).entries) {
+        if (entry.key != nullptr) {
+            keys.push_back(rt->copy(entry.key));
+        }
+    }
+    return makeArrayInstanceObject(keys, rt);
+}
+
+static Object *dictValuesMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    std::vector<Object *> values;
+    for (auto &entry : getDictDataFast(self).entries) {
+        if (entry.key != nullptr) {
+            values.push_back(entry.value);
+        }
+    }
+    return makeArrayInstanceObject(values, rt);
+}
+
+static Object *dict_mm__repr__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    if (!execution_result_matters) {
+        return self;
+    }
+
+    if (rt->isTypeObject(self, nullptr)) {
+        return makeStringInstanceObject("Dict", rt);
+    }
+
+    // __repr__ of the keys and values may change the dict, so the entries are taken by position
+    auto       &data  = getDictDataFast(self);
+    std::string res   = "{";
+    bool        first = true;
+    for (int64_t i = 0; i < data.entries.size(); i++) {
+        auto entry = data.entries[i];
+        if (entry.key == nullptr) {
+            continue;
+        }
+
+        if (!first) {
+            res += ", ";
+        }
+        first = false;
+
+        auto k = rt->runMagicMethod(MagicMethods::MM_REPR, entry.key, ArgSpan(&entry.key, 1), true);
+        rt->verifyIsInstanceObject(k, rt->builtin_types.string, Runtime::AREA_CTX);
+        res += getStringDataFast(k) + ": ";
+
+        auto v = rt->runMagicMethod(MagicMethods::MM_REPR, entry.value, ArgSpan(&entry.value, 1), true);
+        rt->verifyIsInstanceObject(v, rt->builtin_types.string, Runtime::AREA_CTX);
+        res += getStringDataFast(v);
+    }
+    res += "}";
+
+    return makeStringInstanceObject(res, rt);
+}
+
+void installDictMethods(Type *type, Runtime *rt) {
+    ProfilerCAPTURE();
+    type->addMethod(MagicMethods::mm__repr__(rt), Builtin::makeFunctionInstanceObject(true, dict_mm__repr__, nullptr, rt));
+    type->addMethod(MagicMethods::mm__string__(rt), Builtin::makeFunctionInstanceObject(true, dict_mm__repr__, nullptr, rt));
+
+    type->addMethod(rt->nmgr->getId("set"), makeFunctionInstanceObject(true, dictSetMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("get"), makeFunctionInstanceObject(true, dictGetMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("has"), makeFunctionInstanceObject(true, dictHasMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("remove"), makeFunctionInstanceObject(true, dictRemoveMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("size"), makeFunctionInstanceObject(true, dictSizeMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("empty"), makeFunctionInstanceObject(true, dictEmptyMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("clear"), makeFunctionInstanceObject(true, dictClearMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("keys"), makeFunctionInstanceObject(true, dictKeysMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("values"), makeFunctionInstanceObject(true, dictValuesMethod, nullptr, rt));
+}
+
+DictType::DictType(Runtime *rt)
+    : Type(rt) {
+    ProfilerCAPTURE();
+    this->index_op = DictIndexAdapter;
+}
+
+Object *DictType::create(Runtime *rt) {
+    ProfilerCAPTURE();
+    Instance *ins = new DictInstance(rt);
+    Object   *obj = new (rt) Object(true, ins, this, rt);
+    return obj;
+}
+
+Object *DictType::copy(Object *obj, Runtime *rt) {
+    ProfilerCAPTURE();
+    rt->verifyIsOfType(obj, rt->builtin_types.dict);
+    if (obj->instance == nullptr) {
+        return new (rt) Object(false, nullptr, this, rt);
+    }
+    auto ins = obj->instance->copy(rt);
+    auto res = new (rt) Object(true, ins, this, rt);
+    return res;
+}
+
+std::string DictType::userRepr(Runtime *rt) {
+    ProfilerCAPTURE();
+    if (this == nullptr) {
+        return "DictType(nullptr)";
+    }
+    return "DictType";
+}
+}    // namespace Cotton::Builtin
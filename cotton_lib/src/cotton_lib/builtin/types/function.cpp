@@ -24,7 +24,7 @@
 
 namespace Cotton::Builtin {
 FunctionInstance::FunctionInstance(Runtime *rt)
-    : Instance(rt, sizeof(FunctionInstance)) {
+    : SlabInstance(rt, sizeof(FunctionInstance)) {
     ProfilerCAPTURE();
     this->is_internal  = true;
     this->internal_ptr = nullptr;
@@ -44,7 +44,7 @@ void FunctionInstance::init(bool is_internal, InternalFunction internal_ptr, Fun
 
 Instance *FunctionInstance::copy(Runtime *rt) {
     ProfilerCAPTURE();
-    auto res = new FunctionInstance(rt);
+    auto res = new (rt) FunctionInstance(rt);
     if (res == nullptr) {
         rt->signalError("Failed to copy " + this->userRepr(rt), rt->getContext().area);
     }
@@ -70,7 +70,7 @@ size_t FunctionType::getInstanceSize() {
     return sizeof(FunctionInstance);
 }
 
-static Object *FunctionCallAdapter(Object *self, const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *FunctionCallAdapter(Object *self, ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
 
     auto f = icast(self->instance, FunctionInstance);
@@ -86,33 +86,52 @@ static Object *FunctionCallAdapter(Object *self, const std::vector<Object *> &ar
         return res;
     }
     else {
-        if (f->cotton_ptr == nullptr || f->cotton_ptr->body == nullptr) {
-            rt->signalError("Failed to execute nullptr function " + self->userRepr(rt), rt->getContext().area);
-        }
-        rt->newScopeFrame(false);
-        rt->getScope()->setIsFunctionCall(true);
-        // rt->getScope()->arguments.push_back(self); // is it needed?
-        for (auto arg : args) {
-            rt->getScope()->getArguments().push_back(arg);
-        }
-        if (f->cotton_ptr->params != nullptr) {
-            int i = 0;
-            for (auto token : f->cotton_ptr->params->list) {
-                if (i >= args.size()) {
-                    rt->getScope()->addVariable(token->nameid, makeNothingInstanceObject(rt), rt);
-                    continue;
+        // calls that the function makes in tail position are made here, one after another, instead of nesting. They
+        // are staged on the same argument stack slots, which keep the function and the arguments reachable
+        Object  *function  = self;
+        ArgSpan  call_args = args;
+        Object **slots     = nullptr;
+        size_t   capacity  = 0;
+        Object  *res;
+        while (true) {
+            auto cotton_ptr = icast(function->instance, FunctionInstance)->cotton_ptr;
+            if (cotton_ptr == nullptr || cotton_ptr->body == nullptr) {
+                rt->signalError("Failed to execute nullptr function " + function->userRepr(rt), rt->getContext().area);
+            }
+            rt->newScopeFrame(false, cotton_ptr->layout);
+            rt->getScope()->setIsFunctionCall(true);
+            rt->getScope()->setArguments(call_args);
+            if (cotton_ptr->params != nullptr) {
+                int i = 0;
+                for (auto token : cotton_ptr->params->list) {
+                    if (i >= call_args.size()) {
+                        rt->getScope()->addVariable(token->nameid, makeNothingInstanceObject(rt), rt);
+                        continue;
+                    }
+                    rt->getScope()->addVariable(token->nameid, call_args[i], rt);
+                    i++;
                 }
-                rt->getScope()->addVariable(token->nameid, args[i], rt);
-                i++;
             }
+            rt->newContext();
+            rt->setContextArea(cotton_ptr->body->text_area);
+            res = rt->execute(cotton_ptr->body, execution_result_matters);
+            rt->popContext();
+            rt->popScopeFrame();
+
+            if (!rt->takeTailCall(slots, capacity, call_args)) {
+                break;
+            }
+            function = slots[0];
         }
-        rt->newContext();
-        rt->getContext().area = f->cotton_ptr->body->text_area;
-        auto res              = rt->execute(f->cotton_ptr->body, execution_result_matters);
-        rt->popContext();
-        rt->popScopeFrame();
         if (execution_result_matters && res == nullptr) {
-            rt->signalError("Execution of function " + self->userRepr(rt) + " has failed", rt->getContext().sub_areas[0]);
+            rt->signalError("Execution of function " + function->userRepr(rt) + " has failed", rt->getContext().sub_areas[0]);
+        }
+        if (slots != nullptr) {
+            // the value of `return f()` is a copy of what f returns. the result may be one of the arguments
+            if (execution_result_matters) {
+                res = rt->copy(res);
+            }
+            rt->getArgStack()->pop(capacity);
         }
         return res;
     }
@@ -157,7 +176,7 @@ static Object *FunctionNeqAdapter(Object *self, Object *arg, Runtime *rt, bool e
     return rt->protectedBoolean(!getBooleanValueFast(res));
 }
 
-static Object *function_mm__repr__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *function_mm__repr__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -190,8 +209,8 @@ FunctionType::FunctionType(Runtime *rt)
 
 Object *FunctionType::create(Runtime *rt) {
     ProfilerCAPTURE();
-    auto    ins = new FunctionInstance(rt);
-    Object *obj = new Object(true, ins, this, rt);
+    auto    ins = new (rt) FunctionInstance(rt);
+    Object *obj = new (rt) Object(true, ins, this, rt);
     return obj;
 }
 
@@ -199,10 +218,10 @@ Object *FunctionType::copy(Object *obj, Runtime *rt) {
     ProfilerCAPTURE();
     rt->verifyIsOfType(obj, rt->builtin_types.function);
     if (obj->instance == nullptr) {
-        return new Object(false, nullptr, this, rt);
+        return new (rt) Object(false, nullptr, this, rt);
     }
     auto ins = obj->instance->copy(rt);
-    auto res = new Object(true, ins, this, rt);
+    auto res = new (rt) Object(true, ins, this, rt);
 
     return res;
 }
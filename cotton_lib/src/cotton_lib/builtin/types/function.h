@@ -25,9 +25,9 @@
 
 namespace Cotton::Builtin {
 
-typedef Object *(*InternalFunction)(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters);
+typedef Object *(*InternalFunction)(ArgSpan args, Runtime *rt, bool execution_result_matters);
 
-class FunctionInstance: public Instance {
+class FunctionInstance: public SlabInstance {
 public:
     bool             is_internal;
     InternalFunction internal_ptr;    // function written in C++
@@ -0,0 +1,280 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "hashtable.h"
+#include "../../profiler.h"
+#include "api.h"
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace Cotton::Builtin {
+
+// hashes of integers and characters are the values themselves, so the bits get mixed before the table masks them
+static size_t mixHash(size_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+// reals are keyed by their bits, so that 0.0 and -0.0 are different keys. Every NaN becomes the same key, otherwise a
+// NaN would never be equal to itself and its entry could not be found again
+static uint64_t realKeyBits(double value) {
+    if (std::isnan(value)) {
+        value = std::numeric_limits<double>::quiet_NaN();
+    }
+    return std::bit_cast<uint64_t>(value);
+}
+
+ObjectHashTable::ObjectHashTable() {
+    ProfilerCAPTURE();
+    this->live           = 0;
+    this->layout_version = 0;
+}
+
+int64_t ObjectHashTable::findSlot(Object *key, size_t hash, Runtime *rt) {
+    ProfilerCAPTURE();
+    if (this->index.empty()) {
+        return -1;
+    }
+
+    size_t mask    = this->index.size() - 1;
+    size_t version = this->layout_version;
+    size_t pos     = mixHash(hash) & mask;
+    for (size_t probes = 0; probes <= mask; probes++, pos = (pos + 1) & mask) {
+        auto slot = this->index[pos];
+        if (slot == EMPTY) {
+            return -1;
+        }
+        if (slot == REMOVED) {
+            continue;
+        }
+
+        auto entry = this->entries[slot];
+        if (entry.hash != hash || !keysEqual(entry.key, key, rt)) {
+            // __eq__ may have changed the table, in which case the search starts over
+            if (version != this->layout_version) {
+                return this->findSlot(key, hash, rt);
+            }
+            continue;
+        }
+        if (version != this->layout_version) {
+            return this->findSlot(key, hash, rt);
+        }
+        return pos;
+    }
+    return -1;
+}
+
+int64_t ObjectHashTable::find(Object *key, size_t hash, Runtime *rt) {
+    ProfilerCAPTURE();
+    auto pos = this->findSlot(key, hash, rt);
+    if (pos == -1) {
+        return -1;
+    }
+    return this->index[pos];
+}
+
+void ObjectHashTable::insert(const ObjectHashTableEntry &entry) {
+    ProfilerCAPTURE();
+    // removed entries count towards the load, otherwise the probe sequences would only get longer
+    if ((this->entries.size() + 1) * 4 > this->index.size() * 3) {
+        this->rehash();
+    }
+
+    size_t mask = this->index.size() - 1;
+    size_t pos  = mixHash(entry.hash) & mask;
+    while (this->index[pos] >= 0) {
+        pos = (pos + 1) & mask;
+    }
+    this->index[pos] = this->entries.size();
+    this->entries.push_back(entry);
+    this->live++;
+}
+
+void ObjectHashTable::rehash() {
+    ProfilerCAPTURE();
+    if (this->live < this->entries.size()) {
+        std::erase_if(this->entries, [](auto &entry) { return entry.key == nullptr; });
+    }
+
+    size_t size = 8;
+    while (size < (this->live + 1) * 2) {
+        size *= 2;
+    }
+    this->index.assign(size, EMPTY);
+
+    size_t mask = size - 1;
+    for (int64_t i = 0; i < this->entries.size(); i++) {
+        size_t pos = mixHash(this->entries[i].hash) & mask;
+        while (this->index[pos] != EMPTY) {
+            pos = (pos + 1) & mask;
+        }
+        this->index[pos] = i;
+    }
+    this->layout_version++;
+}
+
+bool ObjectHashTable::remove(Object *key, size_t hash, Runtime *rt) {
+    ProfilerCAPTURE();
+    auto pos = this->findSlot(key, hash, rt);
+    if (pos == -1) {
+        return false;
+    }
+    this->entries[this->index[pos]] = {0, nullptr, nullptr};
+    this->index[pos]                = REMOVED;
+    this->live--;
+    if (this->live == 0) {
+        this->clear();
+    }
+    return true;
+}
+
+void ObjectHashTable::clear() {
+    ProfilerCAPTURE();
+    this->entries.clear();
+    this->index.clear();
+    this->live = 0;
+    this->layout_version++;
+}
+
+size_t ObjectHashTable::getBuffersSize() {
+    ProfilerCAPTURE();
+    return this->entries.capacity() * sizeof(ObjectHashTableEntry) + this->index.capacity() * sizeof(int64_t);
+}
+
+void ObjectHashTable::copyFrom(const ObjectHashTable &other, Runtime *rt) {
+    ProfilerCAPTURE();
+    this->entries = other.entries;
+    this->index   = other.index;
+    this->live    = other.live;
+    this->layout_version++;
+    for (auto &entry : this->entries) {
+        if (entry.key != nullptr) {
+            entry.key = rt->copy(entry.key);
+        }
+        if (entry.value != nullptr) {
+            entry.value = rt->copy(entry.value);
+        }
+    }
+}
+
+void ObjectHashTable::trace(GCVisitor &visitor) {
+    ProfilerCAPTURE();
+    for (auto &entry : this->entries) {
+        visitor.visit(entry.key);
+        visitor.visit(entry.value);
+    }
+}
+
+void ObjectHashTable::spreadSingleUse() {
+    ProfilerCAPTURE();
+    for (auto &entry : this->entries) {
+        if (entry.key != nullptr) {
+            entry.key->spreadSingleUse();
+        }
+        if (entry.value != nullptr) {
+            entry.value->spreadSingleUse();
+        }
+    }
+}
+
+void ObjectHashTable::spreadMultiUse() {
+    ProfilerCAPTURE();
+    for (auto &entry : this->entries) {
+        if (entry.key != nullptr) {
+            entry.key->spreadMultiUse();
+        }
+        if (entry.value != nullptr) {
+            entry.value->spreadMultiUse();
+        }
+    }
+}
+
+size_t hashKey(Object *key, Runtime *rt) {
+    ProfilerCAPTURE();
+    auto &types = rt->builtin_types;
+    if (key->instance == nullptr) {
+        return GCPointerHash()(key->type);
+    }
+    if (key->type == types.integer) {
+        return std::hash<int64_t>()(getIntegerValueFast(key));
+    }
+    if (key->type == types.real) {
+        return std::hash<uint64_t>()(realKeyBits(getRealValueFast(key)));
+    }
+    if (key->type == types.character) {
+        return std::hash<uint8_t>()(getCharacterValueFast(key));
+    }
+    if (key->type == types.boolean) {
+        return std::hash<bool>()(getBooleanValueFast(key));
+    }
+    if (key->type == types.string) {
+        return std::hash<std::string>()(getStringDataFast(key));
+    }
+    if (key->type == types.nothing) {
+        return 0;
+    }
+
+    rt->verifyHasMagicMethod(key, MagicMethods::MM_HASH);
+    rt->verifyHasMagicMethod(key, MagicMethods::MM_EQ);
+    auto res = rt->runMagicMethod(MagicMethods::MM_HASH, key, ArgSpan(&key, 1), true);
+    rt->verifyIsInstanceObject(res, types.integer, Runtime::AREA_CTX);
+    return getIntegerValueFast(res);
+}
+
+bool keysEqual(Object *a, Object *b, Runtime *rt) {
+    ProfilerCAPTURE();
+    auto &types = rt->builtin_types;
+    if (a->type != b->type) {
+        return false;
+    }
+    if (a->instance == nullptr || b->instance == nullptr || a->instance == b->instance) {
+        return a->instance == b->instance;
+    }
+    if (a->type == types.integer) {
+        return getIntegerValueFast(a) == getIntegerValueFast(b);
+    }
+    if (a->type == types.real) {
+        return realKeyBits(getRealValueFast(a)) == realKeyBits(getRealValueFast(b));
+    }
+    if (a->type == types.character) {
+        return getCharacterValueFast(a) == getCharacterValueFast(b);
+    }
+    if (a->type == types.boolean) {
+        return getBooleanValueFast(a) == getBooleanValueFast(b);
+    }
+    if (a->type == types.string) {
+        return getStringDataFast(a) == getStringDataFast(b);
+    }
+    if (a->type == types.nothing) {
+        return true;
+    }
+
+    Object *args[] = {a, b};
+    auto    res    = rt->runMagicMethod(MagicMethods::MM_EQ, a, args, true);
+    return getBooleanValue(res, rt, Runtime::AREA_CTX);
+}
+}    // namespace Cotton::Builtin
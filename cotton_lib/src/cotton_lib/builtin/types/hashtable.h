@@ -0,0 +1,132 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+#include "../../back/api.h"
+#include "../../front/api.h"
+
+namespace Cotton::Builtin {
+
+/// @brief Entry of a hash table, see ObjectHashTable.
+class ObjectHashTableEntry {
+public:
+    size_t  hash;
+    Object *key;      // nullptr if the entry was removed
+    Object *value;    // nullptr for tables without values
+};
+
+/**
+ * @brief Open addressing hash table of objects, used by Dict and Set. Entries are kept in insertion order in
+ * `entries`, and `index` is a linearly probed table of positions in `entries`. Removed entries stay in place until the
+ * next rehash.
+ *
+ * Keys are hashed and compared with hashKey and keysEqual. The table doesn't own the objects, its owner has to trace
+ * them, see ObjectHashTable::trace.
+ */
+class ObjectHashTable {
+public:
+    static constexpr int64_t EMPTY   = -1;
+    static constexpr int64_t REMOVED = -2;
+
+    std::vector<ObjectHashTableEntry> entries;
+    std::vector<int64_t>        index;
+    size_t                      live;    // amount of entries that weren't removed
+
+    ObjectHashTable();
+
+    /**
+     * @brief Finds the entry with the given key.
+     *
+     * @param key The key. Must be valid.
+     * @param hash Hash of the key, see hashKey.
+     * @param rt The runtime. Must be valid.
+     * @return Position of the entry in `entries`, or -1 if there is no such entry.
+     */
+    int64_t find(Object *key, size_t hash, Runtime *rt);
+
+    /**
+     * @brief Adds a new entry. Doesn't call any methods of the key, so it can be done while the size of the owner is
+     * tracked, see GCResizeGuard.
+     *
+     * @param entry The entry. Its key must be valid and must not be in the table already, see find.
+     */
+    void insert(const ObjectHashTableEntry &entry);
+
+    /**
+     * @brief Removes the entry with the given key, if there is one.
+     *
+     * @param key The key. Must be valid.
+     * @param hash Hash of the key, see hashKey.
+     * @param rt The runtime. Must be valid.
+     * @return `true` if an entry was removed.
+     */
+    bool remove(Object *key, size_t hash, Runtime *rt);
+
+    /// @brief Removes all entries.
+    void clear();
+
+    /// @brief Returns the amount of bytes used by the buffers of the table.
+    size_t getBuffersSize();
+
+    /**
+     * @brief Makes this table a copy of another one, copying every key and value with Runtime::copy. Nothing gets
+     * hashed again.
+     *
+     * @param other The table to copy.
+     * @param rt The runtime. Must be valid.
+     */
+    void copyFrom(const ObjectHashTable &other, Runtime *rt);
+
+    void trace(GCVisitor &visitor);
+    void spreadSingleUse();
+    void spreadMultiUse();
+
+private:
+    size_t layout_version;    // changes whenever positions in `entries` or `index` become stale
+
+    int64_t findSlot(Object *key, size_t hash, Runtime *rt);
+    void    rehash();
+};
+
+/**
+ * @brief Hashes a key. Integer, Real, Character, Boolean, String and Nothing instances, as well as type objects, are
+ * hashed natively. Other instances must have both the __hash__ and the __eq__ methods, and __hash__ must return an
+ * Integer.
+ *
+ * @param key The key. Must be valid.
+ * @param rt The runtime. Must be valid.
+ * @return Hash of the key.
+ */
+size_t hashKey(Object *key, Runtime *rt);
+
+/**
+ * @brief Checks whether two keys are equal. Keys of different types are never equal. Reals are equal if their bits
+ * are, so 0.0 and -0.0 are different keys while all NaNs are the same key. Instances that can't be compared natively
+ * are compared with __eq__ of the first one, unless they share the instance.
+ *
+ * @param a The first key. Must be valid.
+ * @param b The second key. Must be valid.
+ * @param rt The runtime. Must be valid.
+ * @return `true` if the keys are equal.
+ */
+bool keysEqual(Object *a, Object *b, Runtime *rt);
+}    // namespace Cotton::Builtin
@@ -25,7 +25,7 @@
 
 namespace Cotton::Builtin {
 IntegerInstance::IntegerInstance(Runtime *rt)
-    : Instance(rt, sizeof(IntegerInstance)) {
+    : SlabInstance(rt, sizeof(IntegerInstance)) {
     ProfilerCAPTURE();
     this->value = 0;
 }
@@ -36,7 +36,7 @@ IntegerInstance::~IntegerInstance() {
 
 Instance *IntegerInstance::copy(Runtime *rt) {
     ProfilerCAPTURE();
-    Instance *res = new IntegerInstance(rt);
+    Instance *res = new (rt) IntegerInstance(rt);
 
     if (res == nullptr) {
         rt->signalError("Failed to copy " + this->userRepr(rt), rt->getContext().area);
@@ -343,7 +343,7 @@ static Object *IntegerBitorAdapter(Object *self, Object *arg, Runtime *rt, bool
     return res;
 }
 
-static Object *integer_mm__bool__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *integer_mm__bool__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -355,7 +355,7 @@ static Object *integer_mm__bool__(const std::vector<Object *> &args, Runtime *rt
     return rt->protectedBoolean(getIntegerValueFast(self));
 }
 
-static Object *integer_mm__char__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *integer_mm__char__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -367,7 +367,7 @@ static Object *integer_mm__char__(const std::vector<Object *> &args, Runtime *rt
     return makeCharacterInstanceObject(getIntegerValueFast(self), rt);
 }
 
-static Object *integer_mm__int__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *integer_mm__int__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -379,7 +379,7 @@ static Object *integer_mm__int__(const std::vector<Object *> &args, Runtime *rt,
     return makeIntegerInstanceObject(getIntegerValueFast(self), rt);
 }
 
-static Object *integer_mm__real__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *integer_mm__real__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -391,7 +391,7 @@ static Object *integer_mm__real__(const std::vector<Object *> &args, Runtime *rt
     return makeRealInstanceObject(getIntegerValueFast(self), rt);
 }
 
-static Object *integer_mm__string__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *integer_mm__string__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -403,7 +403,7 @@ static Object *integer_mm__string__(const std::vector<Object *> &args, Runtime *
     return makeStringInstanceObject(std::to_string(getIntegerValueFast(self)), rt);
 }
 
-static Object *integer_mm__repr__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *integer_mm__repr__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -420,7 +420,7 @@ static Object *integer_mm__repr__(const std::vector<Object *> &args, Runtime *rt
     return makeStringInstanceObject(std::to_string(getIntegerValueFast(self)), rt);
 }
 
-static Object *integer_mm__read__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *integer_mm__read__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -477,8 +477,8 @@ IntegerType::IntegerType(Runtime *rt)
 
 Object *IntegerType::create(Runtime *rt) {
     ProfilerCAPTURE();
-    Instance *ins = new IntegerInstance(rt);
-    Object   *obj = new Object(true, ins, this, rt);
+    Instance *ins = new (rt) IntegerInstance(rt);
+    Object   *obj = new (rt) Object(true, ins, this, rt);
     return obj;
 }
 
@@ -486,10 +486,10 @@ Object *IntegerType::copy(Object *obj, Runtime *rt) {
     ProfilerCAPTURE();
     rt->verifyIsOfType(obj, rt->builtin_types.integer);
     if (obj->instance == nullptr) {
-        return new Object(false, nullptr, this, rt);
+        return new (rt) Object(false, nullptr, this, rt);
     }
     auto ins = obj->instance->copy(rt);
-    auto res = new Object(true, ins, this, rt);
+    auto res = new (rt) Object(true, ins, this, rt);
     return res;
 }
 
@@ -513,6 +513,45 @@ int64_t &getIntegerValue(Object *obj, Runtime *rt, Runtime::ContextId ctx_id) {
     return icast(obj->instance, Cotton::Builtin::IntegerInstance)->value;
 }
 
+bool runIntegerImmediateOperator(OperatorNode::OperatorId id, int64_t self, Value &res) {
+    ProfilerCAPTURE();
+    switch (id) {
+    case OperatorNode::PRE_PLUS : res = Value::makeInteger(self); return true;
+    case OperatorNode::PRE_MINUS : res = Value::makeInteger(self * -1); return true;
+    case OperatorNode::INVERSE : res = Value::makeInteger(~self); return true;
+    default : return false;
+    }
+}
+
+bool runIntegerImmediateOperator(OperatorNode::OperatorId id, int64_t self, int64_t arg, Value &res) {
+    ProfilerCAPTURE();
+    switch (id) {
+    case OperatorNode::MULT : res = Value::makeInteger(self * arg); return true;
+    case OperatorNode::DIV :
+    case OperatorNode::REM :
+        // faulting divisions are left to the adapters
+        if (arg == 0 || (arg == -1 && self == INT64_MIN)) {
+            return false;
+        }
+        res = Value::makeInteger(id == OperatorNode::DIV ? self / arg : self % arg);
+        return true;
+    case OperatorNode::RIGHT_SHIFT : res = Value::makeInteger(self >> arg); return true;
+    case OperatorNode::LEFT_SHIFT : res = Value::makeInteger(self << arg); return true;
+    case OperatorNode::PLUS : res = Value::makeInteger(self + arg); return true;
+    case OperatorNode::MINUS : res = Value::makeInteger(self - arg); return true;
+    case OperatorNode::LESS : res = Value::makeBoolean(self < arg); return true;
+    case OperatorNode::LESS_EQUAL : res = Value::makeBoolean(self <= arg); return true;
+    case OperatorNode::GREATER : res = Value::makeBoolean(self > arg); return true;
+    case OperatorNode::GREATER_EQUAL : res = Value::makeBoolean(self >= arg); return true;
+    case OperatorNode::EQUAL : res = Value::makeBoolean(self == arg); return true;
+    case OperatorNode::NOT_EQUAL : res = Value::makeBoolean(self != arg); return true;
+    case OperatorNode::BITAND : res = Value::makeInteger(self & arg); return true;
+    case OperatorNode::BITXOR : res = Value::makeInteger(self ^ arg); return true;
+    case OperatorNode::BITOR : res = Value::makeInteger(self | arg); return true;
+    default : return false;
+    }
+}
+
 Object *makeIntegerInstanceObject(int64_t value, Runtime *rt) {
     ProfilerCAPTURE();
     auto res                                     = rt->make(rt->builtin_types.integer, Runtime::INSTANCE_OBJECT);
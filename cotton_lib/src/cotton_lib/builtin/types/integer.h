@@ -25,7 +25,7 @@
 
 namespace Cotton::Builtin {
 
-class IntegerInstance: public Instance {
+class IntegerInstance: public SlabInstance {
 public:
     int64_t value;
 
@@ -51,6 +51,30 @@ void installIntegerMethods(Type *type, Runtime *rt);
 
 Object *makeIntegerInstanceObject(int64_t value, Runtime *rt);
 
+/// @brief Immediate counterparts of the Integer operator adapters. Return `false` if the operator must go through
+/// the adapters instead.
+bool runIntegerImmediateOperator(OperatorNode::OperatorId id, int64_t self, Value &res);
+bool runIntegerImmediateOperator(OperatorNode::OperatorId id, int64_t self, int64_t arg, Value &res);
+
+/// @brief Binary operators quickened for two integers, as X(operator, Value maker, result). See getQuickOperator.
+#define INTEGER_QUICK_OPERATORS(X)                                                                                   \
+    X(MULT, makeInteger, self.integer * arg.integer)                                                                 \
+    X(DIV, makeInteger, self.integer / arg.integer)                                                                  \
+    X(REM, makeInteger, self.integer % arg.integer)                                                                  \
+    X(RIGHT_SHIFT, makeInteger, self.integer >> arg.integer)                                                         \
+    X(LEFT_SHIFT, makeInteger, self.integer << arg.integer)                                                          \
+    X(PLUS, makeInteger, self.integer + arg.integer)                                                                 \
+    X(MINUS, makeInteger, self.integer - arg.integer)                                                                \
+    X(LESS, makeBoolean, self.integer < arg.integer)                                                                 \
+    X(LESS_EQUAL, makeBoolean, self.integer <= arg.integer)                                                          \
+    X(GREATER, makeBoolean, self.integer > arg.integer)                                                              \
+    X(GREATER_EQUAL, makeBoolean, self.integer >= arg.integer)                                                       \
+    X(EQUAL, makeBoolean, self.integer == arg.integer)                                                               \
+    X(NOT_EQUAL, makeBoolean, self.integer != arg.integer)                                                           \
+    X(BITAND, makeInteger, self.integer & arg.integer)                                                               \
+    X(BITXOR, makeInteger, self.integer ^ arg.integer)                                                               \
+    X(BITOR, makeInteger, self.integer | arg.integer)
+
 int64_t &getIntegerValue(Object *obj, Runtime *rt);
 int64_t &getIntegerValue(Object *obj, Runtime *rt, Runtime::ContextId ctx_id);
 #define getIntegerValueFast(obj) (icast(obj->instance, Cotton::Builtin::IntegerInstance)->value)
@@ -27,7 +27,7 @@
 namespace Cotton::Builtin {
 
 NothingInstance::NothingInstance(Runtime *rt)
-    : Instance(rt, sizeof(NothingInstance)) {
+    : SlabInstance(rt, sizeof(NothingInstance)) {
     ProfilerCAPTURE();
 }
 
@@ -37,7 +37,7 @@ NothingInstance::~NothingInstance() {
 
 Instance *NothingInstance::copy(Runtime *rt) {
     ProfilerCAPTURE();
-    Instance *res = new NothingInstance(rt);
+    Instance *res = new (rt) NothingInstance(rt);
 
     if (res == nullptr) {
         rt->signalError("Failed to copy " + this->userRepr(rt), rt->getContext().area);
@@ -81,7 +81,7 @@ static Object *NothingNeqAdapter(Object *self, Object *arg, Runtime *rt, bool ex
     return rt->protectedBoolean(!getBooleanValueFast(res));
 }
 
-static Object *nothing_mm__repr__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *nothing_mm__repr__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -115,8 +115,8 @@ NothingType::NothingType(Runtime *rt)
 
 Object *NothingType::create(Runtime *rt) {
     ProfilerCAPTURE();
-    Instance *ins = new NothingInstance(rt);
-    Object   *obj = new Object(true, ins, this, rt);
+    Instance *ins = new (rt) NothingInstance(rt);
+    Object   *obj = new (rt) Object(true, ins, this, rt);
     return obj;
 }
 
@@ -132,10 +132,10 @@ Object *NothingType::copy(Object *obj, Runtime *rt) {
     ProfilerCAPTURE();
     rt->verifyIsOfType(obj, rt->builtin_types.nothing);
     if (obj->instance == nullptr) {
-        return new Object(false, nullptr, this, rt);
+        return new (rt) Object(false, nullptr, this, rt);
     }
     auto ins = obj->instance->copy(rt);
-    auto res = new Object(true, ins, this, rt);
+    auto res = new (rt) Object(true, ins, this, rt);
     return res;
 }
 
@@ -24,7 +24,7 @@
 #include "../../front/api.h"
 
 namespace Cotton::Builtin {
-class NothingInstance: public Instance {
+class NothingInstance: public SlabInstance {
 public:
     NothingInstance(Runtime *rt);
     ~NothingInstance();
@@ -24,7 +24,7 @@
 
 namespace Cotton::Builtin {
 RealInstance::RealInstance(Runtime *rt)
-    : Instance(rt, sizeof(RealInstance)) {
+    : SlabInstance(rt, sizeof(RealInstance)) {
     ProfilerCAPTURE();
     this->value = 0;
 }
@@ -35,7 +35,7 @@ RealInstance::~RealInstance() {
 
 Instance *RealInstance::copy(Runtime *rt) {
     ProfilerCAPTURE();
-    Instance *res = new RealInstance(rt);
+    Instance *res = new (rt) RealInstance(rt);
 
     if (res == nullptr) {
         rt->signalError("Failed to copy " + this->userRepr(rt), rt->getContext().area);
@@ -200,7 +200,7 @@ static Object *RealNeqAdapter(Object *self, Object *arg, Runtime *rt, bool execu
     return rt->protectedBoolean(!getBooleanValueFast(res));
 }
 
-static Object *real_mm__bool__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *real_mm__bool__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -212,7 +212,7 @@ static Object *real_mm__bool__(const std::vector<Object *> &args, Runtime *rt, b
     return rt->protectedBoolean(getRealValueFast(self));
 }
 
-static Object *real_mm__char__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *real_mm__char__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -224,7 +224,7 @@ static Object *real_mm__char__(const std::vector<Object *> &args, Runtime *rt, b
     return makeCharacterInstanceObject(getRealValueFast(self), rt);
 }
 
-static Object *real_mm__int__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *real_mm__int__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -236,7 +236,7 @@ static Object *real_mm__int__(const std::vector<Object *> &args, Runtime *rt, bo
     return makeIntegerInstanceObject(getRealValueFast(self), rt);
 }
 
-static Object *real_mm__real__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *real_mm__real__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -248,7 +248,7 @@ static Object *real_mm__real__(const std::vector<Object *> &args, Runtime *rt, b
     return makeRealInstanceObject(getRealValueFast(self), rt);
 }
 
-static Object *real_mm__string__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *real_mm__string__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -260,7 +260,7 @@ static Object *real_mm__string__(const std::vector<Object *> &args, Runtime *rt,
     return makeStringInstanceObject(std::to_string(getRealValueFast(self)), rt);
 }
 
-static Object *real_mm__repr__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *real_mm__repr__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -277,7 +277,7 @@ static Object *real_mm__repr__(const std::vector<Object *> &args, Runtime *rt, b
     return makeStringInstanceObject(std::to_string(getRealValueFast(self)), rt);
 }
 
-static Object *real_mm__read__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *real_mm__read__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -323,8 +323,8 @@ RealType::RealType(Runtime *rt)
 
 Object *RealType::create(Runtime *rt) {
     ProfilerCAPTURE();
-    Instance *ins = new RealInstance(rt);
-    Object   *obj = new Object(true, ins, this, rt);
+    Instance *ins = new (rt) RealInstance(rt);
+    Object   *obj = new (rt) Object(true, ins, this, rt);
     return obj;
 }
 
@@ -332,10 +332,10 @@ Object *RealType::copy(Object *obj, Runtime *rt) {
     ProfilerCAPTURE();
     rt->verifyIsOfType(obj, rt->builtin_types.real);
     if (obj->instance == nullptr) {
-        return new Object(false, nullptr, this, rt);
+        return new (rt) Object(false, nullptr, this, rt);
     }
     auto ins = obj->instance->copy(rt);
-    auto res = new Object(true, ins, this, rt);
+    auto res = new (rt) Object(true, ins, this, rt);
     return res;
 }
 
@@ -359,6 +359,32 @@ double &getRealValue(Object *obj, Runtime *rt, Runtime::ContextId ctx_id) {
     return icast(obj->instance, Cotton::Builtin::RealInstance)->value;
 }
 
+bool runRealImmediateOperator(OperatorNode::OperatorId id, double self, Value &res) {
+    ProfilerCAPTURE();
+    switch (id) {
+    case OperatorNode::PRE_PLUS : res = Value::makeReal(self); return true;
+    case OperatorNode::PRE_MINUS : res = Value::makeReal(self * -1); return true;
+    default : return false;
+    }
+}
+
+bool runRealImmediateOperator(OperatorNode::OperatorId id, double self, double arg, Value &res) {
+    ProfilerCAPTURE();
+    switch (id) {
+    case OperatorNode::MULT : res = Value::makeReal(self * arg); return true;
+    case OperatorNode::DIV : res = Value::makeReal(self / arg); return true;
+    case OperatorNode::PLUS : res = Value::makeReal(self + arg); return true;
+    case OperatorNode::MINUS : res = Value::makeReal(self - arg); return true;
+    case OperatorNode::LESS : res = Value::makeBoolean(self < arg); return true;
+    case OperatorNode::LESS_EQUAL : res = Value::makeBoolean(self <= arg); return true;
+    case OperatorNode::GREATER : res = Value::makeBoolean(self > arg); return true;
+    case OperatorNode::GREATER_EQUAL : res = Value::makeBoolean(self >= arg); return true;
+    case OperatorNode::EQUAL : res = Value::makeBoolean(self == arg); return true;
+    case OperatorNode::NOT_EQUAL : res = Value::makeBoolean(!(self == arg)); return true;
+    default : return false;
+    }
+}
+
 Object *makeRealInstanceObject(double value, Runtime *rt) {
     ProfilerCAPTURE();
     auto res                                  = rt->make(rt->builtin_types.real, Runtime::INSTANCE_OBJECT);
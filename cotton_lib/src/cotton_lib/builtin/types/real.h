@@ -25,7 +25,7 @@
 
 namespace Cotton::Builtin {
 
-class RealInstance: public Instance {
+class RealInstance: public SlabInstance {
 public:
     double value;
 
@@ -51,6 +51,24 @@ void installRealMethods(Type *type, Runtime *rt);
 
 Object *makeRealInstanceObject(double value, Runtime *rt);
 
+/// @brief Immediate counterparts of the Real operator adapters. Return `false` if the operator must go through
+/// the adapters instead.
+bool runRealImmediateOperator(OperatorNode::OperatorId id, double self, Value &res);
+bool runRealImmediateOperator(OperatorNode::OperatorId id, double self, double arg, Value &res);
+
+/// @brief Binary operators quickened for two reals, as X(operator, Value maker, result). See getQuickOperator.
+#define REAL_QUICK_OPERATORS(X)                                                                                      \
+    X(MULT, makeReal, self.real * arg.real)                                                                          \
+    X(DIV, makeReal, self.real / arg.real)                                                                           \
+    X(PLUS, makeReal, self.real + arg.real)                                                                          \
+    X(MINUS, makeReal, self.real - arg.real)                                                                         \
+    X(LESS, makeBoolean, self.real < arg.real)                                                                       \
+    X(LESS_EQUAL, makeBoolean, self.real <= arg.real)                                                                \
+    X(GREATER, makeBoolean, self.real > arg.real)                                                                    \
+    X(GREATER_EQUAL, makeBoolean, self.real >= arg.real)                                                             \
+    X(EQUAL, makeBoolean, self.real == arg.real)                                                                     \
+    X(NOT_EQUAL, makeBoolean, !(self.real == arg.real))
+
 double &getRealValue(Object *obj, Runtime *rt);
 double &getRealValue(Object *obj, Runtime *rt, Runtime::ContextId ctx_id);
 #define getRealValueFast(obj) (icast(obj->instance, Cotton::Builtin::RealInstance)->value)
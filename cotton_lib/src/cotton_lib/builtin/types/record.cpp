@@ -30,29 +30,74 @@ namespace Cotton::Builtin {
 RecordInstance::RecordInstance(Runtime *rt)
     : Instance(rt, sizeof(RecordInstance)) {
     ProfilerCAPTURE();
+    this->record_type  = nullptr;
+    this->extra_fields = nullptr;
 }
 
 RecordInstance::~RecordInstance() {
     ProfilerCAPTURE();
+    delete this->extra_fields;
 }
 
 Object *RecordInstance::selectField(NameId id, Runtime *rt) {
     ProfilerCAPTURE();
-    auto it = this->fields.find(id);
-    if (it != this->fields.end()) {
-        return it->second;
+    if (this->record_type != nullptr) {
+        auto res = this->selectFieldSlot(this->record_type->getFieldSlot(id));
+        if (res != nullptr) {
+            return res;
+        }
+    }
+    if (this->extra_fields != nullptr) {
+        auto it = this->extra_fields->find(id);
+        if (it != this->extra_fields->end()) {
+            return it->second;
+        }
     }
     rt->signalError(this->userRepr(rt) + "doesn't have field " + rt->nmgr->getString(id), rt->getContext().area);
 }
 
 bool RecordInstance::hasField(NameId id, Runtime *rt) {
     ProfilerCAPTURE();
-    return this->fields.find(id) != this->fields.end();
+    if (this->record_type != nullptr && this->selectFieldSlot(this->record_type->getFieldSlot(id)) != nullptr) {
+        return true;
+    }
+    return this->extra_fields != nullptr && this->extra_fields->find(id) != this->extra_fields->end();
 }
 
 void RecordInstance::addField(NameId id, Object *obj, Runtime *rt) {
     ProfilerCAPTURE();
-    this->fields[id] = obj;
+    auto slot = (this->record_type != nullptr) ? this->record_type->getFieldSlot(id) : -1;
+    if (slot != -1) {
+        if (slot >= this->fields.size()) {
+            GCResizeGuard guard(rt->getGC(), this);
+            this->fields.resize(slot + 1, nullptr);
+        }
+        this->fields[slot] = obj;
+        rt->getGC()->writeBarrier(this);
+        return;
+    }
+
+    // the layout is shared by all instances of the type, so fields of a single instance are kept aside
+    if (this->record_type != nullptr && !this->record_type->has_extra_fields) {
+        this->record_type->has_extra_fields = true;
+        this->record_type->version++;
+    }
+    {
+        GCResizeGuard guard(rt->getGC(), this);
+        if (this->extra_fields == nullptr) {
+            this->extra_fields = new HashTable<NameId, Object *>();
+        }
+        (*this->extra_fields)[id] = obj;
+    }
+    rt->getGC()->writeBarrier(this);
+}
+
+Object *RecordInstance::selectFieldSlot(int64_t slot) {
+    ProfilerCAPTURE();
+    if (slot < 0 || slot >= this->fields.size()) {
+        return nullptr;
+    }
+    return this->fields[slot];
 }
 
 Instance *RecordInstance::copy(Runtime *rt) {
@@ -62,7 +107,11 @@ Instance *RecordInstance::copy(Runtime *rt) {
 
 size_t RecordInstance::getSize() {
     ProfilerCAPTURE();
-    return sizeof(RecordInstance);
+    auto res = sizeof(RecordInstance) + this->fields.capacity() * sizeof(Object *);
+    if (this->extra_fields != nullptr) {
+        res += sizeof(*this->extra_fields) + this->extra_fields->size() * (sizeof(NameId) + sizeof(Object *));
+    }
+    return res;
 }
 
 size_t RecordType::getInstanceSize() {
@@ -78,13 +127,16 @@ std::string RecordInstance::userRepr(Runtime *rt) {
     return rt->nmgr->getString(this->nameid);
 }
 
-std::vector<Object *> RecordInstance::getGCReachable() {
+void RecordInstance::trace(GCVisitor &visitor) {
     ProfilerCAPTURE();
-    std::vector<Object *> res;
     for (auto field : this->fields) {
-        res.push_back(field.second);
+        visitor.visit(field);
+    }
+    if (this->extra_fields != nullptr) {
+        for (auto &field : *this->extra_fields) {
+            visitor.visit(field.second);
+        }
     }
-    return res;
 }
 
 RecordType::RecordType(Runtime *rt)
@@ -94,12 +146,17 @@ RecordType::RecordType(Runtime *rt)
 
 Object *RecordType::create(Runtime *rt) {
     ProfilerCAPTURE();
-    auto ins = new RecordInstance(rt);
-    ins->nameid = this->nameid;
+    auto ins         = new RecordInstance(rt);
+    ins->nameid      = this->nameid;
+    ins->record_type = this;
+    {
+        GCResizeGuard guard(rt->getGC(), ins);
+        ins->fields.reserve(this->instance_fields.size());
+    }
     for (auto f : this->instance_fields) {
         ins->addField(f, makeNothingInstanceObject(rt), rt);
     }
-    Object *obj = new Object(true, ins, this, rt);
+    Object *obj = new (rt) Object(true, ins, this, rt);
 
     return obj;
 }
@@ -112,16 +169,35 @@ std::string RecordType::userRepr(Runtime *rt) {
     return rt->nmgr->getString(this->nameid);
 }
 
+int64_t RecordType::getFieldSlot(NameId id) {
+    ProfilerCAPTURE();
+    auto it = this->field_slots.find(id);
+    if (it != this->field_slots.end()) {
+        return it->second;
+    }
+    return -1;
+}
+
+void RecordType::addInstanceField(NameId id) {
+    ProfilerCAPTURE();
+    if (this->field_slots.find(id) != this->field_slots.end()) {
+        return;
+    }
+    this->field_slots[id] = this->instance_fields.size();
+    this->instance_fields.push_back(id);
+    this->version++;
+}
+
 // TODO: == and !=
 
 Object *RecordType::copy(Object *obj, Runtime *rt) {
     ProfilerCAPTURE();
     rt->verifyIsValidObject(obj);
     if (obj->instance == nullptr) {
-        return new Object(false, nullptr, this, rt);
+        return new (rt) Object(false, nullptr, this, rt);
     }
     auto ins = obj->instance->copy(rt);
-    auto res = new Object(true, ins, this, rt);
+    auto res = new (rt) Object(true, ins, this, rt);
     return res;
 }
 
@@ -24,26 +24,32 @@
 #include "../../front/api.h"
 
 namespace Cotton::Builtin {
+class RecordType;
+
 class RecordInstance: public Instance {
 public:
-    HashTable<NameId, Object *> fields;
-    NameId                      nameid;
+    RecordType                  *record_type;     // describes the slots of the fields
+    std::vector<Object *>        fields;          // indexed by RecordType::getFieldSlot, nullptr means absent
+    HashTable<NameId, Object *> *extra_fields;    // fields that the record type doesn't describe, nullptr if none
+    NameId                       nameid;
     RecordInstance(Runtime *rt);
     ~RecordInstance();
     Object *selectField(NameId id, Runtime *rt);
     bool    hasField(NameId id, Runtime *rt);
     void    addField(NameId id, Object *obj, Runtime *rt);
+    Object *selectFieldSlot(int64_t slot);
 
     Instance             *copy(Runtime *rt);
     size_t                getSize();
     std::string           userRepr(Runtime *rt);
-    std::vector<Object *> getGCReachable();
+    void                  trace(GCVisitor &visitor);
 };
 
 class RecordType: public Type {
 public:
-    NameId              nameid;
-    std::vector<NameId> instance_fields;
+    NameId                     nameid;
+    std::vector<NameId>        instance_fields;
+    HashTable<NameId, int64_t> field_slots;
 
     size_t getInstanceSize();
     RecordType(Runtime *rt);
@@ -51,6 +57,8 @@ public:
     Object     *create(Runtime *rt);
     std::string userRepr(Runtime *rt);
     Object     *copy(Object *obj, Runtime *rt);
+    int64_t     getFieldSlot(NameId id);
+    void        addInstanceField(NameId id);
 };
 
 RecordType *makeRecordType(NameId nameid, Runtime *rt);
@@ -0,0 +1,400 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "set.h"
+#include "../../profiler.h"
+#include "api.h"
+
+namespace Cotton::Builtin {
+SetInstance::SetInstance(Runtime *rt)
+    : Instance(rt, sizeof(SetInstance)) {
+    ProfilerCAPTURE();
+}
+
+SetInstance::~SetInstance() {
+    ProfilerCAPTURE();
+}
+
+Instance *SetInstance::copy(Runtime *rt) {
+    ProfilerCAPTURE();
+    auto res = new SetInstance(rt);
+
+    if (res == nullptr) {
+        rt->signalError("Failed to copy " + this->userRepr(rt), rt->getContext().area);
+    }
+    GCResizeGuard guard(rt->getGC(), res);
+    res->data.copyFrom(this->data, rt);
+    return res;
+}
+
+std::string SetInstance::userRepr(Runtime *rt) {
+    ProfilerCAPTURE();
+    if (this == nullptr) {
+        return "Set(nullptr)";
+    }
+    return "Set(size = " + std::to_string(this->data.live) + ", data = ...)";
+}
+
+size_t SetInstance::getSize() {
+    ProfilerCAPTURE();
+    return sizeof(SetInstance) + this->data.getBuffersSize();
+}
+
+void SetInstance::trace(GCVisitor &visitor) {
+    ProfilerCAPTURE();
+    this->data.trace(visitor);
+}
+
+void SetInstance::spreadSingleUse() {
+    ProfilerCAPTURE();
+    this->data.spreadSingleUse();
+}
+
+void SetInstance::spreadMultiUse() {
+    ProfilerCAPTURE();
+    this->data.spreadMultiUse();
+}
+
+size_t SetType::getInstanceSize() {
+    ProfilerCAPTURE();
+    return sizeof(SetInstance);
+}
+
+// the hash of the item must be known already. Returns whether the item was added
+static bool setInsert(Object *self, Object *item, size_t hash, Runtime *rt) {
+    ProfilerCAPTURE();
+    auto &data = getSetDataFast(self);
+    if (data.find(item, hash, rt) != -1) {
+        return false;
+    }
+    GCResizeGuard guard(rt->getGC(), self->instance);
+    data.insert({hash, item, nullptr});
+    return true;
+}
+
+static Object *SetEqAdapter(Object *self, Object *arg, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyIsValidObject(arg, OperatorArgCtx(1));
+
+    if (!execution_result_matters) {
+        return rt->protectedBoolean(false);
+    }
+
+    if (!rt->isOfType(arg, rt->builtin_types.set)) {
+        return rt->protectedBoolean(false);
+    }
+
+    if (rt->isInstanceObject(self, rt->builtin_types.set)) {
+        if (!rt->isInstanceObject(arg, rt->builtin_types.set)) {
+            return rt->protectedBoolean(false);
+        }
+        auto &s1 = getSetDataFast(self);
+        auto &s2 = getSetDataFast(arg);
+        if (s1.live != s2.live) {
+            return rt->protectedBoolean(false);
+        }
+        for (int64_t i = 0; i < s1.entries.size(); i++) {
+            auto entry = s1.entries[i];
+            if (entry.key != nullptr && s2.find(entry.key, entry.hash, rt) == -1) {
+                return rt->protectedBoolean(false);
+            }
+        }
+        return rt->protectedBoolean(true);
+    }
+    else if (rt->isTypeObject(self, rt->builtin_types.set)) {
+        if (!rt->isTypeObject(arg, rt->builtin_types.set)) {
+            return rt->protectedBoolean(false);
+        }
+        return rt->protectedBoolean(true);
+    }
+
+    return rt->protectedBoolean(false);
+}
+
+static Object *SetNeqAdapter(Object *self, Object *arg, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    auto res = SetEqAdapter(self, arg, rt, execution_result_matters);
+    return rt->protectedBoolean(!getBooleanValueFast(res));
+}
+
+static Object *setAddMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyMinArgsAmountMethod(args, 1);
+    auto self = args[0];
+
+    for (int64_t i = 1; i < args.size(); i++) {
+        rt->verifyIsValidObject(args[i], MethodArgCtx(i - 1));
+        setInsert(self, args[i], hashKey(args[i], rt), rt);
+    }
+    rt->getGC()->writeBarrier(self->instance);
+    return self;
+}
+
+static Object *setAddallMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 1);
+    auto self = args[0];
+    auto arr  = args[1];
+
+    rt->verifyIsInstanceObject(arr, rt->builtin_types.array, MethodArgCtx(0));
+
+    // __hash__ and __eq__ of the items may change the array, so the items are taken by position
+    auto &items = getArrayDataFast(arr);
+    for (int64_t i = 0; i < items.size(); i++) {
+        auto item = items[i];
+        auto hash = hashKey(item, rt);
+        if (getSetDataFast(self).find(item, hash, rt) == -1) {
+            // the set keeps its own copy, so that changing the array doesn't change the set
+            GCResizeGuard guard(rt->getGC(), self->instance);
+            getSetDataFast(self).insert({hash, rt->copy(item), nullptr});
+        }
+    }
+    rt->getGC()->writeBarrier(self->instance);
+    return self;
+}
+
+static Object *setHasMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 1);
+    auto self = args[0];
+    auto item = args[1];
+
+    rt->verifyIsValidObject(item, MethodArgCtx(0));
+
+    auto &data = getSetDataFast(self);
+    return rt->protectedBoolean(data.find(item, hashKey(item, rt), rt) != -1);
+}
+
+static Object *setRemoveMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyMinArgsAmountMethod(args, 1);
+    auto self = args[0];
+
+    for (int64_t i = 1; i < args.size(); i++) {
+        rt->verifyIsValidObject(args[i], MethodArgCtx(i - 1));
+        getSetDataFast(self).remove(args[i], hashKey(args[i], rt), rt);
+    }
+    return self;
+}
+
+static Object *setSizeMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    if (!execution_result_matters) {
+        return nullptr;
+    }
+
+    return makeIntegerInstanceObject(getSetDataFast(self).live, rt);
+}
+
+static Object *setEmptyMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    return rt->protectedBoolean(getSetDataFast(self).live == 0);
+}
+
+static Object *setClearMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    getSetDataFast(self).clear();
+    return self;
+}
+
+static Object *setArrayMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    if (!execution_result_matters) {
+        return nullptr;
+    }
+
+    // the items are copied, changing them in place would break the set
+    auto                 &data = getSetDataFast(self);
+    std::vector<Object *> items;
+    items.reserve(data.live);
+    for (auto &entry : data.entries) {
+        if (entry.key != nullptr) {
+            items.push_back(rt->copy(entry.key));
+        }
+    }
+    return makeArrayInstanceObject(items, rt);
+}
+
+/*
+ The results of union, intersect and difference share the items with the sets they were made from, since a set
+ never hands out its items without copying them. The stored hashes are reused, so only __eq__ may get called.
+ */
+
+static Object *setUnionMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 1);
+    auto self  = args[0];
+    auto other = args[1];
+
+    rt->verifyIsInstanceObject(other, rt->builtin_types.set, MethodArgCtx(0));
+
+    auto        res = rt->make(rt->builtin_types.set, Runtime::INSTANCE_OBJECT);
+    GCRootGuard root(rt->getGC(), res);
+    {
+        GCResizeGuard guard(rt->getGC(), res->instance);
+        getSetDataFast(res) = getSetDataFast(self);
+    }
+
+    auto &from = getSetDataFast(other);
+    for (int64_t i = 0; i < from.entries.size(); i++) {
+        auto entry = from.entries[i];
+        if (entry.key != nullptr) {
+            setInsert(res, entry.key, entry.hash, rt);
+        }
+    }
+    rt->getGC()->writeBarrier(res->instance);
+    return res;
+}
+
+// keeps the items of self that are (or aren't) in other
+static Object *filterSet(Object *self, Object *other, bool keep_common, Runtime *rt) {
+    ProfilerCAPTURE();
+    auto        res = rt->make(rt->builtin_types.set, Runtime::INSTANCE_OBJECT);
+    GCRootGuard root(rt->getGC(), res);
+
+    auto &from = getSetDataFast(self);
+    for (int64_t i = 0; i < from.entries.size(); i++) {
+        auto entry = from.entries[i];
+        if (entry.key == nullptr) {
+            continue;
+        }
+        if ((getSetDataFast(other).find(entry.key, entry.hash, rt) != -1) == keep_common) {
+            setInsert(res, entry.key, entry.hash, rt);
+        }
+    }
+    rt->getGC()->writeBarrier(res->instance);
+    return res;
+}
+
+static Object *setIntersectMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 1);
+    rt->verifyIsInstanceObject(args[1], rt->builtin_types.set, MethodArgCtx(0));
+    return filterSet(args[0], args[1], true, rt);
+}
+
+static Object *setDifferenceMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 1);
+    rt->verifyIsInstanceObject(args[1], rt->builtin_types.set, MethodArgCtx(0));
+    return filterSet(args[0], args[1], false, rt);
+}
+
+static Object *set_mm__repr__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    if (!execution_result_matters) {
+        return self;
+    }
+
+    if (rt->isTypeObject(self, nullptr)) {
+        return makeStringInstanceObject("Set", rt);
+    }
+
+    // __repr__ of the items may change the set, so the items are taken by position
+    auto       &data  = getSetDataFast(self);
+    std::string res   = "{";
+    bool        first = true;
+    for (int64_t i = 0; i < data.entries.size(); i++) {
+        auto item = data.entries[i].key;
+        if (item == nullptr) {
+            continue;
+        }
+
+        auto o = rt->runMagicMethod(MagicMethods::MM_REPR, item, ArgSpan(&item, 1), true);
+        rt->verifyIsInstanceObject(o, rt->builtin_types.string, Runtime::AREA_CTX);
+        if (!first) {
+            res += ", ";
+        }
+        res   += getStringDataFast(o);
+        first  = false;
+    }
+    res += "}";
+
+    return makeStringInstanceObject(res, rt);
+}
+
+void installSetMethods(Type *type, Runtime *rt) {
+    ProfilerCAPTURE();
+    type->addMethod(MagicMethods::mm__repr__(rt), Builtin::makeFunctionInstanceObject(true, set_mm__repr__, nullptr, rt));
+    type->addMethod(MagicMethods::mm__string__(rt), Builtin::makeFunctionInstanceObject(true, set_mm__repr__, nullptr, rt));
+
+    type->addMethod(rt->nmgr->getId("add"), makeFunctionInstanceObject(true, setAddMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("addall"), makeFunctionInstanceObject(true, setAddallMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("has"), makeFunctionInstanceObject(true, setHasMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("remove"), makeFunctionInstanceObject(true, setRemoveMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("size"), makeFunctionInstanceObject(true, setSizeMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("empty"), makeFunctionInstanceObject(true, setEmptyMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("clear"), makeFunctionInstanceObject(true, setClearMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("array"), makeFunctionInstanceObject(true, setArrayMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("union"), makeFunctionInstanceObject(true, setUnionMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("intersect"), makeFunctionInstanceObject(true, setIntersectMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("difference"), makeFunctionInstanceObject(true, setDifferenceMethod, nullptr, rt));
+}
+
+SetType::SetType(Runtime *rt)
+    : Type(rt) {
+    ProfilerCAPTURE();
+    this->eq_op  = SetEqAdapter;
+    this->neq_op = SetNeqAdapter;
+}
+
+Object *SetType::create(Runtime *rt) {
+    ProfilerCAPTURE();
+    Instance *ins = new SetInstance(rt);
+    Object   *obj = new (rt) Object(true, ins, this, rt);
+    return obj;
+}
+
+Object *SetType::copy(Object *obj, Runtime *rt) {
+    ProfilerCAPTURE();
+    rt->verifyIsOfType(obj, rt->builtin_types.set);
+    if (obj->instance == nullptr) {
+        return new (rt) Object(false, nullptr, this, rt);
+    }
+    auto ins = obj->instance->copy(rt);
+    auto res = new (rt) Object(true, ins, this, rt);
+    return res;
+}
+
+std::string SetType::userRepr(Runtime *rt) {
+    ProfilerCAPTURE();
+    if (this == nullptr) {
+        return "SetType(nullptr)";
+    }
+    return "SetType";
+}
+}    // namespace Cotton::Builtin
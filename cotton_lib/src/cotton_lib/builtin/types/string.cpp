@@ -41,6 +41,7 @@ Instance *StringInstance::copy(Runtime *rt) {
     if (res == nullptr) {
         rt->signalError("Failed to copy " + this->userRepr(rt), rt->getContext().area);
     }
+    GCResizeGuard guard(rt->getGC(), res);
     ((StringInstance *)res)->data = this->data;
     return res;
 }
@@ -55,7 +56,12 @@ std::string StringInstance::userRepr(Runtime *rt) {
 
 size_t StringInstance::getSize() {
     ProfilerCAPTURE();
-    return sizeof(StringInstance);
+    // short strings are kept inside the instance, longer ones in a buffer with room for the terminating zero
+    static const size_t INLINE_CAPACITY = std::string().capacity();
+    if (this->data.capacity() <= INLINE_CAPACITY) {
+        return sizeof(StringInstance);
+    }
+    return sizeof(StringInstance) + this->data.capacity() + 1;
 }
 
 size_t StringType::getInstanceSize() {
@@ -63,7 +69,7 @@ size_t StringType::getInstanceSize() {
     return sizeof(StringInstance);
 }
 
-static Object *StringIndexAdapter(Object *self, const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *StringIndexAdapter(Object *self, ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
 
     rt->verifyExactArgsAmountFunc(args, 1);
@@ -87,7 +93,8 @@ static Object *StringAddAdapter(Object *self, Object *arg, Runtime *rt, bool exe
         return nullptr;
     }
 
-    auto res                = rt->copy(self);
+    auto          res = rt->copy(self);
+    GCResizeGuard guard(rt->getGC(), res->instance);
     getStringDataFast(res) += getStringDataFast(arg);
 
     return res;
@@ -123,7 +130,7 @@ static Object *StringNeqAdapter(Object *self, Object *arg, Runtime *rt, bool exe
     return rt->protectedBoolean(!getBooleanValueFast(res));
 }
 
-static Object *stringSizeMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringSizeMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -135,7 +142,7 @@ static Object *stringSizeMethod(const std::vector<Object *> &args, Runtime *rt,
     return makeIntegerInstanceObject(getStringDataFast(self).size(), rt);
 }
 
-static Object *stringSetMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringSetMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 2);
     auto self  = args[0];
@@ -154,7 +161,7 @@ static Object *stringSetMethod(const std::vector<Object *> &args, Runtime *rt, b
     return rt->protectedNothing();
 }
 
-static Object *stringClearMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringClearMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -163,7 +170,7 @@ static Object *stringClearMethod(const std::vector<Object *> &args, Runtime *rt,
     return self;
 }
 
-static Object *stringEmptyMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringEmptyMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -171,7 +178,7 @@ static Object *stringEmptyMethod(const std::vector<Object *> &args, Runtime *rt,
     return rt->protectedBoolean(getStringDataFast(self).empty());
 }
 
-static Object *stringReverseMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringReverseMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -180,7 +187,7 @@ static Object *stringReverseMethod(const std::vector<Object *> &args, Runtime *r
     return self;
 }
 
-static Object *stringPrependMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringPrependMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -188,12 +195,13 @@ static Object *stringPrependMethod(const std::vector<Object *> &args, Runtime *r
 
     rt->verifyIsInstanceObject(arg, rt->builtin_types.string, MethodArgCtx(0));
 
+    GCResizeGuard guard(rt->getGC(), self->instance);
     getStringDataFast(self) = getStringDataFast(arg) + getStringDataFast(self);
 
     return self;
 }
 
-static Object *stringAppendMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringAppendMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -201,12 +209,13 @@ static Object *stringAppendMethod(const std::vector<Object *> &args, Runtime *rt
 
     rt->verifyIsInstanceObject(arg, rt->builtin_types.string, MethodArgCtx(0));
 
+    GCResizeGuard guard(rt->getGC(), self->instance);
     getStringDataFast(self) += getStringDataFast(arg);
 
     return self;
 }
 
-static Object *stringDelprefMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringDelprefMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -224,7 +233,7 @@ static Object *stringDelprefMethod(const std::vector<Object *> &args, Runtime *r
     return self;
 }
 
-static Object *stringDelsufMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringDelsufMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -242,7 +251,7 @@ static Object *stringDelsufMethod(const std::vector<Object *> &args, Runtime *rt
     return self;
 }
 
-static Object *stringCopyMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringCopyMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -252,7 +261,7 @@ static Object *stringCopyMethod(const std::vector<Object *> &args, Runtime *rt,
     return makeStringInstanceObject(str, rt);
 }
 
-static Object *stringSubstrMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringSubstrMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 2);
     auto self  = args[0];
@@ -281,7 +290,7 @@ static Object *stringSubstrMethod(const std::vector<Object *> &args, Runtime *rt
     return makeStringInstanceObject(substr, rt);
 }
 
-static Object *stringArrayMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringArrayMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -293,7 +302,7 @@ static Object *stringArrayMethod(const std::vector<Object *> &args, Runtime *rt,
     return makeArrayInstanceObject(data, rt);
 }
 
-static Object *stringSplitMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringSplitMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyMinArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -342,7 +351,7 @@ static Object *stringSplitMethod(const std::vector<Object *> &args, Runtime *rt,
     return makeArrayInstanceObject(arr, rt);
 }
 
-static Object *stringSplitfMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringSplitfMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -359,7 +368,8 @@ static Object *stringSplitfMethod(const std::vector<Object *> &args, Runtime *rt
     rt->getContext().area      = ctx.area;
     rt->getContext().sub_areas = {ctx.area, ctx.area};
     for (size_t i = 0; i < str.size(); i++) {
-        auto r = rt->runOperator(OperatorNode::CALL, arg, std::vector<Object *> {makeCharacterInstanceObject(str[i], rt)}, true);
+        Object *call_args[] = {makeCharacterInstanceObject(str[i], rt)};
+        auto    r           = rt->runOperator(OperatorNode::CALL, arg, call_args, true);
         if (getBooleanValue(r, rt)) {
             res.push_back(str.substr(prev_pos, i - prev_pos));
             prev_pos = i + 1;
@@ -375,7 +385,7 @@ static Object *stringSplitfMethod(const std::vector<Object *> &args, Runtime *rt
     return makeArrayInstanceObject(arr, rt);
 }
 
-static Object *stringStartswithMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringStartswithMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -389,7 +399,7 @@ static Object *stringStartswithMethod(const std::vector<Object *> &args, Runtime
     return rt->protectedBoolean(str.substr(0, target.size()) == target);
 }
 
-static Object *stringEndswithMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringEndswithMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -403,7 +413,7 @@ static Object *stringEndswithMethod(const std::vector<Object *> &args, Runtime *
     return rt->protectedBoolean(str.substr(std::max((int64_t)0, (int64_t)str.size() - int64_t(target.size()))) == target);
 }
 
-static Object *stringSplitlinesMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringSplitlinesMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -427,7 +437,7 @@ static Object *stringSplitlinesMethod(const std::vector<Object *> &args, Runtime
     return makeArrayInstanceObject(arr, rt);
 }
 
-static Object *stringJoinMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringJoinMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
@@ -449,16 +459,17 @@ static Object *stringJoinMethod(const std::vector<Object *> &args, Runtime *rt,
             flag  = true;
         }
         else {
-            rt->verifyHasMethod(item, MagicMethods::mm__string__(rt), Runtime::AREA_CTX);
-            auto s  = rt->runMethod(MagicMethods::mm__string__(rt), item, std::vector<Object *> {item}, true);
-            res    += getStringData(s, rt);
+            rt->verifyHasMagicMethod(item, MagicMethods::MM_STRING, Runtime::AREA_CTX);
+            Object *call_args[] = {item};
+            auto    s           = rt->runMagicMethod(MagicMethods::MM_STRING, item, call_args, true);
+            res                += getStringData(s, rt);
         }
     }
 
     return makeStringInstanceObject(res, rt);
 }
 
-static Object *stringReplaceMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringReplaceMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 2);
     auto self = args[0];
@@ -487,24 +498,26 @@ static Object *stringReplaceMethod(const std::vector<Object *> &args, Runtime *r
         prev_pos  = pos + what.size();
     }
 
+    GCResizeGuard guard(rt->getGC(), self->instance);
     str = res;
     return self;
 }
 
-static Object *stringConcatwithMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *stringConcatwithMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
     auto arg  = args[1];
     rt->verifyIsInstanceObject(arg, rt->builtin_types.string, MethodArgCtx(0));
 
-    auto &str    = getStringDataFast(self);
-    auto &other  = getStringDataFast(arg);
-    str         += other;
+    auto         &str   = getStringDataFast(self);
+    auto         &other = getStringDataFast(arg);
+    GCResizeGuard guard(rt->getGC(), self->instance);
+    str += other;
     return self;
 }
 
-static Object *string_mm__bool__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *string_mm__bool__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -522,7 +535,7 @@ static Object *string_mm__bool__(const std::vector<Object *> &args, Runtime *rt,
     rt->signalError("Unsupported conversion: " + getStringDataFast(self), rt->getContext().area);
 }
 
-static Object *string_mm__int__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *string_mm__int__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -534,7 +547,7 @@ static Object *string_mm__int__(const std::vector<Object *> &args, Runtime *rt,
     return makeIntegerInstanceObject(atoll(getStringDataFast(self).c_str()), rt);
 }
 
-static Object *string_mm__real__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *string_mm__real__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -546,7 +559,7 @@ static Object *string_mm__real__(const std::vector<Object *> &args, Runtime *rt,
     return makeRealInstanceObject(atof(getStringDataFast(self).c_str()), rt);
 }
 
-static Object *string_mm__string__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *string_mm__string__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -558,7 +571,7 @@ static Object *string_mm__string__(const std::vector<Object *> &args, Runtime *r
     return makeStringInstanceObject(getStringDataFast(self), rt);
 }
 
-static Object *string_mm__repr__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *string_mm__repr__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -575,7 +588,7 @@ static Object *string_mm__repr__(const std::vector<Object *> &args, Runtime *rt,
     return makeStringInstanceObject("\"" + getStringDataFast(self) + "\"", rt);
 }
 
-static Object *string_mm__read__(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *string_mm__read__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     ProfilerCAPTURE();
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
@@ -634,7 +647,7 @@ StringType::StringType(Runtime *rt)
 Object *StringType::create(Runtime *rt) {
     ProfilerCAPTURE();
     Instance *ins = new StringInstance(rt);
-    Object   *obj = new Object(true, ins, this, rt);
+    Object   *obj = new (rt) Object(true, ins, this, rt);
     return obj;
 }
 
@@ -642,10 +655,10 @@ Object *StringType::copy(Object *obj, Runtime *rt) {
     ProfilerCAPTURE();
     rt->verifyIsOfType(obj, rt->builtin_types.string);
     if (obj->instance == nullptr) {
-        return new Object(false, nullptr, this, rt);
+        return new (rt) Object(false, nullptr, this, rt);
     }
     auto ins = obj->instance->copy(rt);
-    auto res = new Object(true, ins, this, rt);
+    auto res = new (rt) Object(true, ins, this, rt);
     return res;
 }
 
@@ -671,7 +684,8 @@ std::string &getStringData(Object *obj, Runtime *rt, Runtime::ContextId ctx_id)
 
 Object *makeStringInstanceObject(const std::string &value, Runtime *rt) {
     ProfilerCAPTURE();
-    auto res               = rt->make(rt->builtin_types.string, Runtime::INSTANCE_OBJECT);
+    auto          res = rt->make(rt->builtin_types.string, Runtime::INSTANCE_OBJECT);
+    GCResizeGuard guard(rt->getGC(), res->instance);
     getStringDataFast(res) = value;
     return res;
 }
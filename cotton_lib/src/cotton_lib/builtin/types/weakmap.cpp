@@ -0,0 +1,281 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "weakmap.h"
+#include "../../profiler.h"
+#include "api.h"
+
+namespace Cotton::Builtin {
+WeakMapInstance::WeakMapInstance(Runtime *rt)
+    : WeakInstance(rt, sizeof(WeakMapInstance)) {
+    ProfilerCAPTURE();
+}
+
+WeakMapInstance::~WeakMapInstance() {
+    ProfilerCAPTURE();
+}
+
+Instance *WeakMapInstance::copy(Runtime *rt) {
+    ProfilerCAPTURE();
+    auto res = new WeakMapInstance(rt);
+
+    if (res == nullptr) {
+        rt->signalError("Failed to copy " + this->userRepr(rt), rt->getContext().area);
+    }
+    GCResizeGuard guard(rt->getGC(), res);
+    for (auto &[key, entry] : this->data) {
+        res->data[key] = {entry.key_type, rt->copy(entry.value)};
+    }
+    return res;
+}
+
+std::string WeakMapInstance::userRepr(Runtime *rt) {
+    ProfilerCAPTURE();
+    if (this == nullptr) {
+        return "WeakMap(nullptr)";
+    }
+    return "WeakMap(size = " + std::to_string(this->data.size()) + ")";
+}
+
+// every entry is a node holding the entry, the hash of the key and a link to the next node
+size_t WeakMapInstance::getSize() {
+    ProfilerCAPTURE();
+    return sizeof(WeakMapInstance) + this->data.bucket_count() * sizeof(void *)
+           + this->data.size() * (sizeof(std::pair<Instance *, WeakMapEntry>) + sizeof(size_t) + sizeof(void *));
+}
+
+// neither the keys nor the values are traced, see traceEphemerons
+void WeakMapInstance::trace(GCVisitor &visitor) {
+    ProfilerCAPTURE();
+    for (auto &[_, entry] : this->data) {
+        visitor.visit(entry.key_type);
+    }
+}
+
+void WeakMapInstance::traceEphemerons(GCVisitor &visitor, const std::function<bool(Instance *)> &is_live) {
+    ProfilerCAPTURE();
+    for (auto &[key, entry] : this->data) {
+        if (is_live(key)) {
+            visitor.visit(entry.value);
+        }
+    }
+}
+
+void WeakMapInstance::clearDead(const std::function<bool(Instance *)> &is_live) {
+    ProfilerCAPTURE();
+    std::erase_if(this->data, [&is_live](auto &item) { return !is_live(item.first); });
+}
+
+void WeakMapInstance::spreadSingleUse() {
+    ProfilerCAPTURE();
+    for (auto &[_, entry] : this->data) {
+        entry.value->spreadSingleUse();
+    }
+}
+
+void WeakMapInstance::spreadMultiUse() {
+    ProfilerCAPTURE();
+    for (auto &[_, entry] : this->data) {
+        entry.value->spreadMultiUse();
+    }
+}
+
+size_t WeakMapType::getInstanceSize() {
+    ProfilerCAPTURE();
+    return sizeof(WeakMapInstance);
+}
+
+// keys are instances, so that every object sharing the instance finds the same entry
+static Instance *getWeakMapKey(Object *key, Runtime *rt, Runtime::ContextId ctx_id) {
+    ProfilerCAPTURE();
+    rt->verifyIsValidObject(key, ctx_id);
+    if (key->instance == nullptr) {
+        rt->signalError("Only instance objects can be weak map keys: " + key->userRepr(rt), rt->getContext().sub_areas[1]);
+    }
+    return key->instance;
+}
+
+static Object *weakmapSetMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 2);
+    auto self  = args[0];
+    auto key   = getWeakMapKey(args[1], rt, MethodArgCtx(0));
+    auto value = args[2];
+
+    rt->verifyIsValidObject(value, MethodArgCtx(1));
+
+    GCResizeGuard guard(rt->getGC(), self->instance);
+    getWeakMapDataFast(self)[key] = {args[1]->type, value};
+    rt->getGC()->writeBarrier(self->instance);
+    return self;
+}
+
+static Object *weakmapGetMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 1);
+    auto self = args[0];
+    auto key  = getWeakMapKey(args[1], rt, MethodArgCtx(0));
+
+    auto &data = getWeakMapDataFast(self);
+    auto  it   = data.find(key);
+    if (it == data.end()) {
+        return rt->protectedNothing();
+    }
+    return it->second.value;
+}
+
+static Object *weakmapHasMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 1);
+    auto self = args[0];
+    auto key  = getWeakMapKey(args[1], rt, MethodArgCtx(0));
+
+    return rt->protectedBoolean(getWeakMapDataFast(self).contains(key));
+}
+
+static Object *weakmapRemoveMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 1);
+    auto self = args[0];
+    auto key  = getWeakMapKey(args[1], rt, MethodArgCtx(0));
+
+    GCResizeGuard guard(rt->getGC(), self->instance);
+    getWeakMapDataFast(self).erase(key);
+    return self;
+}
+
+static Object *weakmapSizeMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    if (!execution_result_matters) {
+        return nullptr;
+    }
+
+    return makeIntegerInstanceObject(getWeakMapDataFast(self).size(), rt);
+}
+
+static Object *weakmapEmptyMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    return rt->protectedBoolean(getWeakMapDataFast(self).empty());
+}
+
+static Object *weakmapClearMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    GCResizeGuard guard(rt->getGC(), self->instance);
+    getWeakMapDataFast(self).clear();
+    return self;
+}
+
+static Object *weakmapKeysMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    std::vector<Object *> keys;
+    for (auto &[key, entry] : getWeakMapDataFast(self)) {
+        keys.push_back(new (rt) Object(true, key, entry.key_type, rt));
+    }
+    return makeArrayInstanceObject(keys, rt);
+}
+
+static Object *weakmapValuesMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    std::vector<Object *> values;
+    for (auto &[_, entry] : getWeakMapDataFast(self)) {
+        values.push_back(entry.value);
+    }
+    return makeArrayInstanceObject(values, rt);
+}
+
+static Object *weakmap_mm__repr__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    if (!execution_result_matters) {
+        return self;
+    }
+
+    if (rt->isTypeObject(self, nullptr)) {
+        return makeStringInstanceObject("WeakMap", rt);
+    }
+
+    return makeStringInstanceObject(self->instance->userRepr(rt), rt);
+}
+
+void installWeakMapMethods(Type *type, Runtime *rt) {
+    ProfilerCAPTURE();
+    type->addMethod(MagicMethods::mm__repr__(rt), Builtin::makeFunctionInstanceObject(true, weakmap_mm__repr__, nullptr, rt));
+    type->addMethod(MagicMethods::mm__string__(rt), Builtin::makeFunctionInstanceObject(true, weakmap_mm__repr__, nullptr, rt));
+
+    type->addMethod(rt->nmgr->getId("set"), makeFunctionInstanceObject(true, weakmapSetMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("get"), makeFunctionInstanceObject(true, weakmapGetMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("has"), makeFunctionInstanceObject(true, weakmapHasMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("remove"), makeFunctionInstanceObject(true, weakmapRemoveMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("size"), makeFunctionInstanceObject(true, weakmapSizeMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("empty"), makeFunctionInstanceObject(true, weakmapEmptyMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("clear"), makeFunctionInstanceObject(true, weakmapClearMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("keys"), makeFunctionInstanceObject(true, weakmapKeysMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("values"), makeFunctionInstanceObject(true, weakmapValuesMethod, nullptr, rt));
+}
+
+WeakMapType::WeakMapType(Runtime *rt)
+    : Type(rt) {
+    ProfilerCAPTURE();
+}
+
+Object *WeakMapType::create(Runtime *rt) {
+    ProfilerCAPTURE();
+    Instance *ins = new WeakMapInstance(rt);
+    Object   *obj = new (rt) Object(true, ins, this, rt);
+    return obj;
+}
+
+Object *WeakMapType::copy(Object *obj, Runtime *rt) {
+    ProfilerCAPTURE();
+    rt->verifyIsOfType(obj, rt->builtin_types.weakmap);
+    if (obj->instance == nullptr) {
+        return new (rt) Object(false, nullptr, this, rt);
+    }
+    auto ins = obj->instance->copy(rt);
+    auto res = new (rt) Object(true, ins, this, rt);
+    return res;
+}
+
+std::string WeakMapType::userRepr(Runtime *rt) {
+    ProfilerCAPTURE();
+    if (this == nullptr) {
+        return "WeakMapType(nullptr)";
+    }
+    return "WeakMapType";
+}
+}    // namespace Cotton::Builtin
@@ -0,0 +1,71 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+#include "../../back/api.h"
+#include "../../front/api.h"
+#include <unordered_map>
+
+namespace Cotton::Builtin {
+
+/// @brief Entry of a weak map, see WeakMapInstance.
+class WeakMapEntry {
+public:
+    Type   *key_type;    // type of the object the key was taken from
+    Object *value;
+};
+
+/**
+ * @brief Map whose keys are referenced weakly, see WeakInstance. Keys are compared by identity. Values are only kept
+ * alive while their keys are, so an entry whose value references its own key still goes away once nothing else
+ * references the key.
+ */
+class WeakMapInstance: public WeakInstance {
+public:
+    std::unordered_map<Instance *, WeakMapEntry, GCPointerHash> data;
+
+    WeakMapInstance(Runtime *rt);
+    ~WeakMapInstance();
+
+    Instance   *copy(Runtime *rt);
+    size_t      getSize();
+    std::string userRepr(Runtime *rt);
+    void        trace(GCVisitor &visitor);
+    void        traceEphemerons(GCVisitor &visitor, const std::function<bool(Instance *)> &is_live);
+    void        clearDead(const std::function<bool(Instance *)> &is_live);
+    void        spreadSingleUse();
+    void        spreadMultiUse();
+};
+
+class WeakMapType: public Type {
+public:
+    size_t getInstanceSize();
+    WeakMapType(Runtime *rt);
+    ~WeakMapType() = default;
+    Object     *create(Runtime *rt);
+    Object     *copy(Object *obj, Runtime *rt);
+    std::string userRepr(Runtime *rt);
+};
+
+void installWeakMapMethods(Type *type, Runtime *rt);
+
+#define getWeakMapDataFast(obj) (icast(obj->instance, Cotton::Builtin::WeakMapInstance)->data)
+}    // namespace Cotton::Builtin
@@ -0,0 +1,189 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "weakref.h"
+#include "../../profiler.h"
+#include "api.h"
+
+namespace Cotton::Builtin {
+WeakRefInstance::WeakRefInstance(Runtime *rt)
+    : WeakInstance(rt, sizeof(WeakRefInstance)) {
+    ProfilerCAPTURE();
+    this->target      = nullptr;
+    this->target_type = nullptr;
+}
+
+WeakRefInstance::~WeakRefInstance() {
+    ProfilerCAPTURE();
+}
+
+Instance *WeakRefInstance::copy(Runtime *rt) {
+    ProfilerCAPTURE();
+    auto res = new WeakRefInstance(rt);
+
+    if (res == nullptr) {
+        rt->signalError("Failed to copy " + this->userRepr(rt), rt->getContext().area);
+    }
+    res->target      = this->target;
+    res->target_type = this->target_type;
+    return res;
+}
+
+std::string WeakRefInstance::userRepr(Runtime *rt) {
+    ProfilerCAPTURE();
+    if (this == nullptr) {
+        return "WeakRef(nullptr)";
+    }
+    return this->target != nullptr ? "WeakRef(alive)" : "WeakRef(empty)";
+}
+
+size_t WeakRefInstance::getSize() {
+    ProfilerCAPTURE();
+    return sizeof(WeakRefInstance);
+}
+
+// the target isn't traced, that's what makes the reference weak
+void WeakRefInstance::trace(GCVisitor &visitor) {
+    ProfilerCAPTURE();
+    visitor.visit(this->target_type);
+}
+
+void WeakRefInstance::clearDead(const std::function<bool(Instance *)> &is_live) {
+    ProfilerCAPTURE();
+    if (this->target != nullptr && !is_live(this->target)) {
+        this->target      = nullptr;
+        this->target_type = nullptr;
+    }
+}
+
+size_t WeakRefType::getInstanceSize() {
+    ProfilerCAPTURE();
+    return sizeof(WeakRefInstance);
+}
+
+static Object *weakrefSetMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 1);
+    auto self = args[0];
+    auto arg  = args[1];
+
+    rt->verifyIsValidObject(arg, MethodArgCtx(0));
+    if (arg->instance == nullptr) {
+        rt->signalError("Only instance objects can be referenced weakly: " + arg->userRepr(rt),
+                        rt->getContext().sub_areas[1]);
+    }
+
+    auto ref         = icast(self->instance, WeakRefInstance);
+    ref->target      = arg->instance;
+    ref->target_type = arg->type;
+    rt->getGC()->writeBarrier(self->instance);
+    return self;
+}
+
+static Object *weakrefGetMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    auto ref = icast(self->instance, WeakRefInstance);
+    if (ref->target == nullptr) {
+        return rt->protectedNothing();
+    }
+    return new (rt) Object(true, ref->target, ref->target_type, rt);
+}
+
+static Object *weakrefAliveMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    return rt->protectedBoolean(icast(self->instance, WeakRefInstance)->target != nullptr);
+}
+
+static Object *weakrefClearMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    auto ref         = icast(self->instance, WeakRefInstance);
+    ref->target      = nullptr;
+    ref->target_type = nullptr;
+    return self;
+}
+
+static Object *weakref_mm__repr__(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    ProfilerCAPTURE();
+    rt->verifyExactArgsAmountMethod(args, 0);
+    auto self = args[0];
+
+    if (!execution_result_matters) {
+        return self;
+    }
+
+    if (rt->isTypeObject(self, nullptr)) {
+        return makeStringInstanceObject("WeakRef", rt);
+    }
+
+    return makeStringInstanceObject(self->instance->userRepr(rt), rt);
+}
+
+void installWeakRefMethods(Type *type, Runtime *rt) {
+    ProfilerCAPTURE();
+    type->addMethod(MagicMethods::mm__repr__(rt), Builtin::makeFunctionInstanceObject(true, weakref_mm__repr__, nullptr, rt));
+    type->addMethod(MagicMethods::mm__string__(rt), Builtin::makeFunctionInstanceObject(true, weakref_mm__repr__, nullptr, rt));
+
+    type->addMethod(rt->nmgr->getId("set"), makeFunctionInstanceObject(true, weakrefSetMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("get"), makeFunctionInstanceObject(true, weakrefGetMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("alive"), makeFunctionInstanceObject(true, weakrefAliveMethod, nullptr, rt));
+    type->addMethod(rt->nmgr->getId("clear"), makeFunctionInstanceObject(true, weakrefClearMethod, nullptr, rt));
+}
+
+WeakRefType::WeakRefType(Runtime *rt)
+    : Type(rt) {
+    ProfilerCAPTURE();
+}
+
+Object *WeakRefType::create(Runtime *rt) {
+    ProfilerCAPTURE();
+    Instance *ins = new WeakRefInstance(rt);
+    Object   *obj = new (rt) Object(true, ins, this, rt);
+    return obj;
+}
+
+Object *WeakRefType::copy(Object *obj, Runtime *rt) {
+    ProfilerCAPTURE();
+    rt->verifyIsOfType(obj, rt->builtin_types.weakref);
+    if (obj->instance == nullptr) {
+        return new (rt) Object(false, nullptr, this, rt);
+    }
+    auto ins = obj->instance->copy(rt);
+    auto res = new (rt) Object(true, ins, this, rt);
+    return res;
+}
+
+std::string WeakRefType::userRepr(Runtime *rt) {
+    ProfilerCAPTURE();
+    if (this == nullptr) {
+        return "WeakRefType(nullptr)";
+    }
+    return "WeakRefType";
+}
+}    // namespace Cotton::Builtin
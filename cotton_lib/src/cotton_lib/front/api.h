@@ -20,4 +20,6 @@
  */
 #pragma once
 #include "lexer.h"
+#include "optimizer.h"
 #include "parser.h"
+#include "resolver.h"
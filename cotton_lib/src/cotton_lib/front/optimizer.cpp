@@ -0,0 +1,248 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "optimizer.h"
+#include "../back/nameid.h"
+#include "../back/value.h"
+#include <cmath>
+#include <cstdio>
+
+namespace Cotton {
+Optimizer::Optimizer(NamesManager *nmgr) {
+    this->nmgr   = nmgr;
+    this->folded = 0;
+    this->pruned = 0;
+}
+
+StmtNode *Optimizer::optimize(StmtNode *node) {
+    return this->optimizeStmt(node);
+}
+
+void Optimizer::optimizeFunction(FuncDefNode *node) {
+    node->body = this->optimizeStmt(node->body);
+}
+
+void Optimizer::optimizeBlock(BlockStmtNode *node) {
+    std::vector<StmtNode *> list;
+    for (size_t i = 0; i < node->list.size(); i++) {
+        auto stmt = this->optimizeStmt(node->list[i]);
+        // an unscoped block has no frame of its own, so its statements can live in the parent. An empty one at the
+        // end is kept, since it decides the result of the parent
+        if (stmt != nullptr && stmt->id == StmtNode::BLOCK && stmt->block_stmt->is_unscoped
+            && (!stmt->block_stmt->list.empty() || i + 1 < node->list.size()))
+        {
+            list.insert(list.end(), stmt->block_stmt->list.begin(), stmt->block_stmt->list.end());
+            stmt->block_stmt->list.clear();
+            delete stmt;
+            continue;
+        }
+        list.push_back(stmt);
+    }
+    node->list = list;
+}
+
+StmtNode *Optimizer::optimizeStmt(StmtNode *node) {
+    if (node == nullptr) {
+        return nullptr;
+    }
+    Value cond;
+    switch (node->id) {
+    case StmtNode::WHILE : {
+        auto while_stmt  = node->while_stmt;
+        while_stmt->cond = this->optimizeExpr(while_stmt->cond);
+        while_stmt->body = this->optimizeStmt(while_stmt->body);
+        if (this->getLiteral(while_stmt->cond, cond) && cond.kind == Value::BOOLEAN && !cond.boolean) {
+            auto res = this->makeEmpty(node->text_area);
+            delete node;
+            this->pruned++;
+            return res;
+        }
+        return node;
+    }
+    case StmtNode::FOR : {
+        auto for_stmt  = node->for_stmt;
+        for_stmt->init = this->optimizeExpr(for_stmt->init);
+        for_stmt->cond = this->optimizeExpr(for_stmt->cond);
+        for_stmt->step = this->optimizeExpr(for_stmt->step);
+        for_stmt->body = this->optimizeStmt(for_stmt->body);
+        return node;
+    }
+    case StmtNode::IF : {
+        auto if_stmt       = node->if_stmt;
+        if_stmt->cond      = this->optimizeExpr(if_stmt->cond);
+        if_stmt->body      = this->optimizeStmt(if_stmt->body);
+        if_stmt->else_body = this->optimizeStmt(if_stmt->else_body);
+        if (!this->getLiteral(if_stmt->cond, cond) || cond.kind != Value::BOOLEAN) {
+            return node;
+        }
+        // the branch is executed without a frame of its own, so it can take the place of the whole statement
+        StmtNode *res;
+        if (cond.boolean) {
+            res           = if_stmt->body;
+            if_stmt->body = nullptr;
+        }
+        else {
+            res                = if_stmt->else_body;
+            if_stmt->else_body = nullptr;
+        }
+        if (res == nullptr) {
+            res = this->makeEmpty(node->text_area);
+        }
+        delete node;
+        this->pruned++;
+        return res;
+    }
+    case StmtNode::RETURN : {
+        node->return_stmt->value = this->optimizeExpr(node->return_stmt->value);
+        return node;
+    }
+    case StmtNode::BLOCK : {
+        this->optimizeBlock(node->block_stmt);
+        return node;
+    }
+    case StmtNode::EXPR : {
+        node->expr = this->optimizeExpr(node->expr);
+        return node;
+    }
+    default : return node;
+    }
+}
+
+ExprNode *Optimizer::optimizeExpr(ExprNode *node) {
+    if (node == nullptr) {
+        return nullptr;
+    }
+    switch (node->id) {
+    case ExprNode::FUNCTION_DEFINITION : {
+        this->optimizeFunction(node->func_def);
+        return node;
+    }
+    case ExprNode::TYPE_DEFINITION : {
+        for (auto method : node->type_def->methods) {
+            this->optimizeFunction(method);
+        }
+        return node;
+    }
+    case ExprNode::OPERATOR : {
+        auto op   = node->op;
+        op->first = this->optimizeExpr(op->first);
+        // selectors are field and method names, not expressions
+        if (op->id != OperatorNode::DOT) {
+            op->second = this->optimizeExpr(op->second);
+        }
+        return this->fold(node);
+    }
+    case ExprNode::PARENTHESES_EXPRESSION : {
+        node->par_expr->expr = this->optimizeExpr(node->par_expr->expr);
+        return node;
+    }
+    default : return node;
+    }
+}
+
+ExprNode *Optimizer::fold(ExprNode *node) {
+    auto  op = node->op;
+    Value self, arg, res;
+    if (!this->getLiteral(op->first, self)) {
+        return node;
+    }
+    // runImmediateOperator refuses the operators that could fail or need an object, those are left as they are
+    if (op->second == nullptr) {
+        if (!runImmediateOperator(op->id, self, res)) {
+            return node;
+        }
+    }
+    else if (!this->getLiteral(op->second, arg) || !runImmediateOperator(op->id, self, arg, res)) {
+        return node;
+    }
+    auto literal = this->makeLiteral(res, node->text_area);
+    if (literal == nullptr) {
+        return node;
+    }
+    delete node;
+    this->folded++;
+    return literal;
+}
+
+bool Optimizer::getLiteral(ExprNode *node, Value &value) {
+    while (node != nullptr && node->id == ExprNode::PARENTHESES_EXPRESSION) {
+        node = node->par_expr->expr;
+    }
+    if (node == nullptr || node->id != ExprNode::ATOM) {
+        return false;
+    }
+    switch (node->atom->id) {
+    case AtomNode::INTEGER : value = Value::makeInteger(node->atom->int_value); return true;
+    case AtomNode::REAL : value = Value::makeReal(node->atom->real_value); return true;
+    case AtomNode::BOOLEAN : value = Value::makeBoolean(node->atom->bool_value); return true;
+    default : return false;
+    }
+}
+
+ExprNode *Optimizer::makeLiteral(const Value &value, TextArea text_area) {
+    auto filename = text_area.filename != nullptr ? *text_area.filename : std::string();
+    auto token    = new Token("", text_area.first_char, text_area.last_char, filename);
+
+    // the text of a literal is the key its object is cached under, so it has to identify the value and the type
+    switch (value.kind) {
+    case Value::INTEGER : {
+        token->id        = Token::INT_LIT;
+        token->int_value = value.integer;
+        token->data      = std::to_string(value.integer);
+        break;
+    }
+    case Value::REAL : {
+        if (!std::isfinite(value.real)) {
+            delete token;
+            return nullptr;
+        }
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.17g", value.real);
+        token->id         = Token::REAL_LIT;
+        token->real_value = value.real;
+        token->data       = buf;
+        if (token->data.find_first_of(".e") == std::string::npos) {
+            token->data += ".0";
+        }
+        break;
+    }
+    case Value::BOOLEAN : {
+        token->id         = Token::BOOLEAN_LIT;
+        token->bool_value = value.boolean;
+        token->data       = value.boolean ? "true" : "false";
+        break;
+    }
+    default : {
+        delete token;
+        return nullptr;
+    }
+    }
+    token->nameid = this->nmgr->getId(token->data);
+
+    auto atom        = new AtomNode(token, text_area);
+    atom->owns_token = true;
+    return new ExprNode(atom, text_area);
+}
+
+StmtNode *Optimizer::makeEmpty(TextArea text_area) {
+    return new StmtNode(new BlockStmtNode(true, {}, text_area), text_area);
+}
+}    // namespace Cotton
@@ -0,0 +1,72 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "parser.h"
+#include <cstdint>
+
+namespace Cotton {
+class NamesManager;
+class Value;
+
+/**
+ * @brief Rewrites a parsed program before it gets resolved and executed.
+ *
+ * Operators whose operands are Integer, Real or Boolean literals are folded into a single literal, `if` and `while`
+ * statements with a literal condition lose the branches that can never run, and unscoped blocks nested in other
+ * blocks are spliced into their parent. Only operators that can't fail are folded, so the program behaves the same
+ * way, errors included.
+ */
+class Optimizer {
+private:
+    NamesManager *nmgr;
+
+    ExprNode *optimizeExpr(ExprNode *node);
+    StmtNode *optimizeStmt(StmtNode *node);
+    void      optimizeFunction(FuncDefNode *node);
+    void      optimizeBlock(BlockStmtNode *node);
+
+    ExprNode *fold(ExprNode *node);
+    bool      getLiteral(ExprNode *node, Value &value);
+    ExprNode *makeLiteral(const Value &value, TextArea text_area);
+    StmtNode *makeEmpty(TextArea text_area);
+
+public:
+    /// @brief How many operators got folded and how many statements got removed.
+    int64_t folded, pruned;
+
+    /**
+     * @brief Construct a new Optimizer object
+     *
+     * @param nmgr The names manager the tokens of the program were registered in. Must be valid.
+     */
+    Optimizer(NamesManager *nmgr);
+
+    /**
+     * @brief Optimizes the given program. Tokens must have their nameids set. Must run before the resolver.
+     *
+     * @param node The program. May be nullptr.
+     * @return The optimized program. The nodes that get replaced are deleted.
+     */
+    StmtNode *optimize(StmtNode *node);
+};
+}    // namespace Cotton
@@ -22,6 +22,7 @@
 #include "parser.h"
 #include "../errors.h"
 #include "lexer.h"
+#include "resolver.h"
 
 namespace Cotton {
 
@@ -158,10 +159,12 @@ void ExprNode::print(int indent, int step) {
 FuncDefNode::~FuncDefNode() {
     delete this->params;
     delete this->body;
+    delete this->layout;
 
     this->name   = nullptr;
     this->params = nullptr;
     this->body   = nullptr;
+    this->layout = nullptr;
 }
 
 FuncDefNode::FuncDefNode(Token *name, IdentListNode *params, StmtNode *body, TextArea text_area) {
@@ -169,6 +172,7 @@ FuncDefNode::FuncDefNode(Token *name, IdentListNode *params, StmtNode *body, Tex
     this->name      = name;
     this->params    = params;
     this->body      = body;
+    this->layout    = nullptr;
 }
 
 void FuncDefNode::print(int indent, int step) {
@@ -264,7 +268,8 @@ OperatorNode::OperatorNode(OperatorId id, ExprNode *first, ExprNode *second, Tok
     this->id        = id;
     this->first     = first;
     this->second    = second;
-    this->op        = op;
+    this->op          = op;
+    this->cache_index = -1;
 }
 
 void OperatorNode::print(int indent, int step) {
@@ -285,14 +290,22 @@ void OperatorNode::print(int indent, int step) {
 }
 
 AtomNode::~AtomNode() {
+    if (this->owns_token) {
+        delete this->token;
+    }
     this->ident = nullptr;
     this->token = nullptr;
 }
 
 AtomNode::AtomNode(Token *token, TextArea text_area) {
-    this->text_area = text_area;
-    this->lit_obj   = nullptr;
-    this->token     = token;
+    this->text_area  = text_area;
+    this->lit_obj    = nullptr;
+    this->token      = token;
+    this->owns_token = false;
+
+    this->resolved_depth  = -1;
+    this->resolved_slot   = -1;
+    this->resolved_layout = nullptr;
     switch (token->id) {
     case Token::BOOLEAN_LIT : {
         this->id         = BOOLEAN;
@@ -546,15 +559,18 @@ void StmtNode::print(int indent, int step) {
 WhileStmtNode::~WhileStmtNode() {
     delete this->cond;
     delete this->body;
+    delete this->layout;
 
-    this->cond = nullptr;
-    this->body = nullptr;
+    this->cond   = nullptr;
+    this->body   = nullptr;
+    this->layout = nullptr;
 }
 
 WhileStmtNode::WhileStmtNode(ExprNode *cond, StmtNode *body, TextArea text_area) {
     this->text_area = text_area;
     this->cond      = cond;
     this->body      = body;
+    this->layout    = nullptr;
 }
 
 void WhileStmtNode::print(int indent, int step) {
@@ -579,19 +595,25 @@ ForStmtNode::~ForStmtNode() {
     delete this->cond;
     delete this->step;
     delete this->body;
+    delete this->outer_layout;
+    delete this->layout;
 
-    this->init = nullptr;
-    this->cond = nullptr;
-    this->step = nullptr;
-    this->body = nullptr;
+    this->init         = nullptr;
+    this->cond         = nullptr;
+    this->step         = nullptr;
+    this->body         = nullptr;
+    this->outer_layout = nullptr;
+    this->layout       = nullptr;
 }
 
 ForStmtNode::ForStmtNode(ExprNode *init, ExprNode *cond, ExprNode *step, StmtNode *body, TextArea text_area) {
-    this->text_area = text_area;
-    this->init      = init;
-    this->cond      = cond;
-    this->step      = step;
-    this->body      = body;
+    this->text_area    = text_area;
+    this->init         = init;
+    this->cond         = cond;
+    this->step         = step;
+    this->body         = body;
+    this->outer_layout = nullptr;
+    this->layout       = nullptr;
 }
 
 void ForStmtNode::print(int indent, int step) {
@@ -664,8 +686,9 @@ ReturnStmtNode::~ReturnStmtNode() {
 }
 
 ReturnStmtNode::ReturnStmtNode(ExprNode *value, TextArea text_area) {
-    this->text_area = text_area;
-    this->value     = value;
+    this->text_area    = text_area;
+    this->value        = value;
+    this->is_tail_call = false;
 }
 
 void ReturnStmtNode::print(int indent, int step) {
@@ -685,12 +708,15 @@ BlockStmtNode::~BlockStmtNode() {
     }
 
     this->list.clear();
+    delete this->layout;
+    this->layout = nullptr;
 }
 
 BlockStmtNode::BlockStmtNode(bool is_unscoped, const std::vector<StmtNode *> list, TextArea text_area) {
     this->text_area   = text_area;
     this->is_unscoped = is_unscoped;
     this->list        = list;
+    this->layout      = nullptr;
 }
 
 void BlockStmtNode::print(int indent, int step) {
@@ -43,6 +43,7 @@ class ForStmtNode;
 class IfStmtNode;
 class ReturnStmtNode;
 class BlockStmtNode;
+class ScopeLayout;
 
 class TextArea {
 public:
@@ -86,6 +87,7 @@ public:
     Token         *name;      // nullptr means not present
     IdentListNode *params;    // nullptr means not present
     StmtNode      *body;
+    ScopeLayout   *layout;    // layout of the function call frame, set by the resolver
 
     FuncDefNode() = delete;
     ~FuncDefNode();
@@ -158,8 +160,9 @@ public:
         TOTAL_OPERATORS          // not a method
     } id;
 
-    ExprNode *first, *second;    // if second is nullptr then it's not present, and the operator is unary
-    Token    *op;
+    ExprNode    *first, *second;    // if second is nullptr then it's not present, and the operator is unary
+    Token       *op;
+    int64_t      cache_index;       // selector cache of DOT operators given out by the runtime on first use, or -1
 
     OperatorNode() = delete;
     ~OperatorNode();
@@ -186,6 +189,12 @@ public:
 
     Object *lit_obj;
     Token  *token;
+    bool    owns_token;    // the token was made by the optimizer for a folded literal and is deleted with the node
+
+    // set by the resolver for identifiers. resolved_depth == -1 means the variable must be looked up by name
+    int64_t      resolved_depth;
+    int64_t      resolved_slot;
+    ScopeLayout *resolved_layout;
 
     AtomNode() = delete;
     ~AtomNode();
@@ -253,8 +262,9 @@ public:
 class WhileStmtNode {
 public:
     TextArea  text_area;
-    ExprNode *cond;
-    StmtNode *body;
+    ExprNode    *cond;
+    StmtNode    *body;
+    ScopeLayout *layout;    // layout of the iteration frame, set by the resolver
 
     WhileStmtNode() = delete;
     ~WhileStmtNode();
@@ -268,8 +278,10 @@ class ForStmtNode {
 public:
     TextArea text_area;
 
-    ExprNode *init, *cond, *step;
-    StmtNode *body;
+    ExprNode    *init, *cond, *step;
+    StmtNode    *body;
+    ScopeLayout *outer_layout;    // layout of the frame holding init and step, set by the resolver
+    ScopeLayout *layout;          // layout of the iteration frame, set by the resolver
 
     ForStmtNode() = delete;
     ~ForStmtNode();
@@ -300,6 +312,7 @@ public:
     TextArea text_area;
 
     ExprNode *value;
+    bool      is_tail_call;    // value is a call made right before leaving a function, set by the resolver
 
     ReturnStmtNode() = delete;
     ~ReturnStmtNode();
@@ -315,6 +328,7 @@ public:
 
     bool                    is_unscoped;
     std::vector<StmtNode *> list;
+    ScopeLayout            *layout;    // layout of the block frame, set by the resolver
 
     BlockStmtNode() = delete;
     ~BlockStmtNode();
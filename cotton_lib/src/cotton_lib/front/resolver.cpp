@@ -0,0 +1,248 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include "resolver.h"
+
+namespace Cotton {
+ScopeLayout::ScopeLayout() {
+    this->declares = false;
+}
+
+bool ScopeLayout::needsFrame(ScopeLayout *layout) {
+    return layout == nullptr || layout->declares;
+}
+
+int64_t ScopeLayout::find(int64_t nameid) {
+    auto it = this->slots.find(nameid);
+    if (it == this->slots.end()) {
+        return -1;
+    }
+    return it->second;
+}
+
+int64_t ScopeLayout::add(int64_t nameid) {
+    auto slot = this->find(nameid);
+    if (slot != -1) {
+        return slot;
+    }
+    slot                 = this->names.size();
+    this->slots[nameid] = slot;
+    this->names.push_back(nameid);
+    return slot;
+}
+
+int64_t ScopeLayout::size() {
+    return this->names.size();
+}
+
+Resolver::Resolver() {
+    this->declaring   = false;
+    this->in_function = false;
+}
+
+void Resolver::resolve(StmtNode *node) {
+    // layouts are completed before any identifier gets resolved, so that uses which precede the declaration in
+    // the source still get their slot
+    this->frames.clear();
+    this->declaring = true;
+    this->resolveStmt(node);
+    this->declaring = false;
+    this->resolveStmt(node);
+}
+
+void Resolver::pushFrame(ScopeLayout *&layout) {
+    if (layout == nullptr) {
+        layout = new ScopeLayout();
+    }
+    this->frames.push_back(layout);
+}
+
+void Resolver::popFrame() {
+    this->frames.pop_back();
+}
+
+void Resolver::declare(int64_t nameid) {
+    if (!this->declaring || this->frames.empty()) {
+        return;
+    }
+    this->frames.back()->declares = true;
+    // a variable that an outer frame can hold is assigned to there, so it doesn't get a slot of its own
+    for (auto layout : this->frames) {
+        if (layout->find(nameid) != -1) {
+            return;
+        }
+    }
+    this->frames.back()->add(nameid);
+}
+
+void Resolver::resolveFunction(FuncDefNode *node) {
+    auto frames       = this->frames;
+    auto in_function  = this->in_function;
+    this->in_function = true;
+    this->frames.clear();
+
+    this->pushFrame(node->layout);
+    if (node->params != nullptr) {
+        for (auto token : node->params->list) {
+            node->layout->add(token->nameid);
+        }
+    }
+    this->resolveStmt(node->body);
+    this->popFrame();
+
+    this->frames      = frames;
+    this->in_function = in_function;
+}
+
+void Resolver::resolveStmt(StmtNode *node) {
+    if (node == nullptr) {
+        return;
+    }
+    switch (node->id) {
+    case StmtNode::WHILE : {
+        auto while_stmt = node->while_stmt;
+        this->pushFrame(while_stmt->layout);
+        this->resolveExpr(while_stmt->cond);
+        this->resolveStmt(while_stmt->body);
+        this->popFrame();
+        break;
+    }
+    case StmtNode::FOR : {
+        auto for_stmt = node->for_stmt;
+        this->pushFrame(for_stmt->outer_layout);
+        this->resolveExpr(for_stmt->init);
+        this->resolveExpr(for_stmt->step);
+        this->pushFrame(for_stmt->layout);
+        this->resolveExpr(for_stmt->cond);
+        this->resolveStmt(for_stmt->body);
+        this->popFrame();
+        this->popFrame();
+        break;
+    }
+    case StmtNode::IF : {
+        this->resolveExpr(node->if_stmt->cond);
+        this->resolveStmt(node->if_stmt->body);
+        this->resolveStmt(node->if_stmt->else_body);
+        break;
+    }
+    case StmtNode::RETURN : {
+        auto value = node->return_stmt->value;
+        bool call  = value != nullptr && value->id == ExprNode::OPERATOR && value->op->id == OperatorNode::CALL;
+        // nothing is left to do in the function once the call returns, so its frame can be given to the callee
+        node->return_stmt->is_tail_call = this->in_function && call;
+        this->resolveExpr(value);
+        break;
+    }
+    case StmtNode::BLOCK : {
+        auto block = node->block_stmt;
+        if (!block->is_unscoped) {
+            this->pushFrame(block->layout);
+        }
+        for (auto stmt : block->list) {
+            this->resolveStmt(stmt);
+        }
+        if (!block->is_unscoped) {
+            this->popFrame();
+        }
+        break;
+    }
+    case StmtNode::EXPR : {
+        this->resolveExpr(node->expr);
+        break;
+    }
+    default : break;
+    }
+}
+
+void Resolver::resolveExpr(ExprNode *node) {
+    if (node == nullptr) {
+        return;
+    }
+    switch (node->id) {
+    case ExprNode::FUNCTION_DEFINITION : {
+        this->resolveFunction(node->func_def);
+        break;
+    }
+    case ExprNode::TYPE_DEFINITION : {
+        for (auto method : node->type_def->methods) {
+            this->resolveFunction(method);
+        }
+        break;
+    }
+    case ExprNode::OPERATOR : {
+        auto op = node->op;
+        if (op->id == OperatorNode::ASSIGN && op->first != nullptr && op->first->id == ExprNode::ATOM
+            && op->first->atom->id == AtomNode::IDENTIFIER)
+        {
+            this->declare(op->first->atom->ident->nameid);
+        }
+        // hide() removes variables from the frame it is called from, so that frame must not be elided
+        if (op->id == OperatorNode::CALL && this->declaring && !this->frames.empty() && op->first != nullptr
+            && op->first->id == ExprNode::ATOM && op->first->atom->id == AtomNode::IDENTIFIER
+            && op->first->atom->ident->data == "hide")
+        {
+            this->frames.back()->declares = true;
+        }
+        this->resolveExpr(op->first);
+        // selectors are field and method names, not variables
+        if (op->id != OperatorNode::DOT) {
+            this->resolveExpr(op->second);
+        }
+        break;
+    }
+    case ExprNode::ATOM : {
+        this->resolveAtom(node->atom);
+        break;
+    }
+    case ExprNode::PARENTHESES_EXPRESSION : {
+        this->resolveExpr(node->par_expr->expr);
+        break;
+    }
+    default : break;
+    }
+}
+
+void Resolver::resolveAtom(AtomNode *node) {
+    if (this->declaring || node->id != AtomNode::IDENTIFIER) {
+        return;
+    }
+    node->resolved_depth  = -1;
+    node->resolved_slot   = -1;
+    node->resolved_layout = nullptr;
+
+    int64_t depth = 0;
+    for (auto it = this->frames.rbegin(); it != this->frames.rend(); it++) {
+        // elided frames don't exist at runtime, so they don't count towards the depth
+        if (!ScopeLayout::needsFrame(*it)) {
+            continue;
+        }
+        auto slot = (*it)->find(node->token->nameid);
+        if (slot != -1) {
+            node->resolved_depth  = depth;
+            node->resolved_slot   = slot;
+            node->resolved_layout = *it;
+            return;
+        }
+        depth++;
+    }
+}
+}    // namespace Cotton
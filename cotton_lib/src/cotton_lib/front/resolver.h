@@ -0,0 +1,105 @@
+/*
+ Copyright (c) 2024 Ihor Lukianov (lis05)
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of
+ this software and associated documentation files (the "Software"), to deal in
+ the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ the Software, and to permit persons to whom the Software is furnished to do so,
+ subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include "../util.h"
+#include "parser.h"
+#include <cstdint>
+#include <vector>
+
+namespace Cotton {
+/// @brief Describes the variables that a scope frame keeps in its slots. Built by the resolver.
+class ScopeLayout {
+public:
+    std::vector<int64_t>         names;       // nameid of each slot
+    HashTable<int64_t, int64_t> slots;       // nameid -> slot
+    bool                         declares;    // whether anything may declare or hide a variable in the frame
+
+    ScopeLayout();
+
+    /**
+     * @brief Returns whether a frame with the given layout has to be created. A frame that never gets any variables
+     * is indistinguishable from its parent, so it is elided.
+     *
+     * @param layout The layout. May be nullptr, in which case nothing is known about the frame and it is created.
+     * @return `true` if the frame must be created.
+     */
+    static bool needsFrame(ScopeLayout *layout);
+
+    /**
+     * @brief Returns the slot of the variable with the given nameid.
+     *
+     * @param nameid Nameid of the variable.
+     * @return The slot, or -1 if the layout doesn't have such a variable.
+     */
+    int64_t find(int64_t nameid);
+
+    /**
+     * @brief Adds a slot for the variable with the given nameid, unless the layout already has one.
+     *
+     * @param nameid Nameid of the variable.
+     * @return The slot.
+     */
+    int64_t add(int64_t nameid);
+
+    /// @brief Returns the number of slots.
+    int64_t size();
+};
+
+/**
+ * @brief Assigns each variable that is declared in a function or a block a slot in its scope frame, and each
+ * identifier the (depth, slot) pair of the frame it is expected to be found in.
+ *
+ * The resolution never crosses function boundaries and never covers the master scope, so names that live there,
+ * as well as names that get added or removed at runtime (`hide`, `unlockscope`, `isinscope`) are still looked up
+ * by name. A resolved slot that happens to be empty at runtime falls back to the lookup by name as well.
+ *
+ * It also marks the `return` statements of functions whose value is a call, so that the call can be made as a tail
+ * call.
+ */
+class Resolver {
+private:
+    std::vector<ScopeLayout *> frames;       // frames of the current function, innermost last
+    bool                       declaring;      // first pass builds the layouts, second one resolves identifiers
+    bool                       in_function;    // whether a `return` leaves a function or the whole program
+
+    void pushFrame(ScopeLayout *&layout);
+    void popFrame();
+    void declare(int64_t nameid);
+
+    void resolveFunction(FuncDefNode *node);
+    void resolveStmt(StmtNode *node);
+    void resolveExpr(ExprNode *node);
+    void resolveAtom(AtomNode *node);
+
+public:
+    Resolver();
+
+    /**
+     * @brief Resolves all variables of the given program. Tokens must have their nameids set.
+     *
+     * @param node The program. May be nullptr.
+     */
+    void resolve(StmtNode *node);
+};
+}    // namespace Cotton
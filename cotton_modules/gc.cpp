@@ -1,34 +1,34 @@
 #include "../cotton_lib/src/cotton_lib/api.h"
 using namespace Cotton;
 
-static Object *enable(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *enable(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     rt->verifyExactArgsAmountMethod(args, 0);
 
     rt->getGC()->enable();
     return rt->protectedNothing();
 }
 
-static Object *disable(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *disable(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     rt->verifyExactArgsAmountMethod(args, 0);
 
     rt->getGC()->disable();
     return rt->protectedNothing();
 }
 
-static Object *status(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *status(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     rt->verifyExactArgsAmountMethod(args, 0);
 
     return rt->protectedBoolean(rt->getGC()->enabled);
 }
 
-static Object *ping(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *ping(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     rt->verifyExactArgsAmountMethod(args, 0);
 
     rt->getGC()->ping(rt);
     return rt->protectedNothing();
 }
 
-static Object *forceping(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *forceping(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     rt->verifyExactArgsAmountMethod(args, 0);
 
     auto status = rt->getGC()->enabled;
@@ -39,6 +39,135 @@ static Object *forceping(const std::vector<Object *> &args, Runtime *rt, bool ex
     return rt->protectedNothing();
 }
 
+static Object *collect(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    rt->verifyExactArgsAmountMethod(args, 0);
+
+    rt->getGC()->runCycle(rt);
+    return rt->protectedNothing();
+}
+
+static Object *pauses(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    rt->verifyExactArgsAmountMethod(args, 0);
+
+    std::vector<Object *> data;
+    for (auto count : rt->getGC()->pause_histogram) {
+        data.push_back(Builtin::makeIntegerInstanceObject(count, rt));
+    }
+    return Builtin::makeArrayInstanceObject(data, rt);
+}
+
+static Object *maxpause(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    rt->verifyExactArgsAmountMethod(args, 0);
+
+    return Builtin::makeIntegerInstanceObject(rt->getGC()->max_pause, rt);
+}
+
+static Object *slicebudget(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    rt->verifyExactArgsAmountMethod(args, 0);
+
+    return Builtin::makeIntegerInstanceObject(rt->getGC()->slice_budget, rt);
+}
+
+static Object *setslicebudget(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    rt->verifyExactArgsAmountMethod(args, 1);
+    rt->verifyIsInstanceObject(args[1], rt->builtin_types.integer, MethodArgCtx(0));
+
+    auto budget = Builtin::getIntegerValue(args[1], rt);
+    if (budget <= 0) {
+        rt->signalError("Slice budget must be positive: " + args[1]->userRepr(rt), rt->getContext().sub_areas[1]);
+    }
+    rt->getGC()->slice_budget = budget;
+    return rt->protectedNothing();
+}
+
+static Object *cycles(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    rt->verifyExactArgsAmountMethod(args, 0);
+
+    return Builtin::makeIntegerInstanceObject(rt->getGC()->cycle_stats.size(), rt);
+}
+
+static Object *cyclestats(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    rt->verifyExactArgsAmountMethod(args, 1);
+    rt->verifyIsInstanceObject(args[1], rt->builtin_types.integer, MethodArgCtx(0));
+
+    auto &all   = rt->getGC()->cycle_stats;
+    auto  index = Builtin::getIntegerValue(args[1], rt);
+    if (index < 0 || index >= (int64_t)all.size()) {
+        rt->signalError("Cycle index out of range: " + args[1]->userRepr(rt), rt->getContext().sub_areas[1]);
+    }
+    auto &stats = all[index];
+
+    std::vector<Object *> data;
+    data.push_back(Builtin::makeStringInstanceObject(GCCycleStats::getTriggerName(stats.trigger), rt));
+    data.push_back(Builtin::makeIntegerInstanceObject(stats.mark_time, rt));
+    data.push_back(Builtin::makeIntegerInstanceObject(stats.sweep_time, rt));
+    data.push_back(Builtin::makeIntegerInstanceObject(stats.freed_count, rt));
+    data.push_back(Builtin::makeIntegerInstanceObject(stats.freed_bytes, rt));
+    return Builtin::makeArrayInstanceObject(data, rt);
+}
+
+static Object *gctime(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    rt->verifyExactArgsAmountMethod(args, 0);
+
+    int64_t total = 0;
+    for (auto &stats : rt->getGC()->cycle_stats) {
+        total += stats.mark_time + stats.sweep_time;
+    }
+    return Builtin::makeIntegerInstanceObject(total, rt);
+}
+
+static Object *heapsize(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    rt->verifyExactArgsAmountMethod(args, 0);
+
+    // what the background sweep frees is only taken off once it finishes
+    rt->getGC()->finishSweep(rt);
+    return Builtin::makeIntegerInstanceObject(rt->getGC()->heap_bytes, rt);
+}
+
+static Object *setmaxheap(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    rt->verifyExactArgsAmountMethod(args, 1);
+    rt->verifyIsInstanceObject(args[1], rt->builtin_types.integer, MethodArgCtx(0));
+
+    auto bytes = Builtin::getIntegerValue(args[1], rt);
+    if (bytes < 0) {
+        rt->signalError("Heap limit must not be negative: " + args[1]->userRepr(rt), rt->getContext().sub_areas[1]);
+    }
+    rt->getGC()->max_heap_bytes = bytes;
+    return rt->protectedNothing();
+}
+
+static Object *livetypes(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    rt->verifyExactArgsAmountMethod(args, 0);
+
+    // the census is taken by a cycle of its own, unless the gc is disabled
+    auto gc     = rt->getGC();
+    auto census = gc->take_census;
+
+    gc->take_census = true;
+    gc->runCycle(rt);
+    gc->take_census = census;
+
+    std::vector<Object *> data;
+    for (auto &[name, count] : gc->live_types) {
+        std::vector<Object *> pair;
+        pair.push_back(Builtin::makeStringInstanceObject(name, rt));
+        pair.push_back(Builtin::makeIntegerInstanceObject(count, rt));
+        data.push_back(Builtin::makeArrayInstanceObject(pair, rt));
+    }
+    return Builtin::makeArrayInstanceObject(data, rt);
+}
+
+static Object *snapshot(ArgSpan args, Runtime *rt, bool execution_result_matters) {
+    rt->verifyExactArgsAmountMethod(args, 1);
+    rt->verifyIsInstanceObject(args[1], rt->builtin_types.string, MethodArgCtx(0));
+
+    auto path = Builtin::getStringData(args[1], rt);
+    if (!HeapSnapshot(rt).write(path, rt)) {
+        rt->signalError("Failed to write the heap snapshot to " + path, rt->getContext().sub_areas[1]);
+    }
+    return rt->protectedNothing();
+}
+
 extern "C" Object *library_load_point(Runtime *rt) {
     auto record = Builtin::makeRecordType(rt->nmgr->getId("GC"), rt);
     record->addMethod(rt->nmgr->getId("enable"), Builtin::makeFunctionInstanceObject(true, enable, nullptr, rt));
@@ -47,5 +176,22 @@ extern "C" Object *library_load_point(Runtime *rt) {
     record->addMethod(rt->nmgr->getId("ping"), Builtin::makeFunctionInstanceObject(true, ping, nullptr, rt));
     record->addMethod(rt->nmgr->getId("forceping"),
                       Builtin::makeFunctionInstanceObject(true, forceping, nullptr, rt));
+    record->addMethod(rt->nmgr->getId("collect"), Builtin::makeFunctionInstanceObject(true, collect, nullptr, rt));
+    record->addMethod(rt->nmgr->getId("pauses"), Builtin::makeFunctionInstanceObject(true, pauses, nullptr, rt));
+    record->addMethod(rt->nmgr->getId("maxpause"), Builtin::makeFunctionInstanceObject(true, maxpause, nullptr, rt));
+    record->addMethod(rt->nmgr->getId("slicebudget"),
+                      Builtin::makeFunctionInstanceObject(true, slicebudget, nullptr, rt));
+    record->addMethod(rt->nmgr->getId("setslicebudget"),
+                      Builtin::makeFunctionInstanceObject(true, setslicebudget, nullptr, rt));
+    record->addMethod(rt->nmgr->getId("cycles"), Builtin::makeFunctionInstanceObject(true, cycles, nullptr, rt));
+    record->addMethod(rt->nmgr->getId("cyclestats"),
+                      Builtin::makeFunctionInstanceObject(true, cyclestats, nullptr, rt));
+    record->addMethod(rt->nmgr->getId("gctime"), Builtin::makeFunctionInstanceObject(true, gctime, nullptr, rt));
+    record->addMethod(rt->nmgr->getId("livetypes"),
+                      Builtin::makeFunctionInstanceObject(true, livetypes, nullptr, rt));
+    record->addMethod(rt->nmgr->getId("snapshot"), Builtin::makeFunctionInstanceObject(true, snapshot, nullptr, rt));
+    record->addMethod(rt->nmgr->getId("heapsize"), Builtin::makeFunctionInstanceObject(true, heapsize, nullptr, rt));
+    record->addMethod(rt->nmgr->getId("setmaxheap"),
+                      Builtin::makeFunctionInstanceObject(true, setmaxheap, nullptr, rt));
     return rt->make(record, Runtime::INSTANCE_OBJECT);
 }
@@ -3,7 +3,7 @@
 #include <filesystem>
 using namespace Cotton;
 
-static Object *recursive(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *recursive(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     rt->verifyExactArgsAmountMethod(args, 1);
     auto                  self = args[0];
     auto                  arg  = args[1];
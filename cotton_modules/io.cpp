@@ -63,7 +63,7 @@ public:
     Object *create(Runtime *rt) {
         ProfilerCAPTURE();
         Instance *ins = new FileInstance(rt);
-        Object   *obj = new Object(true, ins, this, rt);
+        Object   *obj = new (rt) Object(true, ins, this, rt);
         return obj;
     }
 
@@ -75,17 +75,17 @@ public:
         ProfilerCAPTURE();
         rt->verifyIsValidObject(obj);
         if (obj->instance == nullptr) {
-            return new Object(false, nullptr, this, rt);
+            return new (rt) Object(false, nullptr, this, rt);
         }
         auto ins = obj->instance->copy(rt);
-        auto res = new Object(true, ins, this, rt);
+        auto res = new (rt) Object(true, ins, this, rt);
         return res;
     }
 };
 
 static Type *file_type;
 
-static Object *fileCloseMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *fileCloseMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
 
@@ -95,7 +95,7 @@ static Object *fileCloseMethod(const std::vector<Object *> &args, Runtime *rt, b
     return self;
 }
 
-static Object *fileWriteMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *fileWriteMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     rt->verifyExactArgsAmountMethod(args, 1);
     auto self = args[0];
     auto arg  = args[1];
@@ -119,7 +119,7 @@ static Object *fileWriteMethod(const std::vector<Object *> &args, Runtime *rt, b
     return self;
 }
 
-static Object *fileReadMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *fileReadMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
 
@@ -151,7 +151,7 @@ static Object *fileReadMethod(const std::vector<Object *> &args, Runtime *rt, bo
     return Builtin::makeStringInstanceObject(res, rt);
 }
 
-static Object *fileErrorMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *fileErrorMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
 
@@ -159,7 +159,7 @@ static Object *fileErrorMethod(const std::vector<Object *> &args, Runtime *rt, b
     return rt->protectedBoolean(file->error);
 }
 
-static Object *fileErrormessageMethod(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *fileErrormessageMethod(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     rt->verifyExactArgsAmountMethod(args, 0);
     auto self = args[0];
 
@@ -167,7 +167,7 @@ static Object *fileErrormessageMethod(const std::vector<Object *> &args, Runtime
     return Builtin::makeStringInstanceObject(file->error_message, rt);
 }
 
-static Object *module_open(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *module_open(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     rt->verifyExactArgsAmountMethod(args, 2);
     auto arg1 = args[1];
     auto arg2 = args[2];
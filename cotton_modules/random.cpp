@@ -3,7 +3,7 @@
 #include <random>
 using namespace Cotton;
 
-static Object *randint64(const std::vector<Object *> &args, Runtime *rt, bool execution_result_matters) {
+static Object *randint64(ArgSpan args, Runtime *rt, bool execution_result_matters) {
     rt->verifyExactArgsAmountMethod(args, 2);
     auto low = args[1];
     auto high = args[2];
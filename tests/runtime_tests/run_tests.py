@@ -1,12 +1,23 @@
 #!/bin/python3
 
 import glob
+import re
 import subprocess
+import sys
 
 tests = [f for f in glob.glob("**", recursive=True) if f.endswith(".ctn")]
 succeeded = 0
 failed = 0
 
+# returns a description of the first difference between the words, or None if they are the same
+def mismatch(produced, expected):
+    if len(expected) != len(produced):
+        return "produced %s words, expected %s" % (len(produced), len(expected))
+    for i in range(len(expected)):
+        if expected[i] != produced[i]:
+            return "words mismatch at position %s: produced %s, expected %s" % (i, produced[i], expected[i])
+    return None
+
 for file in tests:
     fd = open(file, "r")
     src = fd.read()
@@ -26,8 +37,28 @@ for file in tests:
     except ValueError:
         pass
 
-    proc = subprocess.run(["/home/lis05/Projects/Cotton/build/cotton_int/cotton_int", file], capture_output=True)
-    if proc.returncode != 0:
+    # tests that end with an error list the words of the expected error output, colors aside
+    expected_error = None
+
+    try:
+        error_first = words.index("BEGIN_MATCH_ERROR_WORDS")
+        error_last = words.index("END_MATCH_ERROR_WORDS")
+        expected_error = words[error_first + 1: error_last]
+    except ValueError:
+        pass
+
+    proc = subprocess.run(["/home/lis05/Projects/Cotton/build/cotton_int/cotton_int", *sys.argv[1:], file], capture_output=True)
+    if expected_error is not None:
+        if proc.returncode == 0:
+            print(f"❌ {desc} - FAILED: expected an error")
+            failed = failed + 1
+            continue
+        error = mismatch(re.sub(r"\x1b\[[0-9;]*m", "", proc.stderr.decode()).split(), expected_error)
+        if error is not None:
+            print(f"❌ {desc} - FAILED: error output {error}")
+            failed = failed + 1
+            continue
+    elif proc.returncode != 0:
         print(f"❌ {desc} - FAILED: exit code {proc.returncode}\nErrors:")
         print(proc.stderr.decode())
         failed = failed + 1
@@ -35,19 +66,11 @@ for file in tests:
 
     proc_output = proc.stdout.decode().split()
 
-    if len(expected_output) != len(proc_output):
-        print(f"❌ {desc} - FAILED: produced %s words, expected %s" % (len(proc_output), len(expected_output)))
+    error = mismatch(proc_output, expected_output)
+    if error is not None:
+        print(f"❌ {desc} - FAILED: {error}")
         failed = failed + 1
         continue
-    flag = 0
-    for i in range(len(expected_output)):
-        if expected_output[i] != proc_output[i]:
-            print(f"❌ {desc} - FAILED: words mismatch at position %s: produced %s, expected %s" % (i, proc_output[i], expected_output[i]))
-            failed = failed + 1
-            flag = 1
-            break
-    if flag == 1: 
-        continue
     
     print(f"✅ {desc} - SUCCESS")
     succeeded = succeeded + 1
@@ -0,0 +1,59 @@
+#!/bin/python3
+
+# Prints what retains the most memory in a heap snapshot written by cotton_int --heap-snapshot-on-exit or by
+# snapshot() of the gc module.
+#
+#     python3 tools/heap_summary.py snapshot.json [number of retainers to print]
+
+import json
+import sys
+
+if len(sys.argv) < 2:
+    print("Usage: heap_summary.py SNAPSHOT [TOP]")
+    sys.exit(1)
+
+top = int(sys.argv[2]) if len(sys.argv) > 2 else 20
+
+with open(sys.argv[1], "r") as fd:
+    snapshot = json.load(fd)
+
+fields = {name: i for i, name in enumerate(snapshot["node_fields"])}
+nodes = snapshot["nodes"]
+KIND, NAME, SHALLOW, RETAINED, DOMINATOR = (fields[f] for f in
+                                            ["kind", "name", "shallow_size", "retained_size", "dominator"])
+
+
+def describe(i):
+    node = nodes[i]
+    if node[KIND] == "root":
+        return node[NAME]
+    return f"{node[NAME]} {node[KIND]} #{i}"
+
+
+def retainers(i):
+    # the chain of dominators up to the roots, closest first
+    chain = []
+    while nodes[i][DOMINATOR] != i and len(chain) < 5:
+        i = nodes[i][DOMINATOR]
+        chain.append(describe(i))
+    return " <- ".join(chain)
+
+
+print(f"{len(nodes) - 1} reachable nodes, {nodes[0][RETAINED]} bytes")
+
+print(f"\nTop {top} retainers:")
+print(f"{'retained':>12} {'shallow':>10}  node")
+order = sorted(range(1, len(nodes)), key=lambda i: nodes[i][RETAINED], reverse=True)
+for i in order[:top]:
+    print(f"{nodes[i][RETAINED]:>12} {nodes[i][SHALLOW]:>10}  {describe(i)}  <- {retainers(i)}")
+
+by_type = {}
+for node in nodes[1:]:
+    key = (node[NAME], node[KIND])
+    count, shallow = by_type.get(key, (0, 0))
+    by_type[key] = (count + 1, shallow + node[SHALLOW])
+
+print(f"\nTop {top} types by shallow size:")
+print(f"{'shallow':>12} {'count':>10}  type")
+for (name, kind), (count, shallow) in sorted(by_type.items(), key=lambda e: e[1][1], reverse=True)[:top]:
+    print(f"{shallow:>12} {count:>10}  {name} {kind}")